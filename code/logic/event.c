@@ -22,109 +22,3197 @@
  * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
  * -----------------------------------------------------------------------------
  */
+// Must be defined before any system header for syscall(), epoll and friends
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
 #include "fossil/sys/event.h"
+#include "fossil/sys/memory.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <time.h>
+#include <stdatomic.h>
+#include <limits.h>
+
+#if defined(_WIN32)
+#include <windows.h> // WaitOnAddress, link with Synchronization.lib
+#elif defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#define EVENT_REACTOR 1 // fd, timer and signal sources
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#define EVENT_CACHE_LINE 64
+#define EVENT_SINGLE_PRODUCER 1 // Mode bits, see fossil_sys_event_queue_mode_t
+#define EVENT_SINGLE_CONSUMER 2
+#define EVENT_BATCH_CHUNK 64 // Slots prepared on the stack per reservation in post_batch
+#define EVENT_WAKE_TOKEN UINT64_MAX // epoll data of the reactor's eventfd
+#define EVENT_WHEEL_TOKEN (UINT64_MAX - 1) // epoll data of the timer wheel's timerfd
+#define EVENT_WHEEL_LEVELS 5   // 256 one-millisecond slots, then four levels of 64: 2^32 ms in all
+#define EVENT_WHEEL_OVERDUE 512 // bucket of expired timeouts waiting for room in the ring
+#define EVENT_WHEEL_NIL UINT32_MAX
+#define EVENT_SCHEDULE_MAX 64 // longest weighted drain schedule (sum of the weights)
+#define EVENT_NAME_CHUNK 1024  // interned ids per name chunk
+#define EVENT_NAME_CHUNKS 4096 // at most 4M distinct ids
+#define EVENT_DISPATCH_INLINE 8 // subscribers copied on the stack per dispatch
+#define EVENT_STEAL_BATCH 32     // events a dispatcher worker takes from the queue at a time
+#define EVENT_SHARDS_PER_WORKER 4 // ordered dispatch: id shards per worker
+#define EVENT_STAT_STRIPES 16      // counter stripes per queue, picked by thread
+#define EVENT_SAMPLE_SHIFT 6       // log2 of FOSSIL_SYS_EVENT_LATENCY_SAMPLE
+#define EVENT_LATENCY_SUB_BITS 4   // 16 linear sub-buckets per power of two
+#define EVENT_LATENCY_MAX_EXP 40   // latencies of 2^40 ns (18 min) and beyond share the last bucket
+#define EVENT_LATENCY_BUCKETS ((EVENT_LATENCY_MAX_EXP - EVENT_LATENCY_SUB_BITS + 2) << EVENT_LATENCY_SUB_BITS)
+
+#if defined(_MSC_VER)
+#define EVENT_THREAD_LOCAL __declspec(thread)
+#else
+#define EVENT_THREAD_LOCAL _Thread_local
+#endif
 
-#define MAX_EVENTS 256
+#if defined(_WIN32)
+typedef SRWLOCK fossil_sys_event_lock_t;
+#define EVENT_LOCK_INITIALIZER SRWLOCK_INIT
+static void fossil_sys_event_lock_init(fossil_sys_event_lock_t *lock) { InitializeSRWLock(lock); }
+static void fossil_sys_event_lock_shared(fossil_sys_event_lock_t *lock) { AcquireSRWLockShared(lock); }
+static void fossil_sys_event_unlock_shared(fossil_sys_event_lock_t *lock) { ReleaseSRWLockShared(lock); }
+static void fossil_sys_event_lock(fossil_sys_event_lock_t *lock) { AcquireSRWLockExclusive(lock); }
+static void fossil_sys_event_unlock(fossil_sys_event_lock_t *lock) { ReleaseSRWLockExclusive(lock); }
+static void fossil_sys_event_lock_destroy(fossil_sys_event_lock_t *lock) { (void)lock; }
+#else
+typedef pthread_rwlock_t fossil_sys_event_lock_t;
+#define EVENT_LOCK_INITIALIZER PTHREAD_RWLOCK_INITIALIZER
+static void fossil_sys_event_lock_init(fossil_sys_event_lock_t *lock) { pthread_rwlock_init(lock, NULL); }
+static void fossil_sys_event_lock_shared(fossil_sys_event_lock_t *lock) { pthread_rwlock_rdlock(lock); }
+static void fossil_sys_event_unlock_shared(fossil_sys_event_lock_t *lock) { pthread_rwlock_unlock(lock); }
+static void fossil_sys_event_lock(fossil_sys_event_lock_t *lock) { pthread_rwlock_wrlock(lock); }
+static void fossil_sys_event_unlock(fossil_sys_event_lock_t *lock) { pthread_rwlock_unlock(lock); }
+static void fossil_sys_event_lock_destroy(fossil_sys_event_lock_t *lock) { pthread_rwlock_destroy(lock); }
+#endif
+
+_Static_assert((FOSSIL_SYS_EVENT_CAPACITY & (FOSSIL_SYS_EVENT_CAPACITY - 1)) == 0,
+               "FOSSIL_SYS_EVENT_CAPACITY must be a power of two");
 
 /* ------------------------------------------------------
- * Internal Event Queue
+ * Event Queue
+ *
+ * Bounded MPMC ring with a sequence number per cell
+ * (Vyukov). A producer may fill the cell at position pos
+ * once its sequence equals pos; a consumer may take it
+ * once the sequence equals pos + 1. Each side claims a
+ * position with one CAS, so producers and consumers never
+ * contend with each other, only among themselves. A side
+ * declared single-threaded by the queue mode skips the CAS.
+ *
+ * Cells store their sequence minus their index, which makes
+ * a zero-initialised ring a valid empty ring. Each cell is
+ * one cache line, and small payloads travel inside it.
+ *
+ * A queue has one ring per priority lane. Lanes other than
+ * NORMAL get their cells on first post, so a queue that only
+ * sees normal traffic pays for one ring. Consumers take the
+ * most urgent non-empty lane (strict) or follow a smooth
+ * weighted round-robin schedule over the lanes and fall back
+ * to strict order when the scheduled lane is empty
+ * (weighted); both are work-conserving.
+ *
+ * Consumers that find the queue empty park: they announce
+ * themselves in `waiters`, snapshot `epoch`, check the
+ * queue once more and sleep until `epoch` moves. A
+ * producer bumps `epoch` and wakes one sleeper only when
+ * `waiters` is non-zero, so posting to a queue nobody
+ * waits on costs a single load. Linux sleeps on a futex,
+ * Windows on WaitOnAddress and everything else on a
+ * condvar.
+ *
+ * Statistics stay off the shared cache lines: counters are
+ * striped by thread, and latency is only measured for cells
+ * whose index is a multiple of the sample period. Such a
+ * cell has a timestamp word after the ring, written before
+ * the cell is published and read before it is handed back,
+ * so the cell's own sequence orders both.
+ *
+ * A full lane is handled by the queue's backpressure
+ * policy. Blocked producers park like consumers do, on
+ * `space_epoch`, which consumers only touch on blocking
+ * queues. Spilled events wait on a locked list per lane;
+ * while a lane's list is non-empty new posts join it too,
+ * and consumers move the list into the ring before taking
+ * from it, so events still leave in posting order.
  * ----------------------------------------------------- */
-static fossil_sys_event_t event_queue[MAX_EVENTS];
-static size_t event_count = 0;
+typedef struct {
+    uint32_t key;    // interned id, 0 for none or a private copy
+    uint32_t size;
+    uint8_t type;    // fossil_sys_event_type_t
+    uint8_t storage; // fossil_sys_event_storage_t
+    union {
+        struct {
+            void *ptr;  // heap or slab payload
+            char *name; // malloc'd copy of an id that was never interned
+        };
+        unsigned char bytes[FOSSIL_SYS_EVENT_INLINE_MAX];
+    } data;
+} fossil_sys_event_slot_t;
+
+typedef struct {
+    _Atomic size_t turn;
+    fossil_sys_event_slot_t slot;
+} fossil_sys_event_cell_t;
+
+_Static_assert(sizeof(fossil_sys_event_cell_t) <= EVENT_CACHE_LINE, "event cell must fit a cache line");
+_Static_assert(sizeof(fossil_sys_event_source_info_t) <= FOSSIL_SYS_EVENT_INLINE_MAX,
+               "source events travel inline");
 
 /* ------------------------------------------------------
- * Initialization
+ * Event Sources
+ *
+ * Descriptors, timers (timerfd) and signals (signalfd) are
+ * registered with one epoll instance per queue, created on
+ * first use. There is no reactor thread: a consumer that
+ * finds the queue empty takes the `polling` role and sleeps
+ * in epoll_wait instead of on the futex, turns whatever
+ * fires into events in the ring and wakes the others. The
+ * remaining consumers park as usual and one of them takes
+ * over when the poller leaves. A post reaches a poller
+ * through an eventfd, so a custom event, a readable socket
+ * or an expired timer ends the same wait.
  * ----------------------------------------------------- */
-int fossil_sys_event_init(void)
+#if defined(EVENT_REACTOR)
+typedef struct {
+    int fd;           // watched descriptor, or the timerfd/signalfd owned by the source
+    uint8_t type;     // fossil_sys_event_type_t, FOSSIL_EVENT_NONE for a free entry
+    uint32_t gen;     // bumped on removal so stale epoll reports are ignored
+    uint32_t epoll;   // registered epoll events
+    uint32_t key;     // interned id
+    uint64_t pending; // timer expirations that did not fit in the ring
+} fossil_sys_event_watch_t;
+
+/*
+ * Timeouts live in a hierarchical timing wheel (Varghese &
+ * Lauck) driven by a single timerfd per queue. Level 0 has
+ * one slot per millisecond for the next 256 ms; each level
+ * above has 64 slots, each as wide as the whole level below.
+ * A timeout goes into the lowest level that reaches its
+ * expiry and is cascaded down when its slot comes up, so
+ * arm, cancel and reschedule are O(1) list operations on an
+ * index-linked node table. The timerfd is only reprogrammed
+ * when a timeout lands before the current deadline.
+ */
+typedef struct {
+    uint64_t expires; // monotonic ms
+    uint32_t next, prev;
+    uint32_t gen;     // bumped when the timeout fires or is cancelled, never 0
+    uint32_t bucket;  // EVENT_WHEEL_NIL while free
+    uint32_t key;     // interned id
+    void *context;
+} fossil_sys_event_timeout_node_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    int fd;            // timerfd, -1 until the first timeout is armed
+    uint64_t now;      // next tick to process
+    uint64_t deadline; // tick the timerfd is set for, UINT64_MAX when disarmed
+    uint32_t heads[EVENT_WHEEL_OVERDUE + 1];
+    size_t level_count[EVENT_WHEEL_LEVELS];
+    fossil_sys_event_timeout_node_t *nodes;
+    uint32_t capacity;
+    uint32_t free_head;
+} fossil_sys_event_wheel_t;
+
+typedef struct {
+    int epfd;
+    int wakefd;           // eventfd that ends the poller's epoll_wait when an event is posted
+    _Atomic int polling;  // a consumer is (about to be) in epoll_wait
+    pthread_mutex_t lock; // guards the watch table
+    fossil_sys_event_watch_t *watches;
+    size_t count;
+    fossil_sys_event_wheel_t wheel;
+} fossil_sys_event_reactor_t;
+#endif
+
+typedef struct {
+    _Atomic size_t enqueue_pos;
+    char pad0[EVENT_CACHE_LINE - sizeof(size_t)];
+    _Atomic size_t dequeue_pos;
+    char pad1[EVENT_CACHE_LINE - sizeof(size_t)];
+    _Atomic(fossil_sys_event_cell_t *) cells; // cache-line aligned, NULL until the first post
+    void *cells_raw;
+    char pad2[EVENT_CACHE_LINE - 2 * sizeof(void *)];
+} fossil_sys_event_lane_t;
+
+typedef struct {
+    fossil_sys_event_handler_t handler;
+    void *context;
+    int subscription;
+} fossil_sys_event_subscriber_t;
+
+typedef struct {
+    uint32_t key; // 0 for an unused route
+    uint32_t count;
+    uint32_t capacity;
+    fossil_sys_event_subscriber_t *subscribers;
+} fossil_sys_event_route_t;
+
+typedef struct {
+    _Atomic uint64_t posted;
+    _Atomic uint64_t delivered;
+    _Atomic uint64_t dropped;
+    _Atomic uint64_t spilled;
+    _Atomic uint64_t blocked;
+    char pad[EVENT_CACHE_LINE - 5 * sizeof(uint64_t)];
+} fossil_sys_event_stripe_t;
+
+typedef struct fossil_sys_event_spill_node {
+    struct fossil_sys_event_spill_node *next;
+    fossil_sys_event_slot_t slot;
+} fossil_sys_event_spill_node_t;
+
+typedef struct {
+    fossil_sys_event_lock_t lock;
+    fossil_sys_event_spill_node_t *head; // oldest
+    fossil_sys_event_spill_node_t *tail;
+    _Atomic size_t count;                // drops to 0 only once every spilled event is in the ring
+} fossil_sys_event_spill_t;
+
+typedef struct fossil_sys_event_awaiter {
+    struct fossil_sys_event_awaiter *next;
+    fossil_sys_event_resume_t resume;
+    void *context;
+} fossil_sys_event_awaiter_t;
+
+struct fossil_sys_event_queue {
+    fossil_sys_event_lane_t lanes[FOSSIL_SYS_EVENT_PRIORITY_LEVELS];
+    fossil_sys_event_stripe_t stripes[EVENT_STAT_STRIPES];
+    _Atomic uint32_t epoch;
+    _Atomic uint32_t waiters;
+    _Atomic uint32_t space_epoch;   // moved when a blocking queue frees cells
+    _Atomic uint32_t space_waiters; // producers parked for room
+#if !defined(_WIN32) && !defined(__linux__)
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_cond_t space_cond;
+#endif
+    size_t mask;
+    unsigned sample_shift; // every 2^shift-th cell carries a timestamp
+    fossil_sys_event_queue_mode_t mode;
+    fossil_sys_event_backpressure_t backpressure;
+    uint32_t block_timeout_ms; // 0 = infinite
+    fossil_sys_event_spill_t spill[FOSSIL_SYS_EVENT_PRIORITY_LEVELS]; // spill policy only
+    _Atomic uint32_t schedule_len; // 0 = strict priority
+    _Atomic uint32_t drain_tick;
+    _Atomic uint8_t schedule[EVENT_SCHEDULE_MAX];
+    _Atomic(fossil_sys_memory_pool_t *) slab; // created on first slab post
+#if defined(EVENT_REACTOR)
+    _Atomic(fossil_sys_event_reactor_t *) reactor; // created on first source registration
+#endif
+    fossil_sys_event_lock_t routes_lock;
+    fossil_sys_event_route_t *routes; // open addressing by interned id
+    size_t route_capacity;
+    size_t route_count;
+    int next_subscription;
+    fossil_sys_event_lock_t await_lock;
+    fossil_sys_event_awaiter_t *await_head; // oldest waiting callback
+    fossil_sys_event_awaiter_t *await_tail;
+    _Atomic size_t awaiting;                // lets dispatch skip the lock
+    _Atomic size_t high_water;
+    _Atomic uint64_t latency_sum;
+    _Atomic uint64_t latency_min; // smallest latency + 1, 0 before the first sample
+    _Atomic uint64_t latency_max;
+    _Atomic uint64_t latency[EVENT_LATENCY_BUCKETS];
+};
+
+// Cells needed after a ring to hold `stamps` timestamp words.
+#define EVENT_STAMP_CELLS(stamps) \
+    (((stamps) * sizeof(uint64_t) + sizeof(fossil_sys_event_cell_t) - 1) / sizeof(fossil_sys_event_cell_t))
+
+_Static_assert(FOSSIL_SYS_EVENT_LATENCY_SAMPLE == 1 << EVENT_SAMPLE_SHIFT, "sample period must be 2^EVENT_SAMPLE_SHIFT");
+_Static_assert(FOSSIL_SYS_EVENT_CAPACITY >= FOSSIL_SYS_EVENT_LATENCY_SAMPLE, "default ring shorter than a sample period");
+
+static _Alignas(EVENT_CACHE_LINE) fossil_sys_event_cell_t
+    default_cells[FOSSIL_SYS_EVENT_CAPACITY + EVENT_STAMP_CELLS(FOSSIL_SYS_EVENT_CAPACITY >> EVENT_SAMPLE_SHIFT)];
+
+static fossil_sys_event_queue_t default_queue = {
+    .mask = FOSSIL_SYS_EVENT_CAPACITY - 1,
+    .sample_shift = EVENT_SAMPLE_SHIFT,
+    .mode = FOSSIL_SYS_EVENT_QUEUE_MPMC,
+    .lanes[FOSSIL_SYS_EVENT_PRIORITY_NORMAL].cells = default_cells,
+    .routes_lock = EVENT_LOCK_INITIALIZER,
+    .await_lock = EVENT_LOCK_INITIALIZER,
+    .spill[0].lock = EVENT_LOCK_INITIALIZER,
+    .spill[1].lock = EVENT_LOCK_INITIALIZER,
+    .spill[2].lock = EVENT_LOCK_INITIALIZER,
+    .spill[3].lock = EVENT_LOCK_INITIALIZER,
+#if !defined(_WIN32) && !defined(__linux__)
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .space_cond = PTHREAD_COND_INITIALIZER,
+#endif
+};
+_Static_assert(FOSSIL_SYS_EVENT_PRIORITY_LEVELS == 4, "default_queue initializes one spill lock per lane");
+
+/* ------------------------------------------------------
+ * Event IDs
+ *
+ * Ids are interned once into a process-wide table and
+ * travel through the rings as 32-bit keys; 0 stands for a
+ * NULL id. The table owns a copy of every name, so events
+ * never point at caller memory. Names are never freed, so
+ * only subscribe, intern and the event sources add them;
+ * a post whose id is not in the table carries its own
+ * copy instead (key 0), freed with the event. Lookups
+ * are lock-free: names and keys are published with
+ * release stores and never change or go away; only
+ * inserts take the lock.
+ * A grown hash index keeps its predecessor reachable,
+ * so readers still probing the old one stay valid.
+ * ----------------------------------------------------- */
+typedef struct {
+    const char *name;
+    uint32_t hash;
+} fossil_sys_event_name_t;
+
+typedef struct fossil_sys_event_index {
+    size_t mask;
+    struct fossil_sys_event_index *previous;
+    _Atomic uint32_t keys[]; // 0 = empty
+} fossil_sys_event_index_t;
+
+static fossil_sys_event_lock_t g_names_lock = EVENT_LOCK_INITIALIZER;
+static _Atomic(fossil_sys_event_name_t *) g_names[EVENT_NAME_CHUNKS];
+static _Atomic(fossil_sys_event_index_t *) g_name_index;
+static uint32_t g_name_count;
+
+static uint32_t fossil_sys_event_hash(const char *id)
+{
+    uint32_t hash = 2166136261u; // FNV-1a
+    for (const unsigned char *p = (const unsigned char *)id; *p; p++)
+        hash = (hash ^ *p) * 16777619u;
+    return hash;
+}
+
+static const fossil_sys_event_name_t *fossil_sys_event_name_entry(uint32_t key)
+{
+    uint32_t slot = key - 1;
+    if (key == 0 || slot / EVENT_NAME_CHUNK >= EVENT_NAME_CHUNKS)
+        return NULL;
+    fossil_sys_event_name_t *chunk = atomic_load_explicit(&g_names[slot / EVENT_NAME_CHUNK], memory_order_acquire);
+    return chunk ? &chunk[slot % EVENT_NAME_CHUNK] : NULL;
+}
+
+static uint32_t fossil_sys_event_lookup(const fossil_sys_event_index_t *index, const char *id, uint32_t hash)
+{
+    if (!index)
+        return 0;
+    for (size_t i = hash & index->mask;; i = (i + 1) & index->mask)
+    {
+        uint32_t key = atomic_load_explicit(&index->keys[i], memory_order_acquire);
+        if (key == 0)
+            return 0;
+        const fossil_sys_event_name_t *entry = fossil_sys_event_name_entry(key);
+        if (entry->hash == hash && strcmp(entry->name, id) == 0)
+            return key;
+    }
+}
+
+static void fossil_sys_event_index_put(fossil_sys_event_index_t *index, uint32_t key, uint32_t hash)
+{
+    size_t i = hash & index->mask;
+    while (atomic_load_explicit(&index->keys[i], memory_order_relaxed) != 0)
+        i = (i + 1) & index->mask;
+    atomic_store_explicit(&index->keys[i], key, memory_order_release);
+}
+
+uint32_t fossil_sys_event_intern(const char *id)
+{
+    if (!id)
+        return 0;
+
+    uint32_t hash = fossil_sys_event_hash(id);
+    uint32_t key = fossil_sys_event_lookup(atomic_load_explicit(&g_name_index, memory_order_acquire), id, hash);
+    if (key)
+        return key;
+
+    fossil_sys_event_lock(&g_names_lock);
+    fossil_sys_event_index_t *index = atomic_load_explicit(&g_name_index, memory_order_relaxed);
+    key = fossil_sys_event_lookup(index, id, hash); // another thread may have won
+    if (key || g_name_count >= (uint32_t)EVENT_NAME_CHUNK * EVENT_NAME_CHUNKS)
+        goto done;
+
+    // Keep the index at most half full.
+    size_t capacity = index ? index->mask + 1 : 0;
+    if ((size_t)(g_name_count + 1) * 2 > capacity)
+    {
+        size_t grown = capacity ? capacity * 2 : 256;
+        fossil_sys_event_index_t *fresh = calloc(1, sizeof(*fresh) + grown * sizeof(fresh->keys[0]));
+        if (!fresh)
+            goto done;
+        fresh->mask = grown - 1;
+        fresh->previous = index;
+        for (uint32_t k = 1; k <= g_name_count; k++)
+            fossil_sys_event_index_put(fresh, k, fossil_sys_event_name_entry(k)->hash);
+        atomic_store_explicit(&g_name_index, fresh, memory_order_release);
+        index = fresh;
+    }
+
+    uint32_t slot = g_name_count;
+    fossil_sys_event_name_t *chunk = atomic_load_explicit(&g_names[slot / EVENT_NAME_CHUNK], memory_order_relaxed);
+    if (!chunk)
+    {
+        chunk = calloc(EVENT_NAME_CHUNK, sizeof(*chunk));
+        if (!chunk)
+            goto done;
+        atomic_store_explicit(&g_names[slot / EVENT_NAME_CHUNK], chunk, memory_order_release);
+    }
+    size_t length = strlen(id) + 1;
+    char *name = malloc(length);
+    if (!name)
+        goto done;
+    memcpy(name, id, length);
+    chunk[slot % EVENT_NAME_CHUNK].name = name;
+    chunk[slot % EVENT_NAME_CHUNK].hash = hash;
+    key = ++g_name_count;
+    fossil_sys_event_index_put(index, key, hash);
+
+done:
+    fossil_sys_event_unlock(&g_names_lock);
+    return key;
+}
+
+const char *fossil_sys_event_name(uint32_t key)
+{
+    const fossil_sys_event_name_t *entry = fossil_sys_event_name_entry(key);
+    return entry ? entry->name : NULL;
+}
+
+// Returns id's key if it was interned, 0 otherwise; never adds a name, so posts
+// with one-off ids cannot grow the table.
+static uint32_t fossil_sys_event_find(const char *id)
+{
+    if (!id)
+        return 0;
+    return fossil_sys_event_lookup(atomic_load_explicit(&g_name_index, memory_order_acquire), id,
+                                   fossil_sys_event_hash(id));
+}
+
+// Key to route an event by; events with a private id copy were posted before
+// (or without) the id being interned.
+static uint32_t fossil_sys_event_route_key(const fossil_sys_event_t *event)
+{
+    return event->key ? event->key : fossil_sys_event_find(event->id);
+}
+
+// Interns id into *key; fails only when a non-NULL id cannot be stored.
+static int fossil_sys_event_key(const char *id, uint32_t *key)
+{
+    *key = fossil_sys_event_intern(id);
+    return (*key == 0 && id) ? -1 : 0;
+}
+
+static _Atomic uint32_t g_stripe_next;
+static EVENT_THREAD_LOCAL uint32_t g_stripe_self; // stripe index + 1, 0 until first use
+
+static fossil_sys_event_stripe_t *fossil_sys_event_stripe(fossil_sys_event_queue_t *queue)
+{
+    uint32_t self = g_stripe_self;
+    if (!self)
+        self = g_stripe_self = atomic_fetch_add_explicit(&g_stripe_next, 1, memory_order_relaxed) %
+                               EVENT_STAT_STRIPES + 1;
+    return &queue->stripes[self - 1];
+}
+
+static void fossil_sys_event_count_dropped(fossil_sys_event_queue_t *queue, size_t count)
+{
+    atomic_fetch_add_explicit(&fossil_sys_event_stripe(queue)->dropped, count, memory_order_relaxed);
+}
+
+static uint64_t fossil_sys_event_now_ns(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency; // every thread computes the same value
+    LARGE_INTEGER counter;
+    if (!frequency.QuadPart)
+        QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    uint64_t ticks = (uint64_t)counter.QuadPart, hz = (uint64_t)frequency.QuadPart;
+    return ticks / hz * 1000000000u + ticks % hz * 1000000000u / hz;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Log-linear bucket of a latency: exact below 16 ns, then 16 sub-buckets per power of two.
+static size_t fossil_sys_event_latency_bucket(uint64_t ns)
+{
+    if (ns < (1u << EVENT_LATENCY_SUB_BITS))
+        return (size_t)ns;
+#if defined(__GNUC__) || defined(__clang__)
+    unsigned exp = 63u - (unsigned)__builtin_clzll((unsigned long long)ns);
+#else
+    unsigned exp = 0;
+    while (ns >> (exp + 1))
+        exp++;
+#endif
+    if (exp > EVENT_LATENCY_MAX_EXP)
+        return EVENT_LATENCY_BUCKETS - 1;
+    return ((size_t)(exp - EVENT_LATENCY_SUB_BITS + 1) << EVENT_LATENCY_SUB_BITS) +
+           (size_t)((ns >> (exp - EVENT_LATENCY_SUB_BITS)) & ((1u << EVENT_LATENCY_SUB_BITS) - 1));
+}
+
+// Highest latency that falls into a bucket.
+static uint64_t fossil_sys_event_latency_value(size_t bucket)
+{
+    if (bucket < (1u << EVENT_LATENCY_SUB_BITS))
+        return bucket;
+    unsigned exp = (unsigned)(bucket >> EVENT_LATENCY_SUB_BITS) + EVENT_LATENCY_SUB_BITS - 1;
+    uint64_t sub = (bucket & ((1u << EVENT_LATENCY_SUB_BITS) - 1)) | (1u << EVENT_LATENCY_SUB_BITS);
+    return ((sub + 1) << (exp - EVENT_LATENCY_SUB_BITS)) - 1;
+}
+
+static void fossil_sys_event_record_latency(fossil_sys_event_queue_t *queue, uint64_t ns)
+{
+    atomic_fetch_add_explicit(&queue->latency[fossil_sys_event_latency_bucket(ns)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&queue->latency_sum, ns, memory_order_relaxed);
+
+    uint64_t max = atomic_load_explicit(&queue->latency_max, memory_order_relaxed);
+    while (ns > max && !atomic_compare_exchange_weak_explicit(&queue->latency_max, &max, ns,
+                                                              memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+    uint64_t min = atomic_load_explicit(&queue->latency_min, memory_order_relaxed);
+    while ((min == 0 || ns + 1 < min) &&
+           !atomic_compare_exchange_weak_explicit(&queue->latency_min, &min, ns + 1,
+                                                  memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+}
+
+// Timestamp words that follow a lane's cells, one per sampled cell.
+static uint64_t *fossil_sys_event_stamps(fossil_sys_event_queue_t *queue, fossil_sys_event_cell_t *cells)
+{
+    return (uint64_t *)(void *)(cells + queue->mask + 1);
+}
+
+// Claims up to `want` consecutive cells starting at *cursor with one CAS (or
+// a plain store for a single-threaded side). A cell is ready when its sequence
+// equals pos + ready: 0 for producers (empty), 1 for consumers (full).
+static size_t fossil_sys_event_claim(fossil_sys_event_cell_t *cells, size_t mask, _Atomic size_t *cursor,
+                                     size_t ready, int single, size_t want, size_t *out_pos)
+{
+    if (want == 0)
+        return 0;
+
+    size_t pos = atomic_load_explicit(cursor, memory_order_relaxed);
+    size_t count;
+    for (;;)
+    {
+        intptr_t dif = 0;
+        count = 0;
+        while (count < want)
+        {
+            size_t index = (pos + count) & mask;
+            size_t seq = atomic_load_explicit(&cells[index].turn, memory_order_acquire) + index;
+            dif = (intptr_t)seq - (intptr_t)(pos + count + ready);
+            if (dif != 0)
+                break;
+            count++;
+        }
+
+        if (count == 0)
+        {
+            if (dif < 0)
+                return 0; // full for producers, empty for consumers
+            pos = atomic_load_explicit(cursor, memory_order_relaxed); // another thread moved on
+            continue;
+        }
+
+        if (single)
+        {
+            atomic_store_explicit(cursor, pos + count, memory_order_relaxed);
+            break;
+        }
+        if (atomic_compare_exchange_weak_explicit(cursor, &pos, pos + count,
+                                                  memory_order_relaxed, memory_order_relaxed))
+            break;
+    }
+    *out_pos = pos;
+    return count;
+}
+
+// Returns the cells of a lane, allocating them on first use.
+static fossil_sys_event_cell_t *fossil_sys_event_lane_cells(fossil_sys_event_queue_t *queue,
+                                                            fossil_sys_event_lane_t *lane)
+{
+    fossil_sys_event_cell_t *cells = atomic_load_explicit(&lane->cells, memory_order_acquire);
+    if (cells)
+        return cells;
+
+    size_t stamps = EVENT_STAMP_CELLS((queue->mask + 1) >> queue->sample_shift);
+    void *raw = calloc(queue->mask + 2 + stamps, sizeof(fossil_sys_event_cell_t)); // zeroed cells form an empty ring
+    if (!raw)
+        return NULL;
+    fossil_sys_event_cell_t *fresh = (fossil_sys_event_cell_t *)(((uintptr_t)raw + EVENT_CACHE_LINE - 1) &
+                                                                 ~(uintptr_t)(EVENT_CACHE_LINE - 1));
+    if (!atomic_compare_exchange_strong_explicit(&lane->cells, &cells, fresh,
+                                                 memory_order_acq_rel, memory_order_acquire))
+    {
+        free(raw); // lost the race; cells holds the winner
+        return cells;
+    }
+    lane->cells_raw = raw;
+    return fresh;
+}
+
+static size_t fossil_sys_event_enqueue(fossil_sys_event_queue_t *queue, fossil_sys_event_priority_t priority,
+                                       const fossil_sys_event_slot_t *slots, size_t count)
+{
+    fossil_sys_event_lane_t *lane = &queue->lanes[priority];
+    fossil_sys_event_cell_t *cells = fossil_sys_event_lane_cells(queue, lane);
+    if (!cells)
+        return 0;
+
+    size_t pos;
+    count = fossil_sys_event_claim(cells, queue->mask, &lane->enqueue_pos, 0, queue->mode & EVENT_SINGLE_PRODUCER,
+                                   count, &pos);
+    if (count == 0)
+        return 0;
+
+    uint64_t *stamps = fossil_sys_event_stamps(queue, cells);
+    size_t period = ((size_t)1 << queue->sample_shift) - 1;
+    uint64_t now = 0;
+    for (size_t i = 0; i < count; i++, pos++)
+    {
+        fossil_sys_event_cell_t *cell = &cells[pos & queue->mask];
+        cell->slot = slots[i];
+        if ((pos & period) == 0)
+        {
+            if (!now)
+                now = fossil_sys_event_now_ns();
+            stamps[(pos & queue->mask) >> queue->sample_shift] = now;
+        }
+        atomic_store_explicit(&cell->turn, pos + 1 - (pos & queue->mask), memory_order_release);
+    }
+
+    atomic_fetch_add_explicit(&fossil_sys_event_stripe(queue)->posted, count, memory_order_relaxed);
+    size_t depth = pos - atomic_load_explicit(&lane->dequeue_pos, memory_order_relaxed);
+    if (depth > queue->mask + 1)
+        depth = queue->mask + 1; // stale dequeue_pos
+    size_t high = atomic_load_explicit(&queue->high_water, memory_order_relaxed);
+    while (depth > high && !atomic_compare_exchange_weak_explicit(&queue->high_water, &high, depth,
+                                                                  memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+    return count;
+}
+
+static void fossil_sys_event_slot_read(fossil_sys_event_queue_t *queue, const fossil_sys_event_slot_t *slot,
+                                       fossil_sys_event_t *out_event)
 {
-    event_count = 0;
-    memset(event_queue, 0, sizeof(event_queue));
+    out_event->id = slot->key || slot->storage == FOSSIL_SYS_EVENT_STORAGE_INLINE ? fossil_sys_event_name(slot->key)
+                                                                                   : slot->data.name;
+    out_event->key = slot->key;
+    out_event->type = (fossil_sys_event_type_t)slot->type;
+    out_event->size = slot->size;
+    out_event->storage = (fossil_sys_event_storage_t)slot->storage;
+    out_event->owner = NULL;
+    switch (out_event->storage)
+    {
+    case FOSSIL_SYS_EVENT_STORAGE_INLINE:
+        memcpy(out_event->inline_data, slot->data.bytes, slot->size);
+        out_event->payload = out_event->inline_data;
+        break;
+    case FOSSIL_SYS_EVENT_STORAGE_SLAB:
+        out_event->owner = atomic_load_explicit(&queue->slab, memory_order_relaxed);
+        out_event->payload = slot->data.ptr;
+        break;
+    case FOSSIL_SYS_EVENT_STORAGE_HEAP:
+        out_event->payload = slot->data.ptr;
+        break;
+    default:
+        out_event->payload = NULL;
+        break;
+    }
+}
+
+static size_t fossil_sys_event_dequeue_lane(fossil_sys_event_queue_t *queue, fossil_sys_event_lane_t *lane,
+                                            fossil_sys_event_t *out_events, size_t count)
+{
+    fossil_sys_event_cell_t *cells = atomic_load_explicit(&lane->cells, memory_order_acquire);
+    if (!cells)
+        return 0; // never posted to
+
+    size_t pos;
+    count = fossil_sys_event_claim(cells, queue->mask, &lane->dequeue_pos, 1, queue->mode & EVENT_SINGLE_CONSUMER,
+                                   count, &pos);
+    if (count == 0)
+        return 0;
+
+    uint64_t *stamps = fossil_sys_event_stamps(queue, cells);
+    size_t period = ((size_t)1 << queue->sample_shift) - 1;
+    uint64_t now = 0;
+    for (size_t i = 0; i < count; i++, pos++)
+    {
+        fossil_sys_event_cell_t *cell = &cells[pos & queue->mask];
+        fossil_sys_event_slot_read(queue, &cell->slot, &out_events[i]);
+        if ((pos & period) == 0)
+        {
+            if (!now)
+                now = fossil_sys_event_now_ns();
+            uint64_t stamp = stamps[(pos & queue->mask) >> queue->sample_shift];
+            fossil_sys_event_record_latency(queue, now > stamp ? now - stamp : 0);
+        }
+        atomic_store_explicit(&cell->turn, pos + queue->mask + 1 - (pos & queue->mask), memory_order_release);
+    }
+    return count;
+}
+
+static void fossil_sys_event_wake(fossil_sys_event_queue_t *queue, _Atomic uint32_t *word, size_t count);
+
+// Moves a lane's spilled events into its ring, oldest first, as far as they fit.
+static void fossil_sys_event_unspill(fossil_sys_event_queue_t *queue, int priority)
+{
+    fossil_sys_event_spill_t *spill = &queue->spill[priority];
+    fossil_sys_event_lock(&spill->lock);
+    size_t moved = 0;
+    while (spill->head && fossil_sys_event_enqueue(queue, (fossil_sys_event_priority_t)priority,
+                                                   &spill->head->slot, 1) == 1)
+    {
+        fossil_sys_event_spill_node_t *node = spill->head;
+        spill->head = node->next;
+        free(node);
+        moved++;
+    }
+    if (!spill->head)
+        spill->tail = NULL;
+    atomic_fetch_sub_explicit(&spill->count, moved, memory_order_release);
+    fossil_sys_event_unlock(&spill->lock);
+}
+
+// Takes up to count events across the lanes following the drain policy.
+static size_t fossil_sys_event_dequeue(fossil_sys_event_queue_t *queue, fossil_sys_event_t *out_events, size_t count)
+{
+    if (queue->backpressure == FOSSIL_SYS_EVENT_FULL_SPILL)
+    {
+        for (int priority = 0; priority < FOSSIL_SYS_EVENT_PRIORITY_LEVELS; priority++)
+        {
+            if (atomic_load_explicit(&queue->spill[priority].count, memory_order_acquire))
+                fossil_sys_event_unspill(queue, priority);
+        }
+    }
+
+    size_t got = 0;
+    int first = -1;
+    uint32_t len = atomic_load_explicit(&queue->schedule_len, memory_order_relaxed);
+    if (len)
+    {
+        uint32_t tick = atomic_fetch_add_explicit(&queue->drain_tick, 1, memory_order_relaxed) % len;
+        first = atomic_load_explicit(&queue->schedule[tick], memory_order_relaxed);
+        got = fossil_sys_event_dequeue_lane(queue, &queue->lanes[first], out_events, count);
+    }
+    for (int priority = 0; priority < FOSSIL_SYS_EVENT_PRIORITY_LEVELS && got < count; priority++)
+    {
+        if (priority != first)
+            got += fossil_sys_event_dequeue_lane(queue, &queue->lanes[priority], out_events + got, count - got);
+    }
+    if (got == 0)
+        return 0;
+
+    atomic_fetch_add_explicit(&fossil_sys_event_stripe(queue)->delivered, got, memory_order_relaxed);
+    if (queue->backpressure == FOSSIL_SYS_EVENT_FULL_BLOCK)
+    {
+        // Pairs with the fence in fossil_sys_event_push: either we see the
+        // parked producer, or its re-check sees the cells we just freed.
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&queue->space_waiters, memory_order_relaxed))
+            fossil_sys_event_wake(queue, &queue->space_epoch, got);
+    }
+    return got;
+}
+
+// Reports whether some lane has an event ready, without taking it.
+static int fossil_sys_event_pending(fossil_sys_event_queue_t *queue)
+{
+    for (int priority = 0; priority < FOSSIL_SYS_EVENT_PRIORITY_LEVELS; priority++)
+    {
+        fossil_sys_event_lane_t *lane = &queue->lanes[priority];
+        fossil_sys_event_cell_t *cells = atomic_load_explicit(&lane->cells, memory_order_acquire);
+        if (!cells)
+            continue;
+        size_t pos = atomic_load_explicit(&lane->dequeue_pos, memory_order_relaxed);
+        size_t index = pos & queue->mask;
+        if (atomic_load_explicit(&cells[index].turn, memory_order_acquire) + index == pos + 1)
+            return 1;
+        if (queue->backpressure == FOSSIL_SYS_EVENT_FULL_SPILL &&
+            atomic_load_explicit(&queue->spill[priority].count, memory_order_acquire))
+            return 1;
+    }
     return 0;
 }
 
-/* ------------------------------------------------------
- * Poll events (non-blocking)
- * ----------------------------------------------------- */
-int fossil_sys_event_poll(fossil_sys_event_t *out_event)
+static fossil_sys_memory_pool_t *fossil_sys_event_slab(fossil_sys_event_queue_t *queue)
 {
-    if (!out_event)
-        return -1;
+    fossil_sys_memory_pool_t *slab = atomic_load_explicit(&queue->slab, memory_order_acquire);
+    if (slab)
+        return slab;
 
-    if (event_count == 0)
-        return 0; // no events
+    fossil_sys_memory_pool_t *fresh = fossil_sys_memory_pool_create(FOSSIL_SYS_EVENT_SLAB_BLOCK, 0);
+    if (!fresh)
+        return NULL;
+    if (!atomic_compare_exchange_strong_explicit(&queue->slab, &slab, fresh,
+                                                 memory_order_acq_rel, memory_order_acquire))
+    {
+        fossil_sys_memory_pool_destroy(fresh); // lost the race; slab holds the winner
+        return slab;
+    }
+    return fresh;
+}
 
-    *out_event = event_queue[0];
+static uint64_t fossil_sys_event_now_ms(void)
+{
+#if defined(_WIN32)
+    return GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+#endif
+}
 
-    // Shift remaining events
-    memmove(event_queue, event_queue + 1, (event_count - 1) * sizeof(fossil_sys_event_t));
-    event_count--;
+// Sleeps while *word still holds epoch, for at most timeout_ms (UINT64_MAX = forever).
+// word is the queue's epoch or space_epoch. May return early; callers re-check
+// the queue and the deadline.
+static void fossil_sys_event_park(fossil_sys_event_queue_t *queue, _Atomic uint32_t *word, uint32_t epoch,
+                                  uint64_t timeout_ms)
+{
+#if defined(_WIN32)
+    (void)queue;
+    DWORD ms = timeout_ms >= INFINITE ? INFINITE : (DWORD)timeout_ms;
+    WaitOnAddress((volatile VOID *)word, &epoch, sizeof(epoch), ms);
+#elif defined(__linux__)
+    struct timespec ts, *relative = NULL; // FUTEX_WAIT measures relative timeouts on CLOCK_MONOTONIC
+    if (timeout_ms != UINT64_MAX)
+    {
+        ts.tv_sec = (time_t)(timeout_ms / 1000);
+        ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+        relative = &ts;
+    }
+    (void)queue;
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT_PRIVATE, epoch, relative, NULL, 0);
+#else
+    pthread_cond_t *cond = word == &queue->epoch ? &queue->cond : &queue->space_cond;
+    pthread_mutex_lock(&queue->lock);
+    if (atomic_load_explicit(word, memory_order_relaxed) == epoch)
+    {
+        if (timeout_ms == UINT64_MAX)
+        {
+            pthread_cond_wait(cond, &queue->lock);
+        }
+        else
+        {
+            // Condvars take a wall-clock deadline; the caller's monotonic
+            // deadline check absorbs any clock step.
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += (time_t)(timeout_ms / 1000);
+            deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L)
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(cond, &queue->lock, &deadline);
+        }
+    }
+    pthread_mutex_unlock(&queue->lock);
+#endif
+}
 
-    return 1; // event returned
+// Moves *word and wakes up to count threads parked on it.
+static void fossil_sys_event_wake(fossil_sys_event_queue_t *queue, _Atomic uint32_t *word, size_t count)
+{
+#if defined(_WIN32)
+    (void)queue;
+    atomic_fetch_add_explicit(word, 1, memory_order_release);
+    if (count > 1)
+        WakeByAddressAll((PVOID)word);
+    else
+        WakeByAddressSingle((PVOID)word);
+#elif defined(__linux__)
+    (void)queue;
+    atomic_fetch_add_explicit(word, 1, memory_order_release);
+    int wake = count > INT_MAX ? INT_MAX : (int)count;
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE_PRIVATE, wake, NULL, NULL, 0);
+#else
+    pthread_cond_t *cond = word == &queue->epoch ? &queue->cond : &queue->space_cond;
+    pthread_mutex_lock(&queue->lock);
+    atomic_fetch_add_explicit(word, 1, memory_order_release);
+    if (count > 1)
+        pthread_cond_broadcast(cond);
+    else
+        pthread_cond_signal(cond);
+    pthread_mutex_unlock(&queue->lock);
+#endif
 }
 
-/* ------------------------------------------------------
- * Wait for next event (blocking with timeout)
- * ----------------------------------------------------- */
-int fossil_sys_event_wait(fossil_sys_event_t *out_event, uint32_t timeout_ms)
+// Wakes up to count parked consumers.
+static void fossil_sys_event_unpark(fossil_sys_event_queue_t *queue, size_t count)
 {
-    if (!out_event)
-        return -1;
+    // Pairs with the fence in fossil_sys_event_queue_wait: either we see the
+    // waiter, or the waiter's re-check sees the event we just enqueued.
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&queue->waiters, memory_order_relaxed) == 0)
+        return;
+
+    fossil_sys_event_wake(queue, &queue->epoch, count);
 
-    clock_t start = clock();
-    while (event_count == 0)
+#if defined(EVENT_REACTOR)
+    // A consumer asleep in epoll_wait does not watch the futex. Pairs with the
+    // fence in fossil_sys_event_poll_sources: either we see it polling, or it
+    // sees the epoch we just moved and does not sleep.
+    fossil_sys_event_reactor_t *reactor = atomic_load_explicit(&queue->reactor, memory_order_acquire);
+    if (reactor)
     {
-        clock_t now = clock();
-        uint32_t elapsed_ms = (uint32_t)((now - start) * 1000 / CLOCKS_PER_SEC);
-        if (elapsed_ms >= timeout_ms)
-            return 0; // timeout
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&reactor->polling, memory_order_relaxed))
+        {
+            uint64_t one = 1;
+            ssize_t unused = write(reactor->wakefd, &one, sizeof(one));
+            (void)unused;
+        }
+    }
+#endif
+}
+
+#if defined(EVENT_REACTOR)
+static fossil_sys_event_reactor_t *fossil_sys_event_reactor(fossil_sys_event_queue_t *queue)
+{
+    fossil_sys_event_reactor_t *reactor = atomic_load_explicit(&queue->reactor, memory_order_acquire);
+    if (reactor)
+        return reactor;
+
+    fossil_sys_event_reactor_t *fresh = calloc(1, sizeof(*fresh));
+    if (!fresh)
+        return NULL;
+    fresh->epfd = epoll_create1(EPOLL_CLOEXEC);
+    fresh->wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event wake = {.events = EPOLLIN, .data.u64 = EVENT_WAKE_TOKEN};
+    if (fresh->epfd < 0 || fresh->wakefd < 0 || epoll_ctl(fresh->epfd, EPOLL_CTL_ADD, fresh->wakefd, &wake) != 0)
+    {
+        if (fresh->epfd >= 0)
+            close(fresh->epfd);
+        if (fresh->wakefd >= 0)
+            close(fresh->wakefd);
+        free(fresh);
+        return NULL;
     }
+    pthread_mutex_init(&fresh->lock, NULL);
+    pthread_mutex_init(&fresh->wheel.lock, NULL);
+    fresh->wheel.fd = -1;
+    fresh->wheel.deadline = UINT64_MAX;
+    fresh->wheel.free_head = EVENT_WHEEL_NIL;
+    memset(fresh->wheel.heads, 0xff, sizeof(fresh->wheel.heads)); // all EVENT_WHEEL_NIL
 
-    return fossil_sys_event_poll(out_event);
+    if (!atomic_compare_exchange_strong_explicit(&queue->reactor, &reactor, fresh,
+                                                 memory_order_acq_rel, memory_order_acquire))
+    {
+        close(fresh->epfd); // lost the race; reactor holds the winner
+        close(fresh->wakefd);
+        pthread_mutex_destroy(&fresh->lock);
+        pthread_mutex_destroy(&fresh->wheel.lock);
+        free(fresh);
+        return reactor;
+    }
+    return fresh;
 }
 
-/* ------------------------------------------------------
- * Post a custom event
- * ----------------------------------------------------- */
-int fossil_sys_event_post(const char *id, void *payload, size_t size)
+static void fossil_sys_event_reactor_destroy(fossil_sys_event_reactor_t *reactor)
 {
-    if (event_count >= MAX_EVENTS)
-        return -1; // queue full
+    if (!reactor)
+        return;
+
+    for (size_t i = 0; i < reactor->count; i++)
+    {
+        uint8_t type = reactor->watches[i].type;
+        if (type == FOSSIL_EVENT_TIMER || type == FOSSIL_EVENT_SIGNAL)
+            close(reactor->watches[i].fd);
+    }
+    if (reactor->wheel.fd >= 0)
+        close(reactor->wheel.fd);
+    close(reactor->epfd);
+    close(reactor->wakefd);
+    pthread_mutex_destroy(&reactor->lock);
+    pthread_mutex_destroy(&reactor->wheel.lock);
+    free(reactor->watches);
+    free(reactor->wheel.nodes);
+    free(reactor);
+}
 
-    fossil_sys_event_t *e = &event_queue[event_count];
-    e->id = id;
-    e->type = FOSSIL_EVENT_CUSTOM;
-    e->size = size;
+// Registers a descriptor and returns its source handle (index + 1).
+static int fossil_sys_event_reactor_add(fossil_sys_event_queue_t *queue, int fd, fossil_sys_event_type_t type,
+                                        uint32_t events, const char *id)
+{
+    uint32_t key;
+    fossil_sys_event_reactor_t *reactor = fossil_sys_event_reactor(queue);
+    if (!reactor || fossil_sys_event_key(id, &key) != 0)
+        return -1;
 
-    if (payload && size > 0)
+    pthread_mutex_lock(&reactor->lock);
+    size_t index = 0;
+    while (index < reactor->count && reactor->watches[index].type != FOSSIL_EVENT_NONE)
+        index++;
+    if (index == reactor->count)
     {
-        e->payload = malloc(size);
-        if (!e->payload)
+        size_t grown = reactor->count ? reactor->count * 2 : 8;
+        fossil_sys_event_watch_t *watches = grown < INT_MAX ? realloc(reactor->watches, grown * sizeof(*watches)) : NULL;
+        if (!watches)
+        {
+            pthread_mutex_unlock(&reactor->lock);
             return -1;
-        memcpy(e->payload, payload, size);
+        }
+        memset(watches + reactor->count, 0, (grown - reactor->count) * sizeof(*watches));
+        reactor->watches = watches;
+        reactor->count = grown;
+    }
+
+    fossil_sys_event_watch_t *watch = &reactor->watches[index];
+    struct epoll_event ev = {.events = events, .data.u64 = (uint64_t)watch->gen << 32 | index};
+    if (epoll_ctl(reactor->epfd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        pthread_mutex_unlock(&reactor->lock);
+        return -1;
     }
+    watch->fd = fd;
+    watch->type = (uint8_t)type;
+    watch->epoll = events;
+    watch->key = key;
+    watch->pending = 0;
+    pthread_mutex_unlock(&reactor->lock);
+    return (int)index + 1;
+}
+
+// log2 of the width of one slot at the given level
+static unsigned fossil_sys_event_wheel_shift(unsigned level)
+{
+    return level == 0 ? 0 : 8 + 6 * (level - 1);
+}
+
+static unsigned fossil_sys_event_wheel_level(uint32_t bucket)
+{
+    return bucket < 256 ? 0 : 1 + (bucket - 256) / 64;
+}
+
+static void fossil_sys_event_wheel_link(fossil_sys_event_wheel_t *wheel, uint32_t index, uint32_t bucket)
+{
+    fossil_sys_event_timeout_node_t *node = &wheel->nodes[index];
+    node->bucket = bucket;
+    node->prev = EVENT_WHEEL_NIL;
+    node->next = wheel->heads[bucket];
+    if (node->next != EVENT_WHEEL_NIL)
+        wheel->nodes[node->next].prev = index;
+    wheel->heads[bucket] = index;
+    if (bucket != EVENT_WHEEL_OVERDUE)
+        wheel->level_count[fossil_sys_event_wheel_level(bucket)]++;
+}
+
+static void fossil_sys_event_wheel_unlink(fossil_sys_event_wheel_t *wheel, uint32_t index)
+{
+    fossil_sys_event_timeout_node_t *node = &wheel->nodes[index];
+    if (node->prev != EVENT_WHEEL_NIL)
+        wheel->nodes[node->prev].next = node->next;
     else
+        wheel->heads[node->bucket] = node->next;
+    if (node->next != EVENT_WHEEL_NIL)
+        wheel->nodes[node->next].prev = node->prev;
+    if (node->bucket != EVENT_WHEEL_OVERDUE)
+        wheel->level_count[fossil_sys_event_wheel_level(node->bucket)]--;
+    node->bucket = EVENT_WHEEL_NIL;
+}
+
+// Files a node under the lowest level whose span reaches its expiry.
+static void fossil_sys_event_wheel_place(fossil_sys_event_wheel_t *wheel, uint32_t index)
+{
+    fossil_sys_event_timeout_node_t *node = &wheel->nodes[index];
+    if (node->expires < wheel->now)
+        node->expires = wheel->now;
+    if (node->expires - wheel->now > UINT32_MAX)
+        node->expires = wheel->now + UINT32_MAX;
+
+    uint64_t delta = node->expires - wheel->now;
+    if (delta < 256)
     {
-        e->payload = NULL;
+        fossil_sys_event_wheel_link(wheel, index, (uint32_t)(node->expires & 255));
+        return;
     }
+    unsigned level = 1;
+    while (level < EVENT_WHEEL_LEVELS - 1 && delta >> fossil_sys_event_wheel_shift(level + 1) != 0)
+        level++;
+    uint32_t slot = (uint32_t)(node->expires >> fossil_sys_event_wheel_shift(level)) & 63;
+    fossil_sys_event_wheel_link(wheel, index, 256 + (level - 1) * 64 + slot);
+}
 
-    event_count++;
-    return 0;
+static void fossil_sys_event_wheel_release(fossil_sys_event_wheel_t *wheel, uint32_t index)
+{
+    fossil_sys_event_timeout_node_t *node = &wheel->nodes[index];
+    if (++node->gen == 0)
+        node->gen = 1;
+    node->next = wheel->free_head;
+    wheel->free_head = index;
 }
 
-/* ------------------------------------------------------
- * Shutdown
- * ----------------------------------------------------- */
-void fossil_sys_event_shutdown(void)
+// Processes ticks up to and including target, cascading higher levels as
+// their slots come up and moving expired timeouts to the overdue list.
+static void fossil_sys_event_wheel_advance(fossil_sys_event_wheel_t *wheel, uint64_t target)
+{
+    while (wheel->now <= target)
+    {
+        if (wheel->level_count[0] == 0)
+        {
+            // Nothing can fire before the next slot of the lowest busy level comes up.
+            unsigned level = 1;
+            while (level < EVENT_WHEEL_LEVELS && wheel->level_count[level] == 0)
+                level++;
+            uint64_t width = level < EVENT_WHEEL_LEVELS ? (uint64_t)1 << fossil_sys_event_wheel_shift(level) : 0;
+            uint64_t next = width ? (wheel->now + width - 1) & ~(width - 1) : UINT64_MAX;
+            if (next > target)
+            {
+                wheel->now = target + 1;
+                return;
+            }
+            wheel->now = next;
+        }
+
+        for (unsigned level = EVENT_WHEEL_LEVELS - 1; level >= 1; level--)
+        {
+            unsigned shift = fossil_sys_event_wheel_shift(level);
+            if (wheel->now & (((uint64_t)1 << shift) - 1))
+                continue;
+            uint32_t bucket = 256 + (level - 1) * 64 + ((uint32_t)(wheel->now >> shift) & 63);
+            uint32_t index = wheel->heads[bucket];
+            while (index != EVENT_WHEEL_NIL)
+            {
+                uint32_t next = wheel->nodes[index].next;
+                fossil_sys_event_wheel_unlink(wheel, index);
+                fossil_sys_event_wheel_place(wheel, index);
+                index = next;
+            }
+        }
+
+        uint32_t index = wheel->heads[wheel->now & 255];
+        while (index != EVENT_WHEEL_NIL)
+        {
+            uint32_t next = wheel->nodes[index].next;
+            fossil_sys_event_wheel_unlink(wheel, index);
+            fossil_sys_event_wheel_link(wheel, index, EVENT_WHEEL_OVERDUE);
+            index = next;
+        }
+        wheel->now++;
+    }
+}
+
+// Earliest tick the wheel needs attention at, UINT64_MAX when empty.
+static uint64_t fossil_sys_event_wheel_next(const fossil_sys_event_wheel_t *wheel)
+{
+    if (wheel->heads[EVENT_WHEEL_OVERDUE] != EVENT_WHEEL_NIL)
+        return wheel->now; // retry delivery
+
+    uint64_t next = UINT64_MAX;
+    if (wheel->level_count[0])
+    {
+        for (uint64_t tick = wheel->now;; tick++) // level 0 only holds the next 256 ticks
+        {
+            if (wheel->heads[tick & 255] != EVENT_WHEEL_NIL)
+            {
+                next = tick;
+                break;
+            }
+        }
+    }
+    for (unsigned level = 1; level < EVENT_WHEEL_LEVELS; level++)
+    {
+        if (wheel->level_count[level] == 0)
+            continue;
+        uint64_t width = (uint64_t)1 << fossil_sys_event_wheel_shift(level);
+        uint64_t boundary = (wheel->now + width - 1) & ~(width - 1);
+        if (boundary < next)
+            next = boundary;
+        break; // higher levels come up no earlier
+    }
+    return next;
+}
+
+static void fossil_sys_event_wheel_program(fossil_sys_event_wheel_t *wheel)
 {
-    // Free any allocated payloads
-    for (size_t i = 0; i < event_count; i++)
+    uint64_t next = fossil_sys_event_wheel_next(wheel);
+    if (next == wheel->deadline)
+        return;
+
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec)); // all zero disarms
+    if (next != UINT64_MAX)
     {
-        free(event_queue[i].payload);
-        event_queue[i].payload = NULL;
+        uint64_t at = next ? next : 1;
+        spec.it_value.tv_sec = (time_t)(at / 1000);
+        spec.it_value.tv_nsec = (long)(at % 1000) * 1000000L;
     }
-    event_count = 0;
+    timerfd_settime(wheel->fd, TFD_TIMER_ABSTIME, &spec, NULL);
+    wheel->deadline = next;
+}
+
+// Looks up a live timeout by handle; returns EVENT_WHEEL_NIL if it fired or was cancelled.
+static uint32_t fossil_sys_event_wheel_find(const fossil_sys_event_wheel_t *wheel, fossil_sys_event_timeout_t timeout)
+{
+    uint32_t index = (uint32_t)timeout - 1;
+    if ((uint32_t)timeout == 0 || index >= wheel->capacity || wheel->nodes[index].bucket == EVENT_WHEEL_NIL ||
+        wheel->nodes[index].gen != (uint32_t)(timeout >> 32))
+        return EVENT_WHEEL_NIL;
+    return index;
+}
+
+// Posts expired timeouts; returns how many made it into the ring.
+static size_t fossil_sys_event_wheel_deliver(fossil_sys_event_queue_t *queue, fossil_sys_event_wheel_t *wheel)
+{
+    fossil_sys_event_slot_t slots[EVENT_BATCH_CHUNK];
+    uint32_t indices[EVENT_BATCH_CHUNK];
+    size_t posted = 0;
+
+    pthread_mutex_lock(&wheel->lock);
+    if (wheel->fd < 0)
+    {
+        pthread_mutex_unlock(&wheel->lock);
+        return 0;
+    }
+    uint64_t ticks;
+    ssize_t unused = read(wheel->fd, &ticks, sizeof(ticks)); // clear the timerfd
+    (void)unused;
+    fossil_sys_event_wheel_advance(wheel, fossil_sys_event_now_ms());
+    while (wheel->heads[EVENT_WHEEL_OVERDUE] != EVENT_WHEEL_NIL)
+    {
+        size_t count = 0;
+        for (uint32_t index = wheel->heads[EVENT_WHEEL_OVERDUE]; index != EVENT_WHEEL_NIL && count < EVENT_BATCH_CHUNK;
+             index = wheel->nodes[index].next)
+        {
+            const fossil_sys_event_timeout_node_t *node = &wheel->nodes[index];
+            fossil_sys_event_source_info_t info;
+            memset(&info, 0, sizeof(info));
+            info.fd = -1;
+            info.expirations = 1;
+            info.timeout = (uint64_t)node->gen << 32 | (index + 1);
+            info.context = node->context;
+
+            slots[count].key = node->key;
+            slots[count].type = FOSSIL_EVENT_TIMER;
+            slots[count].size = (uint32_t)sizeof(info);
+            slots[count].storage = FOSSIL_SYS_EVENT_STORAGE_INLINE;
+            memcpy(slots[count].data.bytes, &info, sizeof(info));
+            indices[count++] = index;
+        }
+
+        size_t done = fossil_sys_event_enqueue(queue, FOSSIL_SYS_EVENT_PRIORITY_NORMAL, slots, count);
+        for (size_t i = 0; i < done; i++)
+        {
+            fossil_sys_event_wheel_unlink(wheel, indices[i]);
+            fossil_sys_event_wheel_release(wheel, indices[i]);
+        }
+        posted += done;
+        if (done < count)
+            break; // ring full; the rest stay overdue
+    }
+    wheel->deadline = UINT64_MAX; // the timerfd has fired, so it is disarmed
+    fossil_sys_event_wheel_program(wheel);
+    pthread_mutex_unlock(&wheel->lock);
+    return posted;
+}
+
+// Turns ready sources into events in the ring; returns how many were posted.
+static size_t fossil_sys_event_harvest(fossil_sys_event_queue_t *queue, fossil_sys_event_reactor_t *reactor,
+                                       int timeout_ms)
+{
+    struct epoll_event ready[EVENT_BATCH_CHUNK];
+    int n = epoll_wait(reactor->epfd, ready, EVENT_BATCH_CHUNK, timeout_ms);
+    if (n <= 0)
+        return 0; // timeout or EINTR
+
+    fossil_sys_event_slot_t slots[EVENT_BATCH_CHUNK];
+    uint64_t keys[EVENT_BATCH_CHUNK];
+    size_t count = 0;
+    int wheel_due = 0;
+
+    pthread_mutex_lock(&reactor->lock);
+    for (int i = 0; i < n; i++)
+    {
+        uint64_t key = ready[i].data.u64;
+        if (key == EVENT_WAKE_TOKEN)
+        {
+            uint64_t posts;
+            ssize_t unused = read(reactor->wakefd, &posts, sizeof(posts));
+            (void)unused;
+            continue;
+        }
+        if (key == EVENT_WHEEL_TOKEN)
+        {
+            wheel_due = 1;
+            continue;
+        }
+
+        size_t index = (size_t)(uint32_t)key;
+        if (index >= reactor->count || reactor->watches[index].type == FOSSIL_EVENT_NONE ||
+            reactor->watches[index].gen != (uint32_t)(key >> 32))
+            continue; // removed since epoll reported it
+        fossil_sys_event_watch_t *watch = &reactor->watches[index];
+
+        fossil_sys_event_source_info_t info;
+        memset(&info, 0, sizeof(info));
+        info.source = (int)index + 1;
+        info.fd = watch->fd;
+        if (watch->type == FOSSIL_EVENT_IO)
+        {
+            uint32_t events = ready[i].events;
+            info.events = ((events & EPOLLIN) ? FOSSIL_SYS_EVENT_IO_READ : 0) |
+                          ((events & EPOLLOUT) ? FOSSIL_SYS_EVENT_IO_WRITE : 0) |
+                          ((events & (EPOLLHUP | EPOLLRDHUP)) ? FOSSIL_SYS_EVENT_IO_HANGUP : 0) |
+                          ((events & EPOLLERR) ? FOSSIL_SYS_EVENT_IO_ERROR : 0);
+        }
+        else if (watch->type == FOSSIL_EVENT_TIMER)
+        {
+            uint64_t ticks = 0;
+            if (read(watch->fd, &ticks, sizeof(ticks)) != (ssize_t)sizeof(ticks))
+                ticks = 0;
+            info.expirations = ticks + watch->pending;
+            watch->pending = 0;
+            if (info.expirations == 0)
+                continue;
+        }
+        else
+        {
+            struct signalfd_siginfo siginfo;
+            if (read(watch->fd, &siginfo, sizeof(siginfo)) != (ssize_t)sizeof(siginfo))
+                continue;
+            info.signo = (int)siginfo.ssi_signo;
+        }
+
+        fossil_sys_event_slot_t *slot = &slots[count];
+        slot->key = watch->key;
+        slot->type = watch->type;
+        slot->size = (uint32_t)sizeof(info);
+        slot->storage = FOSSIL_SYS_EVENT_STORAGE_INLINE;
+        memcpy(slot->data.bytes, &info, sizeof(info));
+        keys[count++] = key;
+    }
+    pthread_mutex_unlock(&reactor->lock);
+
+    size_t done = fossil_sys_event_enqueue(queue, FOSSIL_SYS_EVENT_PRIORITY_NORMAL, slots, count);
+    if (done < count)
+    {
+        // Ring full: descriptors are re-armed so epoll reports them again and
+        // timer ticks carry over; a signal that does not fit is dropped.
+        pthread_mutex_lock(&reactor->lock);
+        for (size_t i = done; i < count; i++)
+        {
+            if (slots[i].type == FOSSIL_EVENT_SIGNAL)
+                fossil_sys_event_count_dropped(queue, 1);
+            size_t index = (size_t)(uint32_t)keys[i];
+            fossil_sys_event_watch_t *watch = &reactor->watches[index];
+            if (watch->type == FOSSIL_EVENT_NONE || watch->gen != (uint32_t)(keys[i] >> 32))
+                continue;
+            if (watch->type == FOSSIL_EVENT_IO)
+            {
+                struct epoll_event ev = {.events = watch->epoll, .data.u64 = keys[i]};
+                epoll_ctl(reactor->epfd, EPOLL_CTL_MOD, watch->fd, &ev);
+            }
+            else if (watch->type == FOSSIL_EVENT_TIMER)
+            {
+                fossil_sys_event_source_info_t info;
+                memcpy(&info, slots[i].data.bytes, sizeof(info));
+                watch->pending += info.expirations;
+            }
+        }
+        pthread_mutex_unlock(&reactor->lock);
+    }
+    if (wheel_due)
+        done += fossil_sys_event_wheel_deliver(queue, &reactor->wheel);
+    return done;
+}
+#endif
+
+// Runs one round as the queue's source poller, sleeping for at most timeout_ms
+// (UINT64_MAX = forever) unless epoch has moved. Returns 0 without sleeping when
+// the queue has no sources or another consumer already polls them. `self` is 1
+// when the caller is counted in `waiters`.
+static int fossil_sys_event_poll_sources(fossil_sys_event_queue_t *queue, uint32_t epoch, uint64_t timeout_ms,
+                                         uint32_t self)
+{
+#if defined(EVENT_REACTOR)
+    fossil_sys_event_reactor_t *reactor = atomic_load_explicit(&queue->reactor, memory_order_acquire);
+    int idle = 0;
+    if (!reactor || !atomic_compare_exchange_strong_explicit(&reactor->polling, &idle, 1,
+                                                             memory_order_seq_cst, memory_order_relaxed))
+        return 0;
+
+    atomic_thread_fence(memory_order_seq_cst);
+    int timeout = timeout_ms == UINT64_MAX ? -1 : timeout_ms > INT_MAX ? INT_MAX : (int)timeout_ms;
+    if (atomic_load_explicit(&queue->epoch, memory_order_relaxed) != epoch)
+        timeout = 0; // a post slipped in before we announced ourselves
+
+    size_t posted = fossil_sys_event_harvest(queue, reactor, timeout);
+    atomic_store_explicit(&reactor->polling, 0, memory_order_release);
+
+    // Wake consumers for the new events, or hand the poller role to a parked one.
+    if (posted > 0 || atomic_load_explicit(&queue->waiters, memory_order_relaxed) > self)
+        fossil_sys_event_unpark(queue, posted > 0 ? posted : 1);
+    return 1;
+#else
+    (void)queue;
+    (void)epoch;
+    (void)timeout_ms;
+    (void)self;
+    return 0;
+#endif
+}
+
+static int fossil_sys_event_run_call(const fossil_sys_event_t *event);
+
+// Empties a queue that is going away. Calls still run: each one may be all
+// that resumes a suspended coroutine, and dropping it would leak the frame.
+static void fossil_sys_event_drain(fossil_sys_event_queue_t *queue)
+{
+    fossil_sys_event_t event;
+    while (fossil_sys_event_dequeue(queue, &event, 1))
+    {
+        if (!fossil_sys_event_run_call(&event))
+            fossil_sys_event_release(&event);
+    }
+}
+
+/* ------------------------------------------------------
+ * Queue Lifecycle
+ * ----------------------------------------------------- */
+fossil_sys_event_queue_t *fossil_sys_event_queue_create(size_t capacity, fossil_sys_event_queue_mode_t mode)
+{
+    return fossil_sys_event_queue_create_ex(capacity, mode, FOSSIL_SYS_EVENT_FULL_DROP_NEWEST, 0);
+}
+
+fossil_sys_event_queue_t *fossil_sys_event_queue_create_ex(size_t capacity, fossil_sys_event_queue_mode_t mode,
+                                                           fossil_sys_event_backpressure_t policy,
+                                                           uint32_t block_timeout_ms)
+{
+    if ((unsigned)policy > FOSSIL_SYS_EVENT_FULL_SPILL)
+        return NULL;
+    if (capacity == 0)
+        capacity = FOSSIL_SYS_EVENT_CAPACITY;
+    if (capacity > (SIZE_MAX >> 1) / sizeof(fossil_sys_event_cell_t))
+        return NULL;
+
+    size_t rounded = 2;
+    while (rounded < capacity)
+        rounded <<= 1;
+
+    fossil_sys_event_queue_t *queue = calloc(1, sizeof(*queue));
+    if (!queue)
+        return NULL;
+    queue->mask = rounded - 1;
+    while (queue->sample_shift < EVENT_SAMPLE_SHIFT && ((size_t)2 << queue->sample_shift) <= rounded)
+        queue->sample_shift++; // a ring shorter than the period samples once per lap
+    // Evicting makes producers consume and unspilling makes consumers produce.
+    if (policy == FOSSIL_SYS_EVENT_FULL_DROP_OLDEST)
+        mode = (fossil_sys_event_queue_mode_t)(mode & ~EVENT_SINGLE_CONSUMER);
+    else if (policy == FOSSIL_SYS_EVENT_FULL_SPILL)
+        mode = (fossil_sys_event_queue_mode_t)(mode & ~EVENT_SINGLE_PRODUCER);
+    queue->mode = mode;
+    queue->backpressure = policy;
+    queue->block_timeout_ms = block_timeout_ms;
+    if (!fossil_sys_event_lane_cells(queue, &queue->lanes[FOSSIL_SYS_EVENT_PRIORITY_NORMAL]))
+    {
+        free(queue);
+        return NULL;
+    }
+    fossil_sys_event_lock_init(&queue->routes_lock);
+    fossil_sys_event_lock_init(&queue->await_lock);
+    for (int priority = 0; priority < FOSSIL_SYS_EVENT_PRIORITY_LEVELS; priority++)
+        fossil_sys_event_lock_init(&queue->spill[priority].lock);
+#if !defined(_WIN32) && !defined(__linux__)
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->cond, NULL);
+    pthread_cond_init(&queue->space_cond, NULL);
+#endif
+    return queue;
+}
+
+// Frees callbacks still waiting for an event; they are never called.
+static void fossil_sys_event_drop_awaiters(fossil_sys_event_queue_t *queue)
+{
+    fossil_sys_event_lock(&queue->await_lock);
+    fossil_sys_event_awaiter_t *awaiter = queue->await_head;
+    queue->await_head = queue->await_tail = NULL;
+    atomic_store_explicit(&queue->awaiting, 0, memory_order_relaxed);
+    fossil_sys_event_unlock(&queue->await_lock);
+    while (awaiter)
+    {
+        fossil_sys_event_awaiter_t *next = awaiter->next;
+        free(awaiter);
+        awaiter = next;
+    }
+}
+
+void fossil_sys_event_queue_destroy(fossil_sys_event_queue_t *queue)
+{
+    if (!queue || queue == &default_queue)
+        return;
+
+    fossil_sys_event_drain(queue);
+    for (int priority = 0; priority < FOSSIL_SYS_EVENT_PRIORITY_LEVELS; priority++)
+    {
+        // Only left over if a lane's ring could never be allocated.
+        fossil_sys_event_spill_node_t *node = queue->spill[priority].head;
+        while (node)
+        {
+            fossil_sys_event_spill_node_t *next = node->next;
+            if (node->slot.storage == FOSSIL_SYS_EVENT_STORAGE_HEAP)
+                free(node->slot.data.ptr);
+            if (!node->slot.key && node->slot.storage != FOSSIL_SYS_EVENT_STORAGE_INLINE)
+                free(node->slot.data.name);
+            free(node);
+            node = next;
+        }
+        fossil_sys_event_lock_destroy(&queue->spill[priority].lock);
+    }
+#if !defined(_WIN32) && !defined(__linux__)
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->cond);
+    pthread_cond_destroy(&queue->space_cond);
+#endif
+    fossil_sys_memory_pool_destroy(atomic_load_explicit(&queue->slab, memory_order_relaxed));
+#if defined(EVENT_REACTOR)
+    fossil_sys_event_reactor_destroy(atomic_load_explicit(&queue->reactor, memory_order_relaxed));
+#endif
+    for (int priority = 0; priority < FOSSIL_SYS_EVENT_PRIORITY_LEVELS; priority++)
+        free(queue->lanes[priority].cells_raw);
+    for (size_t i = 0; i < queue->route_capacity; i++)
+        free(queue->routes[i].subscribers);
+    free(queue->routes);
+    fossil_sys_event_lock_destroy(&queue->routes_lock);
+    fossil_sys_event_drop_awaiters(queue);
+    fossil_sys_event_lock_destroy(&queue->await_lock);
+    free(queue);
+}
+
+fossil_sys_event_queue_t *fossil_sys_event_queue_default(void)
+{
+    return &default_queue;
+}
+
+size_t fossil_sys_event_queue_capacity(const fossil_sys_event_queue_t *queue)
+{
+    return queue ? queue->mask + 1 : 0;
+}
+
+int fossil_sys_event_queue_set_drain(fossil_sys_event_queue_t *queue, fossil_sys_event_drain_t policy,
+                                     const uint32_t *weights)
+{
+    static const uint32_t default_weights[FOSSIL_SYS_EVENT_PRIORITY_LEVELS] = {8, 4, 2, 1};
+    if (!queue)
+        return -1;
+    if (policy == FOSSIL_SYS_EVENT_DRAIN_STRICT)
+    {
+        atomic_store_explicit(&queue->schedule_len, 0, memory_order_relaxed);
+        return 0;
+    }
+    if (policy != FOSSIL_SYS_EVENT_DRAIN_WEIGHTED)
+        return -1;
+
+    if (!weights)
+        weights = default_weights;
+    uint32_t total = 0;
+    for (int priority = 0; priority < FOSSIL_SYS_EVENT_PRIORITY_LEVELS; priority++)
+    {
+        if (weights[priority] > EVENT_SCHEDULE_MAX)
+            return -1;
+        total += weights[priority];
+    }
+    if (total == 0 || total > EVENT_SCHEDULE_MAX)
+        return -1;
+
+    // Smooth weighted round-robin spreads each lane's turns evenly over the schedule.
+    int32_t current[FOSSIL_SYS_EVENT_PRIORITY_LEVELS] = {0};
+    atomic_store_explicit(&queue->schedule_len, 0, memory_order_relaxed);
+    for (uint32_t turn = 0; turn < total; turn++)
+    {
+        int best = 0;
+        for (int priority = 0; priority < FOSSIL_SYS_EVENT_PRIORITY_LEVELS; priority++)
+        {
+            current[priority] += (int32_t)weights[priority];
+            if (current[priority] > current[best])
+                best = priority;
+        }
+        current[best] -= (int32_t)total;
+        atomic_store_explicit(&queue->schedule[turn], (uint8_t)best, memory_order_relaxed);
+    }
+    atomic_store_explicit(&queue->schedule_len, total, memory_order_relaxed);
+    return 0;
+}
+
+/* ------------------------------------------------------
+ * Queue Statistics
+ * ----------------------------------------------------- */
+int fossil_sys_event_queue_get_stats(const fossil_sys_event_queue_t *queue, fossil_sys_event_stats_t *out)
+{
+    if (!queue || !out)
+        return -1;
+
+    fossil_sys_event_queue_t *q = (fossil_sys_event_queue_t *)queue; // atomics are loaded, never stored
+    memset(out, 0, sizeof(*out));
+    for (int i = 0; i < EVENT_STAT_STRIPES; i++)
+    {
+        out->posted += atomic_load_explicit(&q->stripes[i].posted, memory_order_relaxed);
+        out->delivered += atomic_load_explicit(&q->stripes[i].delivered, memory_order_relaxed);
+        out->dropped += atomic_load_explicit(&q->stripes[i].dropped, memory_order_relaxed);
+        out->spilled += atomic_load_explicit(&q->stripes[i].spilled, memory_order_relaxed);
+        out->blocked += atomic_load_explicit(&q->stripes[i].blocked, memory_order_relaxed);
+    }
+    for (int priority = 0; priority < FOSSIL_SYS_EVENT_PRIORITY_LEVELS; priority++)
+    {
+        size_t dequeued = atomic_load_explicit(&q->lanes[priority].dequeue_pos, memory_order_relaxed);
+        size_t enqueued = atomic_load_explicit(&q->lanes[priority].enqueue_pos, memory_order_relaxed);
+        if (enqueued > dequeued)
+            out->depth += enqueued - dequeued;
+        out->depth += atomic_load_explicit(&q->spill[priority].count, memory_order_relaxed);
+    }
+    out->high_water = atomic_load_explicit(&q->high_water, memory_order_relaxed);
+
+    uint64_t counts[EVENT_LATENCY_BUCKETS];
+    for (size_t i = 0; i < EVENT_LATENCY_BUCKETS; i++)
+    {
+        counts[i] = atomic_load_explicit(&q->latency[i], memory_order_relaxed);
+        out->latency_samples += counts[i];
+    }
+    if (out->latency_samples == 0)
+        return 0;
+
+    uint64_t min = atomic_load_explicit(&q->latency_min, memory_order_relaxed);
+    out->latency_min_ns = min ? min - 1 : 0;
+    out->latency_max_ns = atomic_load_explicit(&q->latency_max, memory_order_relaxed);
+    out->latency_mean_ns = atomic_load_explicit(&q->latency_sum, memory_order_relaxed) / out->latency_samples;
+
+    // Each percentile is the highest value of the bucket holding its rank.
+    static const uint32_t per_mille[] = {500, 900, 990, 999};
+    uint64_t *targets[] = {&out->latency_p50_ns, &out->latency_p90_ns, &out->latency_p99_ns, &out->latency_p999_ns};
+    uint64_t seen = 0;
+    size_t next = 0, bucket = 0;
+    for (; bucket < EVENT_LATENCY_BUCKETS && next < 4; bucket++)
+    {
+        seen += counts[bucket];
+        while (next < 4 && seen * 1000 >= out->latency_samples * per_mille[next])
+            *targets[next++] = fossil_sys_event_latency_value(bucket);
+    }
+    for (size_t i = 0; i < 4; i++)
+    {
+        if (*targets[i] > out->latency_max_ns)
+            *targets[i] = out->latency_max_ns;
+    }
+    return 0;
+}
+
+void fossil_sys_event_queue_reset_stats(fossil_sys_event_queue_t *queue)
+{
+    if (!queue)
+        return;
+
+    for (int i = 0; i < EVENT_STAT_STRIPES; i++)
+    {
+        atomic_store_explicit(&queue->stripes[i].posted, 0, memory_order_relaxed);
+        atomic_store_explicit(&queue->stripes[i].delivered, 0, memory_order_relaxed);
+        atomic_store_explicit(&queue->stripes[i].dropped, 0, memory_order_relaxed);
+        atomic_store_explicit(&queue->stripes[i].spilled, 0, memory_order_relaxed);
+        atomic_store_explicit(&queue->stripes[i].blocked, 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&queue->high_water, 0, memory_order_relaxed);
+    for (size_t i = 0; i < EVENT_LATENCY_BUCKETS; i++)
+        atomic_store_explicit(&queue->latency[i], 0, memory_order_relaxed);
+    atomic_store_explicit(&queue->latency_sum, 0, memory_order_relaxed);
+    atomic_store_explicit(&queue->latency_min, 0, memory_order_relaxed);
+    atomic_store_explicit(&queue->latency_max, 0, memory_order_relaxed);
+}
+
+/* ------------------------------------------------------
+ * Queue Operations
+ * ----------------------------------------------------- */
+// Fills a slot before a cell is claimed so consumers never wait on an allocator.
+// Without a key the slot carries its own copy of id, which takes the inline
+// bytes, so such payloads go to the slab instead.
+static int fossil_sys_event_slot_fill(fossil_sys_event_queue_t *queue, fossil_sys_event_slot_t *slot, uint32_t key,
+                                      const char *id, fossil_sys_event_type_t type, void *payload, size_t size,
+                                      fossil_sys_event_post_mode_t mode)
+{
+    fossil_sys_memory_pool_t *slab;
+    char *name = NULL;
+
+    if (size > UINT32_MAX)
+        return -1;
+    if (!key && id)
+    {
+        size_t length = strlen(id) + 1;
+        name = malloc(length);
+        if (!name)
+            return -1;
+        memcpy(name, id, length);
+    }
+
+    slot->key = key;
+    slot->type = (uint8_t)type;
+    slot->size = (uint32_t)size;
+    slot->storage = FOSSIL_SYS_EVENT_STORAGE_NONE;
+
+    if (!payload || size == 0)
+    {
+        slot->size = 0;
+    }
+    else if (mode == FOSSIL_SYS_EVENT_POST_MOVE)
+    {
+        slot->storage = FOSSIL_SYS_EVENT_STORAGE_HEAP;
+        slot->data.ptr = payload;
+    }
+    else if (mode == FOSSIL_SYS_EVENT_POST_INLINE && size <= FOSSIL_SYS_EVENT_INLINE_MAX && !name)
+    {
+        slot->storage = FOSSIL_SYS_EVENT_STORAGE_INLINE;
+        memcpy(slot->data.bytes, payload, size);
+    }
+    else if (mode != FOSSIL_SYS_EVENT_POST_COPY && size <= FOSSIL_SYS_EVENT_SLAB_BLOCK &&
+             (slab = fossil_sys_event_slab(queue)) != NULL &&
+             (slot->data.ptr = fossil_sys_memory_pool_alloc(slab)) != NULL)
+    {
+        slot->storage = FOSSIL_SYS_EVENT_STORAGE_SLAB;
+        memcpy(slot->data.ptr, payload, size);
+    }
+    else
+    {
+        slot->data.ptr = malloc(size);
+        if (!slot->data.ptr)
+        {
+            free(name);
+            return -1;
+        }
+        slot->storage = FOSSIL_SYS_EVENT_STORAGE_HEAP;
+        memcpy(slot->data.ptr, payload, size);
+    }
+    if (slot->storage != FOSSIL_SYS_EVENT_STORAGE_INLINE)
+        slot->data.name = name;
+    return 0;
+}
+
+// Undoes fossil_sys_event_slot_fill for a slot that never made it into the ring;
+// a moved buffer stays with the caller.
+static void fossil_sys_event_slot_discard(fossil_sys_event_queue_t *queue, fossil_sys_event_slot_t *slot,
+                                          fossil_sys_event_post_mode_t mode)
+{
+    if (slot->storage == FOSSIL_SYS_EVENT_STORAGE_SLAB)
+        fossil_sys_memory_pool_free(atomic_load_explicit(&queue->slab, memory_order_relaxed), slot->data.ptr);
+    else if (slot->storage == FOSSIL_SYS_EVENT_STORAGE_HEAP && mode != FOSSIL_SYS_EVENT_POST_MOVE)
+        free(slot->data.ptr);
+    if (!slot->key && slot->storage != FOSSIL_SYS_EVENT_STORAGE_INLINE)
+        free(slot->data.name);
+}
+
+// Publishes prepared slots to a lane under the queue's backpressure policy and
+// wakes consumers for them. Returns how many slots the queue took; the caller
+// still owns the rest.
+static size_t fossil_sys_event_push(fossil_sys_event_queue_t *queue, fossil_sys_event_priority_t priority,
+                                    const fossil_sys_event_slot_t *slots, size_t count)
+{
+    size_t done = 0, announced = 0;
+    switch (queue->backpressure)
+    {
+    case FOSSIL_SYS_EVENT_FULL_DROP_OLDEST:
+        if (!fossil_sys_event_lane_cells(queue, &queue->lanes[priority]))
+            break;
+        while ((done += fossil_sys_event_enqueue(queue, priority, slots + done, count - done)) < count)
+        {
+            // A call is never the victim: it runs here, ahead of the events
+            // posted after it, and frees its cell like a drop would.
+            fossil_sys_event_t victim;
+            if (fossil_sys_event_dequeue_lane(queue, &queue->lanes[priority], &victim, 1) &&
+                !fossil_sys_event_run_call(&victim))
+            {
+                fossil_sys_event_release(&victim);
+                fossil_sys_event_count_dropped(queue, 1);
+            }
+        }
+        break;
+
+    case FOSSIL_SYS_EVENT_FULL_BLOCK:
+    {
+        done = fossil_sys_event_enqueue(queue, priority, slots, count);
+        if (done == count)
+            break;
+        atomic_fetch_add_explicit(&fossil_sys_event_stripe(queue)->blocked, 1, memory_order_relaxed);
+        uint64_t deadline = queue->block_timeout_ms ? fossil_sys_event_now_ms() + queue->block_timeout_ms : UINT64_MAX;
+        for (;;)
+        {
+            if (done > announced)
+            {
+                fossil_sys_event_unpark(queue, done - announced); // consumers must see what fit so far
+                announced = done;
+            }
+            atomic_fetch_add_explicit(&queue->space_waiters, 1, memory_order_relaxed);
+            uint32_t epoch = atomic_load_explicit(&queue->space_epoch, memory_order_acquire);
+            atomic_thread_fence(memory_order_seq_cst);
+
+            done += fossil_sys_event_enqueue(queue, priority, slots + done, count - done);
+            uint64_t now = done == count ? 0 : fossil_sys_event_now_ms();
+            if (done < count && now < deadline)
+            {
+                uint64_t remaining = deadline == UINT64_MAX ? UINT64_MAX : deadline - now;
+                fossil_sys_event_park(queue, &queue->space_epoch, epoch, remaining);
+            }
+            atomic_fetch_sub_explicit(&queue->space_waiters, 1, memory_order_relaxed);
+            if (done == count || now >= deadline)
+                break;
+        }
+        break;
+    }
+
+    case FOSSIL_SYS_EVENT_FULL_SPILL:
+    {
+        fossil_sys_event_spill_t *spill = &queue->spill[priority];
+        if (atomic_load_explicit(&spill->count, memory_order_acquire) == 0)
+            done = fossil_sys_event_enqueue(queue, priority, slots, count);
+        if (done == count)
+            break;
+
+        // No re-check needed: appending is in order whatever happened since
+        // the ring looked full. Everything already in the ring is older, and
+        // consumers refill the ring from the list before taking from it, so
+        // these leave after both. Room freed meanwhile is used by that refill.
+        fossil_sys_event_lock(&spill->lock);
+        size_t spilled = 0;
+        for (; done < count; done++, spilled++)
+        {
+            fossil_sys_event_spill_node_t *node = malloc(sizeof(*node));
+            if (!node)
+                break;
+            node->next = NULL;
+            node->slot = slots[done];
+            if (spill->tail)
+                spill->tail->next = node;
+            else
+                spill->head = node;
+            spill->tail = node;
+        }
+        atomic_fetch_add_explicit(&spill->count, spilled, memory_order_relaxed);
+        fossil_sys_event_unlock(&spill->lock);
+        atomic_fetch_add_explicit(&fossil_sys_event_stripe(queue)->spilled, spilled, memory_order_relaxed);
+        break;
+    }
+
+    default:
+        done = fossil_sys_event_enqueue(queue, priority, slots, count);
+        break;
+    }
+    if (done > announced)
+        fossil_sys_event_unpark(queue, done - announced);
+    return done;
+}
+
+// Posts one event; with key 0 a non-NULL id travels as a private copy.
+static int fossil_sys_event_post_slot(fossil_sys_event_queue_t *queue, uint32_t key, const char *id, void *payload,
+                                      size_t size, fossil_sys_event_post_mode_t mode,
+                                      fossil_sys_event_priority_t priority)
+{
+    if (!queue || (unsigned)priority >= FOSSIL_SYS_EVENT_PRIORITY_LEVELS)
+        return -1;
+
+    fossil_sys_event_slot_t slot;
+    if (fossil_sys_event_slot_fill(queue, &slot, key, id, FOSSIL_EVENT_CUSTOM, payload, size, mode) != 0)
+        return -1;
+
+    if (fossil_sys_event_push(queue, priority, &slot, 1) != 1)
+    {
+        fossil_sys_event_slot_discard(queue, &slot, mode); // queue full
+        fossil_sys_event_count_dropped(queue, 1);
+        return -1;
+    }
+    return 0;
+}
+
+int fossil_sys_event_queue_post_ex(fossil_sys_event_queue_t *queue, const char *id, void *payload, size_t size,
+                                   fossil_sys_event_post_mode_t mode)
+{
+    return fossil_sys_event_queue_post_priority(queue, id, payload, size, mode, FOSSIL_SYS_EVENT_PRIORITY_NORMAL);
+}
+
+int fossil_sys_event_queue_post_priority(fossil_sys_event_queue_t *queue, const char *id, void *payload, size_t size,
+                                         fossil_sys_event_post_mode_t mode, fossil_sys_event_priority_t priority)
+{
+    // Only a lookup: ids that were never subscribed to or interned are copied
+    // into the event instead of being added to the process-wide table.
+    return fossil_sys_event_post_slot(queue, fossil_sys_event_find(id), id, payload, size, mode, priority);
+}
+
+int fossil_sys_event_queue_post_key(fossil_sys_event_queue_t *queue, uint32_t key, void *payload, size_t size,
+                                    fossil_sys_event_post_mode_t mode, fossil_sys_event_priority_t priority)
+{
+    if (key && !fossil_sys_event_name(key))
+        return -1;
+    return fossil_sys_event_post_slot(queue, key, NULL, payload, size, mode, priority);
+}
+
+int fossil_sys_event_queue_post_batch(fossil_sys_event_queue_t *queue, const fossil_sys_event_t *events, size_t count,
+                                      fossil_sys_event_post_mode_t mode)
+{
+    if (!queue || (!events && count > 0) || count > INT_MAX)
+        return -1;
+
+    fossil_sys_event_slot_t slots[EVENT_BATCH_CHUNK];
+    size_t posted = 0;
+    while (posted < count)
+    {
+        size_t want = count - posted;
+        if (want > EVENT_BATCH_CHUNK)
+            want = EVENT_BATCH_CHUNK;
+
+        size_t filled = 0;
+        while (filled < want)
+        {
+            const fossil_sys_event_t *event = &events[posted + filled];
+            uint32_t key = event->key ? event->key : fossil_sys_event_find(event->id); // by key skips the lookup
+            if (event->type == FOSSIL_EVENT_CALL || (key && !fossil_sys_event_name(key)) ||
+                fossil_sys_event_slot_fill(queue, &slots[filled], key, event->id, event->type, event->payload,
+                                           event->size, mode) != 0)
+                break;
+            filled++;
+        }
+
+        // One reservation publishes the whole chunk (or as much of it as fits).
+        size_t done = fossil_sys_event_push(queue, FOSSIL_SYS_EVENT_PRIORITY_NORMAL, slots, filled);
+        for (size_t i = done; i < filled; i++)
+            fossil_sys_event_slot_discard(queue, &slots[i], mode);
+        if (done < filled)
+            fossil_sys_event_count_dropped(queue, filled - done);
+        posted += done;
+        if (done < want)
+            break; // queue full or a payload could not be stored
+    }
+    return (int)posted;
+}
+
+int fossil_sys_event_queue_post(fossil_sys_event_queue_t *queue, const char *id, void *payload, size_t size)
+{
+    return fossil_sys_event_queue_post_ex(queue, id, payload, size, FOSSIL_SYS_EVENT_POST_COPY);
+}
+
+int fossil_sys_event_queue_poll(fossil_sys_event_queue_t *queue, fossil_sys_event_t *out_event)
+{
+    if (!queue || !out_event)
+        return -1;
+
+    if (fossil_sys_event_dequeue(queue, out_event, 1))
+        return 1;
+    if (fossil_sys_event_poll_sources(queue, 0, 0, 0))
+        return (int)fossil_sys_event_dequeue(queue, out_event, 1);
+    return 0; // no events
+}
+
+int fossil_sys_event_queue_poll_batch(fossil_sys_event_queue_t *queue, fossil_sys_event_t *out_events, size_t max)
+{
+    if (!queue || (!out_events && max > 0))
+        return -1;
+    if (max > INT_MAX)
+        max = INT_MAX;
+
+    size_t got = fossil_sys_event_dequeue(queue, out_events, max);
+    if (got == 0 && max > 0 && fossil_sys_event_poll_sources(queue, 0, 0, 0))
+        got = fossil_sys_event_dequeue(queue, out_events, max);
+    return (int)got;
+}
+
+// Takes one event, or with out_event == NULL only checks that one is ready.
+static int fossil_sys_event_take(fossil_sys_event_queue_t *queue, fossil_sys_event_t *out_event)
+{
+    return out_event ? (int)fossil_sys_event_dequeue(queue, out_event, 1) : fossil_sys_event_pending(queue);
+}
+
+// Waits for an event until deadline (monotonic ms, UINT64_MAX = forever).
+// With a watch word, also returns 0 once *watch no longer equals seen; whoever
+// moves it must unpark the queue afterwards.
+static int fossil_sys_event_wait_until(fossil_sys_event_queue_t *queue, fossil_sys_event_t *out_event,
+                                       uint64_t deadline, _Atomic uint32_t *watch, uint32_t seen)
+{
+    for (;;)
+    {
+        atomic_fetch_add_explicit(&queue->waiters, 1, memory_order_relaxed);
+        uint32_t epoch = atomic_load_explicit(&queue->epoch, memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+
+        int got = fossil_sys_event_take(queue, out_event);
+        int moved = !got && watch && atomic_load_explicit(watch, memory_order_relaxed) != seen;
+        uint64_t now = got || moved ? 0 : fossil_sys_event_now_ms();
+        if (!got && !moved && now < deadline)
+        {
+            uint64_t remaining = deadline == UINT64_MAX ? UINT64_MAX : deadline - now;
+            if (!fossil_sys_event_poll_sources(queue, epoch, remaining, 1))
+                fossil_sys_event_park(queue, &queue->epoch, epoch, remaining);
+        }
+        atomic_fetch_sub_explicit(&queue->waiters, 1, memory_order_relaxed);
+
+        if (got || fossil_sys_event_take(queue, out_event))
+            return 1;
+        if (moved || now >= deadline)
+            return 0; // timeout
+    }
+}
+
+int fossil_sys_event_queue_wait(fossil_sys_event_queue_t *queue, fossil_sys_event_t *out_event, uint32_t timeout_ms)
+{
+    if (!queue || !out_event)
+        return -1;
+
+    if (fossil_sys_event_dequeue(queue, out_event, 1))
+        return 1;
+
+    uint64_t deadline = timeout_ms ? fossil_sys_event_now_ms() + timeout_ms : UINT64_MAX;
+    return fossil_sys_event_wait_until(queue, out_event, deadline, NULL, 0);
+}
+
+void fossil_sys_event_release(fossil_sys_event_t *event)
+{
+    if (!event)
+        return;
+
+    if (event->storage == FOSSIL_SYS_EVENT_STORAGE_HEAP)
+        free(event->payload);
+    else if (event->storage == FOSSIL_SYS_EVENT_STORAGE_SLAB)
+        fossil_sys_memory_pool_free((fossil_sys_memory_pool_t *)event->owner, event->payload);
+    if (!event->key && event->id)
+    {
+        free((char *)event->id); // private copy of an id that was never interned
+        event->id = NULL;
+    }
+
+    event->payload = NULL;
+    event->size = 0;
+    event->storage = FOSSIL_SYS_EVENT_STORAGE_NONE;
+    event->owner = NULL;
+}
+
+/* ------------------------------------------------------
+ * Subscriptions
+ *
+ * Routes map an interned id to its subscribers through an
+ * open-addressing table, so dispatch is one hash probe on
+ * a 32-bit key. Dispatch copies the subscriber list under
+ * the shared lock and runs the handlers after dropping it,
+ * which lets handlers subscribe, unsubscribe and post.
+ * ----------------------------------------------------- */
+static fossil_sys_event_route_t *fossil_sys_event_route_find(fossil_sys_event_route_t *routes, size_t capacity,
+                                                             uint32_t key)
+{
+    if (capacity == 0)
+        return NULL;
+    size_t mask = capacity - 1;
+    for (size_t i = (key * 2654435761u) & mask;; i = (i + 1) & mask) // Knuth's multiplicative hash
+    {
+        if (routes[i].key == key || routes[i].key == 0)
+            return &routes[i];
+    }
+}
+
+int fossil_sys_event_queue_subscribe(fossil_sys_event_queue_t *queue, const char *id,
+                                     fossil_sys_event_handler_t handler, void *context)
+{
+    uint32_t key = fossil_sys_event_intern(id);
+    if (!queue || !handler || key == 0)
+        return -1;
+
+    int subscription = -1;
+    fossil_sys_event_lock(&queue->routes_lock);
+
+    // Keep the table at most half full; routes are never removed.
+    if ((queue->route_count + 1) * 2 > queue->route_capacity)
+    {
+        size_t grown = queue->route_capacity ? queue->route_capacity * 2 : 16;
+        fossil_sys_event_route_t *routes = calloc(grown, sizeof(*routes));
+        if (!routes)
+            goto done;
+        for (size_t i = 0; i < queue->route_capacity; i++)
+        {
+            if (queue->routes[i].key)
+                *fossil_sys_event_route_find(routes, grown, queue->routes[i].key) = queue->routes[i];
+        }
+        free(queue->routes);
+        queue->routes = routes;
+        queue->route_capacity = grown;
+    }
+
+    fossil_sys_event_route_t *route = fossil_sys_event_route_find(queue->routes, queue->route_capacity, key);
+    if (route->count == route->capacity)
+    {
+        uint32_t grown = route->capacity ? route->capacity * 2 : 2;
+        fossil_sys_event_subscriber_t *subscribers = realloc(route->subscribers, grown * sizeof(*subscribers));
+        if (!subscribers)
+            goto done;
+        route->subscribers = subscribers;
+        route->capacity = grown;
+    }
+    if (route->key == 0)
+    {
+        route->key = key;
+        queue->route_count++;
+    }
+    if (queue->next_subscription == INT_MAX)
+        goto done;
+    subscription = ++queue->next_subscription;
+    route->subscribers[route->count].handler = handler;
+    route->subscribers[route->count].context = context;
+    route->subscribers[route->count].subscription = subscription;
+    route->count++;
+
+done:
+    fossil_sys_event_unlock(&queue->routes_lock);
+    return subscription;
+}
+
+int fossil_sys_event_queue_unsubscribe(fossil_sys_event_queue_t *queue, int subscription)
+{
+    if (!queue || subscription <= 0)
+        return -1;
+
+    int result = -1;
+    fossil_sys_event_lock(&queue->routes_lock);
+    for (size_t i = 0; i < queue->route_capacity && result != 0; i++)
+    {
+        fossil_sys_event_route_t *route = &queue->routes[i];
+        for (uint32_t j = 0; j < route->count; j++)
+        {
+            if (route->subscribers[j].subscription != subscription)
+                continue;
+            // Shift rather than swap so the remaining handlers keep their order.
+            memmove(&route->subscribers[j], &route->subscribers[j + 1],
+                    (route->count - j - 1) * sizeof(route->subscribers[0]));
+            route->count--;
+            result = 0;
+            break;
+        }
+    }
+    fossil_sys_event_unlock(&queue->routes_lock);
+    return result;
+}
+
+int fossil_sys_event_queue_dispatch(fossil_sys_event_queue_t *queue, const fossil_sys_event_t *event)
+{
+    if (!queue || !event)
+        return -1;
+    if (fossil_sys_event_run_call(event))
+        return 1; // a call polled or waited for
+
+    fossil_sys_event_subscriber_t local[EVENT_DISPATCH_INLINE];
+    fossil_sys_event_subscriber_t *subscribers = local;
+    uint32_t count = 0;
+
+    fossil_sys_event_lock_shared(&queue->routes_lock);
+    uint32_t key = fossil_sys_event_route_key(event);
+    fossil_sys_event_route_t *route = key ? fossil_sys_event_route_find(queue->routes, queue->route_capacity, key) : NULL;
+    if (route && route->key && route->count)
+    {
+        count = route->count;
+        if (count > EVENT_DISPATCH_INLINE)
+            subscribers = malloc(count * sizeof(*subscribers));
+        if (subscribers)
+            memcpy(subscribers, route->subscribers, count * sizeof(*subscribers));
+    }
+    fossil_sys_event_unlock_shared(&queue->routes_lock);
+    if (!subscribers)
+        return -1;
+
+    for (uint32_t i = 0; i < count; i++)
+        subscribers[i].handler(event, subscribers[i].context);
+    if (subscribers != local)
+        free(subscribers);
+    return (int)count;
+}
+
+/* ------------------------------------------------------
+ * Asynchronous Consumers
+ *
+ * Waiting callbacks form a FIFO under `await_lock`, and
+ * every dequeued event goes through consume: a call runs,
+ * anything else goes to the oldest callback if there is
+ * one and to the subscribers otherwise.
+ *
+ * Calls are never lost. A drop-oldest queue runs a call
+ * it would evict, destroy and shutdown run the calls they
+ * drain, and dispatch runs one handed to it by a poll or
+ * wait consumer. A call keeps its payload inline, so
+ * there is nothing to release after it ran.
+ * ----------------------------------------------------- */
+typedef struct {
+    fossil_sys_event_call_t fn;
+    void *context;
+} fossil_sys_event_call_info_t;
+
+// Runs event if it is a call; returns 0 for any other event.
+static int fossil_sys_event_run_call(const fossil_sys_event_t *event)
+{
+    if (event->type != FOSSIL_EVENT_CALL || event->storage != FOSSIL_SYS_EVENT_STORAGE_INLINE ||
+        event->size != sizeof(fossil_sys_event_call_info_t))
+        return 0;
+
+    fossil_sys_event_call_info_t call;
+    memcpy(&call, event->inline_data, sizeof(call));
+    call.fn(call.context);
+    return 1;
+}
+
+// Runs one dequeued event and disposes of its payload.
+static void fossil_sys_event_consume(fossil_sys_event_queue_t *queue, fossil_sys_event_t *event)
+{
+    if (fossil_sys_event_run_call(event))
+        return;
+
+    if (atomic_load_explicit(&queue->awaiting, memory_order_acquire))
+    {
+        fossil_sys_event_lock(&queue->await_lock);
+        fossil_sys_event_awaiter_t *awaiter = queue->await_head;
+        if (awaiter)
+        {
+            queue->await_head = awaiter->next;
+            if (!queue->await_head)
+                queue->await_tail = NULL;
+            atomic_fetch_sub_explicit(&queue->awaiting, 1, memory_order_relaxed);
+        }
+        fossil_sys_event_unlock(&queue->await_lock);
+        if (awaiter)
+        {
+            fossil_sys_event_resume_t resume = awaiter->resume;
+            void *context = awaiter->context;
+            free(awaiter);
+            resume(event, context); // the callback owns the payload now
+            return;
+        }
+    }
+
+    fossil_sys_event_queue_dispatch(queue, event);
+    fossil_sys_event_release(event);
+}
+
+int fossil_sys_event_queue_await(fossil_sys_event_queue_t *queue, fossil_sys_event_resume_t resume, void *context)
+{
+    if (!queue || !resume)
+        return -1;
+
+    fossil_sys_event_awaiter_t *awaiter = malloc(sizeof(*awaiter));
+    if (!awaiter)
+        return -1;
+    awaiter->next = NULL;
+    awaiter->resume = resume;
+    awaiter->context = context;
+
+    fossil_sys_event_lock(&queue->await_lock);
+    if (queue->await_tail)
+        queue->await_tail->next = awaiter;
+    else
+        queue->await_head = awaiter;
+    queue->await_tail = awaiter;
+    atomic_fetch_add_explicit(&queue->awaiting, 1, memory_order_release);
+    fossil_sys_event_unlock(&queue->await_lock);
+    return 0;
+}
+
+int fossil_sys_event_queue_post_call(fossil_sys_event_queue_t *queue, fossil_sys_event_call_t fn, void *context)
+{
+    if (!queue || !fn)
+        return -1;
+
+    fossil_sys_event_call_info_t call = {fn, context};
+    fossil_sys_event_slot_t slot;
+    fossil_sys_event_slot_fill(queue, &slot, 0, NULL, FOSSIL_EVENT_CALL, &call, sizeof(call), FOSSIL_SYS_EVENT_POST_INLINE);
+    if (fossil_sys_event_push(queue, FOSSIL_SYS_EVENT_PRIORITY_NORMAL, &slot, 1) != 1)
+    {
+        fossil_sys_event_count_dropped(queue, 1);
+        return -1;
+    }
+    return 0;
+}
+
+int fossil_sys_event_queue_dispatch_pending(fossil_sys_event_queue_t *queue, size_t max)
+{
+    if (!queue)
+        return -1;
+    if (max > INT_MAX)
+        max = INT_MAX;
+
+    fossil_sys_event_t events[EVENT_BATCH_CHUNK];
+    size_t handled = 0;
+    while (handled < max)
+    {
+        size_t want = max - handled < EVENT_BATCH_CHUNK ? max - handled : EVENT_BATCH_CHUNK;
+        int got = fossil_sys_event_queue_poll_batch(queue, events, want);
+        if (got <= 0)
+            break;
+        for (int i = 0; i < got; i++)
+            fossil_sys_event_consume(queue, &events[i]);
+        handled += (size_t)got;
+    }
+    return (int)handled;
+}
+
+/* ------------------------------------------------------
+ * Dispatchers
+ *
+ * Every worker owns a Chase-Lev deque (Chase & Lev, with
+ * the C11 orderings of Le et al.). A worker whose deque is
+ * empty takes a run of events from the queue into a batch
+ * block and pushes them with one store of `bottom`; it pops
+ * from the bottom, while idle workers steal from the top of
+ * a random victim. Batches are refcounted and go back to
+ * their worker's spare slot when the last event is done.
+ *
+ * Ordered dispatch hashes each event's key to a shard, an
+ * intrusive MPSC list (Vyukov) with a count of queued
+ * events. The producer that moves the count from 0 pushes
+ * the shard itself onto its deque, so a shard is scheduled
+ * at most once and whoever holds it runs its events one at
+ * a time; stealing moves whole shards. Taking events and
+ * filing them into shards happens under `poll_lock`, which
+ * keeps each shard in queue order.
+ *
+ * Idle workers sleep on the queue itself. `signal` moves
+ * whenever work is pushed that others could steal and on
+ * shutdown, and the mover unparks the queue, so a worker
+ * never sleeps through work it could have taken.
+ * ----------------------------------------------------- */
+typedef struct fossil_sys_event_task {
+    fossil_sys_event_t event;
+    struct fossil_sys_event_batch *batch;
+    _Atomic(struct fossil_sys_event_task *) next; // shard list link
+} fossil_sys_event_task_t;
+
+typedef struct fossil_sys_event_batch {
+    _Atomic uint32_t refs; // events not yet dispatched
+    struct fossil_sys_event_worker *home;
+    fossil_sys_event_task_t tasks[EVENT_STEAL_BATCH];
+} fossil_sys_event_batch_t;
+
+typedef struct {
+    _Atomic(fossil_sys_event_task_t *) head; // producers push here
+    fossil_sys_event_task_t *tail;           // only touched by the runner
+    _Atomic uint32_t count;                  // queued events; 0 -> 1 schedules the shard
+    fossil_sys_event_task_t stub;
+} fossil_sys_event_shard_t;
+
+typedef struct fossil_sys_event_worker {
+    _Atomic int64_t top; // thieves take from here
+    char pad0[EVENT_CACHE_LINE - sizeof(int64_t)];
+    _Atomic int64_t bottom; // the owner pushes and pops here
+    char pad1[EVENT_CACHE_LINE - sizeof(int64_t)];
+    _Atomic(void *) *jobs; // tasks, or shards in ordered mode
+    int64_t mask;
+    _Atomic(fossil_sys_event_batch_t *) spare;
+    uint64_t rng;
+    struct fossil_sys_event_dispatcher *dispatcher;
+#if defined(_WIN32)
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+    int started;
+} fossil_sys_event_worker_t;
+
+struct fossil_sys_event_dispatcher {
+    fossil_sys_event_queue_t *queue;
+    fossil_sys_event_worker_t *workers;
+    size_t worker_count;
+    fossil_sys_event_shard_t *shards; // NULL for parallel dispatch
+    size_t shard_count;
+    int serial; // take events under poll_lock (ordered, or a single-consumer queue)
+    fossil_sys_event_lock_t poll_lock;
+    _Atomic uint32_t signal;
+    _Atomic int stopping;
+};
+
+static void fossil_sys_event_yield(void)
+{
+#if defined(_WIN32)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static void fossil_sys_event_deque_push(fossil_sys_event_worker_t *worker, void *const *jobs, size_t count)
+{
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed);
+    for (size_t i = 0; i < count; i++)
+        atomic_store_explicit(&worker->jobs[(bottom + (int64_t)i) & worker->mask], jobs[i], memory_order_relaxed);
+    atomic_store_explicit(&worker->bottom, bottom + (int64_t)count, memory_order_release);
+}
+
+static void *fossil_sys_event_deque_pop(fossil_sys_event_worker_t *worker)
+{
+    int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&worker->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_relaxed);
+
+    void *job = NULL;
+    if (top <= bottom)
+    {
+        job = atomic_load_explicit(&worker->jobs[bottom & worker->mask], memory_order_relaxed);
+        if (top != bottom)
+            return job;
+        // Last job: race the thieves for it.
+        if (!atomic_compare_exchange_strong_explicit(&worker->top, &top, top + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed))
+            job = NULL;
+    }
+    atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+    return job;
+}
+
+static void *fossil_sys_event_deque_steal(fossil_sys_event_worker_t *victim)
+{
+    int64_t top = atomic_load_explicit(&victim->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t bottom = atomic_load_explicit(&victim->bottom, memory_order_acquire);
+    if (top >= bottom)
+        return NULL;
+
+    void *job = atomic_load_explicit(&victim->jobs[top & victim->mask], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&victim->top, &top, top + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed))
+        return NULL; // lost to the owner or another thief
+    return job;
+}
+
+static void fossil_sys_event_batch_recycle(fossil_sys_event_batch_t *batch)
+{
+    fossil_sys_event_batch_t *empty = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&batch->home->spare, &empty, batch,
+                                                 memory_order_release, memory_order_relaxed))
+        free(batch);
+}
+
+// Moves the dispatcher's signal and wakes up to count idle workers.
+static void fossil_sys_event_dispatcher_kick(fossil_sys_event_dispatcher_t *dispatcher, size_t count)
+{
+    atomic_fetch_add_explicit(&dispatcher->signal, 1, memory_order_seq_cst);
+    fossil_sys_event_unpark(dispatcher->queue, count);
+}
+
+static void fossil_sys_event_run_task(fossil_sys_event_dispatcher_t *dispatcher, fossil_sys_event_task_t *task)
+{
+    fossil_sys_event_consume(dispatcher->queue, &task->event);
+    fossil_sys_event_batch_t *batch = task->batch;
+    if (atomic_fetch_sub_explicit(&batch->refs, 1, memory_order_acq_rel) == 1)
+        fossil_sys_event_batch_recycle(batch);
+}
+
+static void fossil_sys_event_shard_push(fossil_sys_event_shard_t *shard, fossil_sys_event_task_t *task)
+{
+    atomic_store_explicit(&task->next, NULL, memory_order_relaxed);
+    fossil_sys_event_task_t *prev = atomic_exchange_explicit(&shard->head, task, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, task, memory_order_release);
+}
+
+// Returns NULL only while a producer is between its exchange and its link.
+static fossil_sys_event_task_t *fossil_sys_event_shard_pop(fossil_sys_event_shard_t *shard)
+{
+    fossil_sys_event_task_t *tail = shard->tail;
+    fossil_sys_event_task_t *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (tail == &shard->stub)
+    {
+        if (!next)
+            return NULL;
+        shard->tail = tail = next;
+        next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    }
+    if (next)
+    {
+        shard->tail = next;
+        return tail;
+    }
+    if (tail != atomic_load_explicit(&shard->head, memory_order_acquire))
+        return NULL;
+    fossil_sys_event_shard_push(shard, &shard->stub);
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (!next)
+        return NULL;
+    shard->tail = next;
+    return tail;
+}
+
+// Runs up to a batch of a shard's events, then puts it back on our deque if
+// more are queued, so long-running ids cannot starve the others.
+static void fossil_sys_event_run_shard(fossil_sys_event_worker_t *self, fossil_sys_event_shard_t *shard)
+{
+    for (int i = 0; i < EVENT_STEAL_BATCH; i++)
+    {
+        fossil_sys_event_task_t *task;
+        while (!(task = fossil_sys_event_shard_pop(shard)))
+            fossil_sys_event_yield();
+        fossil_sys_event_run_task(self->dispatcher, task);
+        if (atomic_fetch_sub_explicit(&shard->count, 1, memory_order_acq_rel) == 1)
+            return;
+    }
+    void *job = shard;
+    fossil_sys_event_deque_push(self, &job, 1);
+    fossil_sys_event_dispatcher_kick(self->dispatcher, 1);
+}
+
+// Takes a run of events from the queue onto our deque. Returns 0 if the queue
+// had nothing.
+static int fossil_sys_event_worker_fill(fossil_sys_event_worker_t *self)
+{
+    fossil_sys_event_dispatcher_t *dispatcher = self->dispatcher;
+    fossil_sys_event_batch_t *batch = atomic_exchange_explicit(&self->spare, NULL, memory_order_acquire);
+    if (!batch && !(batch = malloc(sizeof(*batch))))
+        return 0;
+    batch->home = self;
+
+    fossil_sys_event_t events[EVENT_STEAL_BATCH];
+    void *jobs[EVENT_STEAL_BATCH];
+    size_t count = 0;
+    if (dispatcher->serial)
+        fossil_sys_event_lock(&dispatcher->poll_lock);
+    int got = fossil_sys_event_queue_poll_batch(dispatcher->queue, events, EVENT_STEAL_BATCH);
+    if (got > 0)
+    {
+        atomic_store_explicit(&batch->refs, (uint32_t)got, memory_order_relaxed);
+        for (int i = 0; i < got; i++)
+        {
+            fossil_sys_event_task_t *task = &batch->tasks[i];
+            task->event = events[i];
+            if (task->event.storage == FOSSIL_SYS_EVENT_STORAGE_INLINE)
+                task->event.payload = task->event.inline_data;
+            task->batch = batch;
+            if (!dispatcher->shards)
+            {
+                jobs[count++] = task;
+                continue;
+            }
+            uint32_t key = fossil_sys_event_route_key(&task->event);
+            fossil_sys_event_shard_t *shard = &dispatcher->shards[key % dispatcher->shard_count];
+            fossil_sys_event_shard_push(shard, task);
+            if (atomic_fetch_add_explicit(&shard->count, 1, memory_order_acq_rel) == 0)
+                jobs[count++] = shard;
+        }
+        fossil_sys_event_deque_push(self, jobs, count);
+    }
+    if (dispatcher->serial)
+        fossil_sys_event_unlock(&dispatcher->poll_lock);
+
+    if (got <= 0)
+    {
+        fossil_sys_event_batch_recycle(batch);
+        return 0;
+    }
+    if (count > 1)
+        fossil_sys_event_dispatcher_kick(dispatcher, count - 1);
+    return 1;
+}
+
+static void *fossil_sys_event_worker_steal(fossil_sys_event_worker_t *self)
+{
+    fossil_sys_event_dispatcher_t *dispatcher = self->dispatcher;
+    self->rng ^= self->rng << 13; // xorshift64
+    self->rng ^= self->rng >> 7;
+    self->rng ^= self->rng << 17;
+    size_t start = (size_t)(self->rng % dispatcher->worker_count);
+    for (size_t i = 0; i < dispatcher->worker_count; i++)
+    {
+        fossil_sys_event_worker_t *victim = &dispatcher->workers[(start + i) % dispatcher->worker_count];
+        if (victim == self)
+            continue;
+        void *job = fossil_sys_event_deque_steal(victim);
+        if (job)
+            return job;
+    }
+    return NULL;
+}
+
+static void fossil_sys_event_worker_loop(fossil_sys_event_worker_t *self)
+{
+    fossil_sys_event_dispatcher_t *dispatcher = self->dispatcher;
+    for (;;)
+    {
+        uint32_t seen = atomic_load_explicit(&dispatcher->signal, memory_order_acquire);
+        int stopping = atomic_load_explicit(&dispatcher->stopping, memory_order_acquire);
+
+        void *job = fossil_sys_event_deque_pop(self);
+        if (!job && !stopping && fossil_sys_event_worker_fill(self))
+            continue;
+        if (!job)
+            job = fossil_sys_event_worker_steal(self);
+        if (job)
+        {
+            if (dispatcher->shards)
+                fossil_sys_event_run_shard(self, (fossil_sys_event_shard_t *)job);
+            else
+                fossil_sys_event_run_task(dispatcher, (fossil_sys_event_task_t *)job);
+            continue;
+        }
+        if (stopping)
+            return; // nothing left that we took from the queue
+        fossil_sys_event_wait_until(dispatcher->queue, NULL, UINT64_MAX, &dispatcher->signal, seen);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI fossil_sys_event_worker_main(LPVOID arg)
+{
+    fossil_sys_event_worker_loop((fossil_sys_event_worker_t *)arg);
+    return 0;
+}
+#else
+static void *fossil_sys_event_worker_main(void *arg)
+{
+    fossil_sys_event_worker_loop((fossil_sys_event_worker_t *)arg);
+    return NULL;
+}
+#endif
+
+static size_t fossil_sys_event_online_cpus(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (size_t)count : 1;
+#else
+    return 1;
+#endif
+}
+
+fossil_sys_event_dispatcher_t *fossil_sys_event_dispatcher_create(fossil_sys_event_queue_t *queue, size_t workers,
+                                                                  fossil_sys_event_dispatch_order_t order)
+{
+    if (!queue || (order != FOSSIL_SYS_EVENT_DISPATCH_PARALLEL && order != FOSSIL_SYS_EVENT_DISPATCH_ORDERED))
+        return NULL;
+    if (workers == 0)
+        workers = fossil_sys_event_online_cpus();
+    if (workers > 1024)
+        return NULL;
+
+    fossil_sys_event_dispatcher_t *dispatcher = calloc(1, sizeof(*dispatcher));
+    if (!dispatcher)
+        return NULL;
+    dispatcher->queue = queue;
+    dispatcher->worker_count = workers;
+    dispatcher->serial = order == FOSSIL_SYS_EVENT_DISPATCH_ORDERED || (queue->mode & EVENT_SINGLE_CONSUMER);
+    dispatcher->workers = calloc(workers, sizeof(*dispatcher->workers));
+
+    // A deque never holds more than one batch of tasks, or every shard once.
+    size_t deque = EVENT_STEAL_BATCH;
+    if (order == FOSSIL_SYS_EVENT_DISPATCH_ORDERED)
+    {
+        dispatcher->shard_count = workers * EVENT_SHARDS_PER_WORKER;
+        dispatcher->shards = calloc(dispatcher->shard_count, sizeof(*dispatcher->shards));
+        while (deque < dispatcher->shard_count)
+            deque <<= 1;
+    }
+    if (!dispatcher->workers || (order == FOSSIL_SYS_EVENT_DISPATCH_ORDERED && !dispatcher->shards))
+    {
+        free(dispatcher->workers);
+        free(dispatcher->shards);
+        free(dispatcher);
+        return NULL;
+    }
+    for (size_t i = 0; i < dispatcher->shard_count; i++)
+    {
+        fossil_sys_event_shard_t *shard = &dispatcher->shards[i];
+        atomic_init(&shard->head, &shard->stub);
+        shard->tail = &shard->stub;
+    }
+    fossil_sys_event_lock_init(&dispatcher->poll_lock);
+
+    int failed = 0;
+    for (size_t i = 0; i < workers && !failed; i++)
+    {
+        fossil_sys_event_worker_t *worker = &dispatcher->workers[i];
+        worker->dispatcher = dispatcher;
+        worker->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+        worker->mask = (int64_t)deque - 1;
+        worker->jobs = calloc(deque, sizeof(*worker->jobs));
+        if (!worker->jobs)
+            failed = 1;
+    }
+    for (size_t i = 0; i < workers && !failed; i++)
+    {
+        fossil_sys_event_worker_t *worker = &dispatcher->workers[i];
+#if defined(_WIN32)
+        worker->thread = CreateThread(NULL, 0, fossil_sys_event_worker_main, worker, 0, NULL);
+        worker->started = worker->thread != NULL;
+#else
+        worker->started = pthread_create(&worker->thread, NULL, fossil_sys_event_worker_main, worker) == 0;
+#endif
+        failed = !worker->started;
+    }
+    if (failed)
+    {
+        fossil_sys_event_dispatcher_destroy(dispatcher);
+        return NULL;
+    }
+    return dispatcher;
+}
+
+void fossil_sys_event_dispatcher_destroy(fossil_sys_event_dispatcher_t *dispatcher)
+{
+    if (!dispatcher)
+        return;
+
+    atomic_store_explicit(&dispatcher->stopping, 1, memory_order_seq_cst);
+    fossil_sys_event_dispatcher_kick(dispatcher, dispatcher->worker_count);
+    for (size_t i = 0; i < dispatcher->worker_count; i++)
+    {
+        fossil_sys_event_worker_t *worker = &dispatcher->workers[i];
+        if (!worker->started)
+            continue;
+#if defined(_WIN32)
+        WaitForSingleObject(worker->thread, INFINITE);
+        CloseHandle(worker->thread);
+#else
+        pthread_join(worker->thread, NULL);
+#endif
+    }
+    for (size_t i = 0; i < dispatcher->worker_count; i++)
+    {
+        free(atomic_load_explicit(&dispatcher->workers[i].spare, memory_order_relaxed));
+        free(dispatcher->workers[i].jobs);
+    }
+    fossil_sys_event_lock_destroy(&dispatcher->poll_lock);
+    free(dispatcher->shards);
+    free(dispatcher->workers);
+    free(dispatcher);
+}
+
+size_t fossil_sys_event_dispatcher_workers(const fossil_sys_event_dispatcher_t *dispatcher)
+{
+    return dispatcher ? dispatcher->worker_count : 0;
+}
+
+/* ------------------------------------------------------
+ * Source Registration
+ * ----------------------------------------------------- */
+int fossil_sys_event_queue_watch_fd(fossil_sys_event_queue_t *queue, int fd, uint32_t interest, const char *id)
+{
+#if defined(EVENT_REACTOR)
+    if (!queue || fd < 0 || !(interest & (FOSSIL_SYS_EVENT_IO_READ | FOSSIL_SYS_EVENT_IO_WRITE)))
+        return -1;
+
+    uint32_t events = EPOLLET;
+    if (interest & FOSSIL_SYS_EVENT_IO_READ)
+        events |= EPOLLIN | EPOLLRDHUP;
+    if (interest & FOSSIL_SYS_EVENT_IO_WRITE)
+        events |= EPOLLOUT;
+    return fossil_sys_event_reactor_add(queue, fd, FOSSIL_EVENT_IO, events, id);
+#else
+    (void)queue;
+    (void)fd;
+    (void)interest;
+    (void)id;
+    return -1; // no reactor on this platform
+#endif
+}
+
+int fossil_sys_event_queue_add_timer(fossil_sys_event_queue_t *queue, uint32_t delay_ms, uint32_t interval_ms,
+                                     const char *id)
+{
+#if defined(EVENT_REACTOR)
+    if (!queue || (delay_ms == 0 && interval_ms == 0))
+        return -1;
+
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    uint32_t first = delay_ms ? delay_ms : interval_ms;
+    struct itimerspec spec;
+    spec.it_value.tv_sec = (time_t)(first / 1000);
+    spec.it_value.tv_nsec = (long)(first % 1000) * 1000000L;
+    spec.it_interval.tv_sec = (time_t)(interval_ms / 1000);
+    spec.it_interval.tv_nsec = (long)(interval_ms % 1000) * 1000000L;
+
+    int source = -1;
+    if (timerfd_settime(fd, 0, &spec, NULL) != 0 ||
+        (source = fossil_sys_event_reactor_add(queue, fd, FOSSIL_EVENT_TIMER, EPOLLIN, id)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return source;
+#else
+    (void)queue;
+    (void)delay_ms;
+    (void)interval_ms;
+    (void)id;
+    return -1;
+#endif
+}
+
+int fossil_sys_event_queue_add_signal(fossil_sys_event_queue_t *queue, int signo, const char *id)
+{
+#if defined(EVENT_REACTOR)
+    sigset_t mask;
+    sigemptyset(&mask);
+    if (!queue || signo <= 0 || sigaddset(&mask, signo) != 0)
+        return -1;
+
+    // signalfd only sees signals that are blocked; threads created later inherit the mask
+    if (pthread_sigmask(SIG_BLOCK, &mask, NULL) != 0)
+        return -1;
+    int fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    int source = fossil_sys_event_reactor_add(queue, fd, FOSSIL_EVENT_SIGNAL, EPOLLIN, id);
+    if (source < 0)
+        close(fd);
+    return source;
+#else
+    (void)queue;
+    (void)signo;
+    (void)id;
+    return -1;
+#endif
+}
+
+int fossil_sys_event_queue_remove_source(fossil_sys_event_queue_t *queue, int source)
+{
+#if defined(EVENT_REACTOR)
+    fossil_sys_event_reactor_t *reactor = queue ? atomic_load_explicit(&queue->reactor, memory_order_acquire) : NULL;
+    if (!reactor || source <= 0)
+        return -1;
+
+    pthread_mutex_lock(&reactor->lock);
+    size_t index = (size_t)source - 1;
+    if (index >= reactor->count || reactor->watches[index].type == FOSSIL_EVENT_NONE)
+    {
+        pthread_mutex_unlock(&reactor->lock);
+        return -1;
+    }
+    fossil_sys_event_watch_t *watch = &reactor->watches[index];
+    epoll_ctl(reactor->epfd, EPOLL_CTL_DEL, watch->fd, NULL);
+    if (watch->type != FOSSIL_EVENT_IO)
+        close(watch->fd); // the caller keeps ownership of watched descriptors
+    watch->type = FOSSIL_EVENT_NONE;
+    watch->gen++;
+    pthread_mutex_unlock(&reactor->lock);
+    return 0;
+#else
+    (void)queue;
+    (void)source;
+    return -1;
+#endif
+}
+
+/* ------------------------------------------------------
+ * Timeouts
+ * ----------------------------------------------------- */
+fossil_sys_event_timeout_t fossil_sys_event_queue_arm_timeout(fossil_sys_event_queue_t *queue, uint32_t delay_ms,
+                                                              const char *id, void *context)
+{
+#if defined(EVENT_REACTOR)
+    uint32_t key;
+    fossil_sys_event_reactor_t *reactor = queue ? fossil_sys_event_reactor(queue) : NULL;
+    if (!reactor || fossil_sys_event_key(id, &key) != 0)
+        return 0;
+
+    fossil_sys_event_wheel_t *wheel = &reactor->wheel;
+    uint64_t now = fossil_sys_event_now_ms();
+    pthread_mutex_lock(&wheel->lock);
+    if (wheel->fd < 0)
+    {
+        int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        struct epoll_event ev = {.events = EPOLLIN, .data.u64 = EVENT_WHEEL_TOKEN};
+        if (fd < 0 || epoll_ctl(reactor->epfd, EPOLL_CTL_ADD, fd, &ev) != 0)
+        {
+            if (fd >= 0)
+                close(fd);
+            pthread_mutex_unlock(&wheel->lock);
+            return 0;
+        }
+        wheel->fd = fd;
+        wheel->now = now;
+    }
+
+    if (wheel->free_head == EVENT_WHEEL_NIL)
+    {
+        uint32_t grown = wheel->capacity ? wheel->capacity * 2 : 64;
+        fossil_sys_event_timeout_node_t *nodes =
+            grown <= INT32_MAX ? realloc(wheel->nodes, (size_t)grown * sizeof(*nodes)) : NULL;
+        if (!nodes)
+        {
+            pthread_mutex_unlock(&wheel->lock);
+            return 0;
+        }
+        for (uint32_t i = grown; i-- > wheel->capacity;)
+        {
+            nodes[i].gen = 1;
+            nodes[i].bucket = EVENT_WHEEL_NIL;
+            nodes[i].next = wheel->free_head;
+            wheel->free_head = i;
+        }
+        wheel->nodes = nodes;
+        wheel->capacity = grown;
+    }
+
+    // An idle wheel jumps straight to the present instead of replaying empty ticks.
+    size_t armed = 0;
+    for (unsigned level = 0; level < EVENT_WHEEL_LEVELS; level++)
+        armed += wheel->level_count[level];
+    if (armed == 0 && wheel->heads[EVENT_WHEEL_OVERDUE] == EVENT_WHEEL_NIL && wheel->now < now)
+        wheel->now = now;
+
+    uint32_t index = wheel->free_head;
+    fossil_sys_event_timeout_node_t *node = &wheel->nodes[index];
+    wheel->free_head = node->next;
+    node->expires = now + delay_ms;
+    node->key = key;
+    node->context = context;
+    fossil_sys_event_wheel_place(wheel, index);
+    if (node->expires < wheel->deadline)
+        fossil_sys_event_wheel_program(wheel);
+    fossil_sys_event_timeout_t timeout = (uint64_t)node->gen << 32 | (index + 1);
+    pthread_mutex_unlock(&wheel->lock);
+    return timeout;
+#else
+    (void)queue;
+    (void)delay_ms;
+    (void)id;
+    (void)context;
+    return 0;
+#endif
+}
+
+int fossil_sys_event_queue_cancel_timeout(fossil_sys_event_queue_t *queue, fossil_sys_event_timeout_t timeout)
+{
+#if defined(EVENT_REACTOR)
+    fossil_sys_event_reactor_t *reactor = queue ? atomic_load_explicit(&queue->reactor, memory_order_acquire) : NULL;
+    if (!reactor)
+        return -1;
+
+    fossil_sys_event_wheel_t *wheel = &reactor->wheel;
+    pthread_mutex_lock(&wheel->lock);
+    uint32_t index = fossil_sys_event_wheel_find(wheel, timeout);
+    if (index != EVENT_WHEEL_NIL)
+    {
+        // The timerfd is left alone; a wakeup for a cancelled timeout finds nothing to do.
+        fossil_sys_event_wheel_unlink(wheel, index);
+        fossil_sys_event_wheel_release(wheel, index);
+    }
+    pthread_mutex_unlock(&wheel->lock);
+    return index != EVENT_WHEEL_NIL ? 0 : -1;
+#else
+    (void)queue;
+    (void)timeout;
+    return -1;
+#endif
+}
+
+int fossil_sys_event_queue_reschedule_timeout(fossil_sys_event_queue_t *queue, fossil_sys_event_timeout_t timeout,
+                                              uint32_t delay_ms)
+{
+#if defined(EVENT_REACTOR)
+    fossil_sys_event_reactor_t *reactor = queue ? atomic_load_explicit(&queue->reactor, memory_order_acquire) : NULL;
+    if (!reactor)
+        return -1;
+
+    fossil_sys_event_wheel_t *wheel = &reactor->wheel;
+    uint64_t now = fossil_sys_event_now_ms();
+    pthread_mutex_lock(&wheel->lock);
+    uint32_t index = fossil_sys_event_wheel_find(wheel, timeout);
+    if (index != EVENT_WHEEL_NIL)
+    {
+        fossil_sys_event_wheel_unlink(wheel, index);
+        wheel->nodes[index].expires = now + delay_ms;
+        fossil_sys_event_wheel_place(wheel, index);
+        if (wheel->nodes[index].expires < wheel->deadline)
+            fossil_sys_event_wheel_program(wheel);
+    }
+    pthread_mutex_unlock(&wheel->lock);
+    return index != EVENT_WHEEL_NIL ? 0 : -1;
+#else
+    (void)queue;
+    (void)timeout;
+    (void)delay_ms;
+    return -1;
+#endif
+}
+
+/* ------------------------------------------------------
+ * Initialization
+ * ----------------------------------------------------- */
+int fossil_sys_event_init(void)
+{
+    fossil_sys_event_drain(&default_queue); // start from an empty queue
+    return 0;
+}
+
+/* ------------------------------------------------------
+ * Poll events (non-blocking)
+ * ----------------------------------------------------- */
+int fossil_sys_event_poll(fossil_sys_event_t *out_event)
+{
+    return fossil_sys_event_queue_poll(&default_queue, out_event);
+}
+
+int fossil_sys_event_poll_batch(fossil_sys_event_t *out_events, size_t max)
+{
+    return fossil_sys_event_queue_poll_batch(&default_queue, out_events, max);
+}
+
+/* ------------------------------------------------------
+ * Wait for next event (blocking with timeout)
+ * ----------------------------------------------------- */
+int fossil_sys_event_wait(fossil_sys_event_t *out_event, uint32_t timeout_ms)
+{
+    return fossil_sys_event_queue_wait(&default_queue, out_event, timeout_ms);
+}
+
+/* ------------------------------------------------------
+ * Post a custom event
+ * ----------------------------------------------------- */
+int fossil_sys_event_post(const char *id, void *payload, size_t size)
+{
+    return fossil_sys_event_queue_post(&default_queue, id, payload, size);
+}
+
+int fossil_sys_event_post_ex(const char *id, void *payload, size_t size, fossil_sys_event_post_mode_t mode)
+{
+    return fossil_sys_event_queue_post_ex(&default_queue, id, payload, size, mode);
+}
+
+int fossil_sys_event_post_priority(const char *id, void *payload, size_t size, fossil_sys_event_post_mode_t mode,
+                                   fossil_sys_event_priority_t priority)
+{
+    return fossil_sys_event_queue_post_priority(&default_queue, id, payload, size, mode, priority);
+}
+
+int fossil_sys_event_set_drain(fossil_sys_event_drain_t policy, const uint32_t *weights)
+{
+    return fossil_sys_event_queue_set_drain(&default_queue, policy, weights);
+}
+
+int fossil_sys_event_post_key(uint32_t key, void *payload, size_t size, fossil_sys_event_post_mode_t mode,
+                              fossil_sys_event_priority_t priority)
+{
+    return fossil_sys_event_queue_post_key(&default_queue, key, payload, size, mode, priority);
+}
+
+/* ------------------------------------------------------
+ * Subscribe and dispatch
+ * ----------------------------------------------------- */
+int fossil_sys_event_subscribe(const char *id, fossil_sys_event_handler_t handler, void *context)
+{
+    return fossil_sys_event_queue_subscribe(&default_queue, id, handler, context);
+}
+
+int fossil_sys_event_unsubscribe(int subscription)
+{
+    return fossil_sys_event_queue_unsubscribe(&default_queue, subscription);
+}
+
+int fossil_sys_event_dispatch(const fossil_sys_event_t *event)
+{
+    return fossil_sys_event_queue_dispatch(&default_queue, event);
+}
+
+int fossil_sys_event_dispatch_pending(size_t max)
+{
+    return fossil_sys_event_queue_dispatch_pending(&default_queue, max);
+}
+
+/* ------------------------------------------------------
+ * Register event sources
+ * ----------------------------------------------------- */
+int fossil_sys_event_watch_fd(int fd, uint32_t interest, const char *id)
+{
+    return fossil_sys_event_queue_watch_fd(&default_queue, fd, interest, id);
+}
+
+int fossil_sys_event_add_timer(uint32_t delay_ms, uint32_t interval_ms, const char *id)
+{
+    return fossil_sys_event_queue_add_timer(&default_queue, delay_ms, interval_ms, id);
+}
+
+int fossil_sys_event_add_signal(int signo, const char *id)
+{
+    return fossil_sys_event_queue_add_signal(&default_queue, signo, id);
+}
+
+int fossil_sys_event_remove_source(int source)
+{
+    return fossil_sys_event_queue_remove_source(&default_queue, source);
+}
+
+fossil_sys_event_timeout_t fossil_sys_event_arm_timeout(uint32_t delay_ms, const char *id, void *context)
+{
+    return fossil_sys_event_queue_arm_timeout(&default_queue, delay_ms, id, context);
+}
+
+int fossil_sys_event_cancel_timeout(fossil_sys_event_timeout_t timeout)
+{
+    return fossil_sys_event_queue_cancel_timeout(&default_queue, timeout);
+}
+
+int fossil_sys_event_reschedule_timeout(fossil_sys_event_timeout_t timeout, uint32_t delay_ms)
+{
+    return fossil_sys_event_queue_reschedule_timeout(&default_queue, timeout, delay_ms);
+}
+
+int fossil_sys_event_post_batch(const fossil_sys_event_t *events, size_t count)
+{
+    return fossil_sys_event_queue_post_batch(&default_queue, events, count, FOSSIL_SYS_EVENT_POST_COPY);
+}
+
+/* ------------------------------------------------------
+ * Statistics
+ * ----------------------------------------------------- */
+int fossil_sys_event_get_stats(fossil_sys_event_stats_t *out)
+{
+    return fossil_sys_event_queue_get_stats(&default_queue, out);
+}
+
+void fossil_sys_event_reset_stats(void)
+{
+    fossil_sys_event_queue_reset_stats(&default_queue);
+}
+
+/* ------------------------------------------------------
+ * Asynchronous Consumers
+ * ----------------------------------------------------- */
+int fossil_sys_event_await(fossil_sys_event_resume_t resume, void *context)
+{
+    return fossil_sys_event_queue_await(&default_queue, resume, context);
+}
+
+int fossil_sys_event_post_call(fossil_sys_event_call_t fn, void *context)
+{
+    return fossil_sys_event_queue_post_call(&default_queue, fn, context);
+}
+
+/* ------------------------------------------------------
+ * Shutdown
+ * ----------------------------------------------------- */
+void fossil_sys_event_shutdown(void)
+{
+    // Free any allocated payloads and close the sources
+    fossil_sys_event_drain(&default_queue);
+    fossil_sys_event_drop_awaiters(&default_queue);
+#if defined(EVENT_REACTOR)
+    fossil_sys_event_reactor_destroy(atomic_exchange_explicit(&default_queue.reactor, NULL, memory_order_acq_rel));
+#endif
 }
@@ -32,6 +32,14 @@
 extern "C" {
 #endif
 
+/* ------------------------------------------------------
+ * Queue Capacity
+ *
+ * The event queue is a bounded lock-free ring; posting to
+ * a full queue fails. Must be a power of two.
+ * ----------------------------------------------------- */
+#define FOSSIL_SYS_EVENT_CAPACITY 4096
+
 /* ------------------------------------------------------
  * Event Types
  * ----------------------------------------------------- */
@@ -40,21 +48,626 @@ typedef enum {
     FOSSIL_EVENT_IO,
     FOSSIL_EVENT_TIMER,
     FOSSIL_EVENT_SIGNAL,
-    FOSSIL_EVENT_CUSTOM
+    FOSSIL_EVENT_CUSTOM,
+    FOSSIL_EVENT_CALL // posted by fossil_sys_event_queue_post_call, run instead of dispatched
 } fossil_sys_event_type_t;
 
+/* ------------------------------------------------------
+ * Payload Storage
+ * ----------------------------------------------------- */
+#define FOSSIL_SYS_EVENT_INLINE_MAX 40  // largest payload carried inside the queue cell
+#define FOSSIL_SYS_EVENT_SLAB_BLOCK 256 // largest payload drawn from a queue's slab
+
+/**
+ * How an event payload is posted.
+ */
+typedef enum {
+    FOSSIL_SYS_EVENT_POST_COPY,   // copy into a malloc'd buffer (plain post)
+    FOSSIL_SYS_EVENT_POST_INLINE, // copy into the queue cell if it fits and the id is interned, else as SLAB
+    FOSSIL_SYS_EVENT_POST_SLAB,   // copy into a block of the queue's slab if it fits, else as COPY
+    FOSSIL_SYS_EVENT_POST_MOVE    // take ownership of a malloc'd buffer without copying
+} fossil_sys_event_post_mode_t;
+
+/**
+ * Where a received event's payload lives; fossil_sys_event_release
+ * uses it to give the payload back.
+ */
+typedef enum {
+    FOSSIL_SYS_EVENT_STORAGE_NONE,
+    FOSSIL_SYS_EVENT_STORAGE_HEAP,   // malloc'd; free() also works
+    FOSSIL_SYS_EVENT_STORAGE_INLINE, // inside the event's inline_data
+    FOSSIL_SYS_EVENT_STORAGE_SLAB    // block of the queue's slab
+} fossil_sys_event_storage_t;
+
+/* ------------------------------------------------------
+ * Priority Lanes
+ *
+ * Every queue has one ring per priority level. Posts pick
+ * a lane (NORMAL unless stated); poll and wait drain the
+ * lanes by the queue's drain policy, so control events
+ * are not stuck behind a backlog of data events.
+ * ----------------------------------------------------- */
+#define FOSSIL_SYS_EVENT_PRIORITY_LEVELS 4
+
+typedef enum {
+    FOSSIL_SYS_EVENT_PRIORITY_CRITICAL = 0, // control plane: shutdown, reload
+    FOSSIL_SYS_EVENT_PRIORITY_HIGH = 1,
+    FOSSIL_SYS_EVENT_PRIORITY_NORMAL = 2,   // plain posts, batches and event sources
+    FOSSIL_SYS_EVENT_PRIORITY_LOW = 3
+} fossil_sys_event_priority_t;
+
+typedef enum {
+    FOSSIL_SYS_EVENT_DRAIN_STRICT,  // always the most urgent non-empty lane (default)
+    FOSSIL_SYS_EVENT_DRAIN_WEIGHTED // lanes take turns in proportion to their weights
+} fossil_sys_event_drain_t;
+
 /* ------------------------------------------------------
  * Event Structure
  * ----------------------------------------------------- */
 typedef struct {
-    const char* id;                // string ID for AI/tracking
+    const char* id;                // string ID; interned ids live for the process, others are a copy freed by release
+    uint32_t key;                  // interned key of id (0 = no id, or id was never interned)
     fossil_sys_event_type_t type;
-    void* payload;                 // user-defined data
+    void* payload;                 // user-defined data; points at inline_data for inline payloads
     size_t size;                   // payload size
+    fossil_sys_event_storage_t storage;
+    void* owner;                   // slab a slab payload belongs to
+    uint64_t inline_data[FOSSIL_SYS_EVENT_INLINE_MAX / sizeof(uint64_t)];
 } fossil_sys_event_t;
 
+/* ------------------------------------------------------
+ * Subscribers
+ *
+ * A handler subscribed to an id runs for every dispatched
+ * event carrying that id, in subscription order. The event
+ * is only valid for the duration of the call.
+ * ----------------------------------------------------- */
+typedef void (*fossil_sys_event_handler_t)(const fossil_sys_event_t* event, void* context);
+
+/* ------------------------------------------------------
+ * Event Sources
+ *
+ * Descriptors, timers and signals registered with a queue
+ * deliver FOSSIL_EVENT_IO, FOSSIL_EVENT_TIMER and
+ * FOSSIL_EVENT_SIGNAL events through the same poll and wait
+ * calls as posted events. Their payload is an inline
+ * fossil_sys_event_source_info_t. Linux only (epoll,
+ * timerfd, signalfd); registration fails elsewhere.
+ * ----------------------------------------------------- */
+#define FOSSIL_SYS_EVENT_IO_READ   0x1u // descriptor is readable
+#define FOSSIL_SYS_EVENT_IO_WRITE  0x2u // descriptor is writable
+#define FOSSIL_SYS_EVENT_IO_HANGUP 0x4u // peer closed (reported only)
+#define FOSSIL_SYS_EVENT_IO_ERROR  0x8u // error condition (reported only)
+
+typedef struct {
+    int source;           // handle returned when the source was registered
+    int fd;               // watched descriptor, or the source's own timer/signal descriptor
+    uint32_t events;      // FOSSIL_SYS_EVENT_IO_* flags that fired (IO)
+    int signo;            // signal received (SIGNAL)
+    uint64_t expirations; // timer expirations covered by this event (TIMER)
+    uint64_t timeout;     // timeout that expired, 0 for other sources (TIMER)
+    void* context;        // context given when the timeout was armed (TIMER)
+} fossil_sys_event_source_info_t;
+
+/**
+ * Handle of a one-shot timeout armed on a queue's timer wheel; 0 is
+ * never a valid handle. Handles are not reused while their timeout
+ * is pending, so a stale handle is simply rejected.
+ */
+typedef uint64_t fossil_sys_event_timeout_t;
+
+/* ------------------------------------------------------
+ * Event Queues
+ * ----------------------------------------------------- */
+
+/**
+ * Which sides of a queue may be used from several threads.
+ * A side declared single-threaded skips its atomic claim;
+ * using it from more than one thread at a time is undefined.
+ */
+typedef enum {
+    FOSSIL_SYS_EVENT_QUEUE_MPMC = 0, // any producers, any consumers
+    FOSSIL_SYS_EVENT_QUEUE_SPMC = 1, // one producer thread
+    FOSSIL_SYS_EVENT_QUEUE_MPSC = 2, // one consumer thread
+    FOSSIL_SYS_EVENT_QUEUE_SPSC = 3  // one of each
+} fossil_sys_event_queue_mode_t;
+
+/**
+ * What a post does when its lane is full. Event sources are not
+ * affected: they keep their own carry-over (see add_timer).
+ */
+typedef enum {
+    FOSSIL_SYS_EVENT_FULL_DROP_NEWEST = 0, // refuse the post (default)
+    FOSSIL_SYS_EVENT_FULL_DROP_OLDEST = 1, // discard the lane's oldest event to make room; calls run instead
+    FOSSIL_SYS_EVENT_FULL_BLOCK = 2,       // wait for room, up to the queue's block timeout
+    FOSSIL_SYS_EVENT_FULL_SPILL = 3        // queue the event on an unbounded overflow list
+} fossil_sys_event_backpressure_t;
+
+/**
+ * Opaque handle to an independent bounded event queue.
+ */
+typedef struct fossil_sys_event_queue fossil_sys_event_queue_t;
+
+/**
+ * Create an event queue.
+ * 
+ * @param capacity Maximum queued events per priority lane, rounded up to a power of two (0 = FOSSIL_SYS_EVENT_CAPACITY)
+ * @param mode Threading mode of the producer and consumer sides
+ * @return New queue, or NULL on failure
+ */
+fossil_sys_event_queue_t* fossil_sys_event_queue_create(size_t capacity, fossil_sys_event_queue_mode_t mode);
+
+/**
+ * Create an event queue with a policy for full lanes.
+ * Drop-oldest evicts from the producer side, so the consumer
+ * side always claims with a CAS, whatever the mode; spilling
+ * refills the ring from the consumer side, so the producer
+ * side does. Spilled events reach the ring in posting order.
+ * 
+ * @param capacity Maximum queued events per priority lane (0 = FOSSIL_SYS_EVENT_CAPACITY)
+ * @param mode Threading mode of the producer and consumer sides
+ * @param policy What a post does when its lane is full
+ * @param block_timeout_ms Longest a blocked post waits (0 = infinite); ignored by other policies
+ * @return New queue, or NULL on failure
+ */
+fossil_sys_event_queue_t* fossil_sys_event_queue_create_ex(size_t capacity, fossil_sys_event_queue_mode_t mode,
+                                                           fossil_sys_event_backpressure_t policy,
+                                                           uint32_t block_timeout_ms);
+
+/**
+ * Destroy an event queue, freeing the payloads of any events still queued.
+ * No thread may be using the queue. The default queue cannot be destroyed.
+ * 
+ * @param queue Queue to destroy (can be NULL)
+ */
+void fossil_sys_event_queue_destroy(fossil_sys_event_queue_t* queue);
+
+/**
+ * Get the process-wide default queue used by the fossil_sys_event_* functions.
+ * 
+ * @return The default queue
+ */
+fossil_sys_event_queue_t* fossil_sys_event_queue_default(void);
+
+/**
+ * Get the capacity of a queue.
+ * 
+ * @param queue Queue to inspect
+ * @return Maximum number of queued events per priority lane, 0 if queue is NULL
+ */
+size_t fossil_sys_event_queue_capacity(const fossil_sys_event_queue_t* queue);
+
+/**
+ * Choose how poll and wait drain the priority lanes.
+ * Weighted draining gives each lane weights[i] turns out of
+ * sum(weights), interleaved; a turn that finds its lane empty
+ * falls back to strict order. A zero weight only gets leftover
+ * turns. Safe to change while the queue is in use.
+ * 
+ * @param queue Queue to configure
+ * @param policy Strict or weighted draining
+ * @param weights FOSSIL_SYS_EVENT_PRIORITY_LEVELS weights summing to at most 64
+ *                (NULL = 8, 4, 2, 1); ignored for strict draining
+ * @return 0 on success, negative on invalid arguments
+ */
+int fossil_sys_event_queue_set_drain(fossil_sys_event_queue_t* queue, fossil_sys_event_drain_t policy,
+                                     const uint32_t* weights);
+
+/**
+ * Post a custom event to a queue. The payload is copied.
+ * Posting does not intern id: an id that was never subscribed to
+ * or interned is copied into the event (key 0) and freed when the
+ * event is released, so one-off ids cost nothing after delivery.
+ * Interned ids are kept for the life of the process.
+ * 
+ * @param queue Target queue
+ * @param id String identifier for the event
+ * @param payload User-defined data (can be NULL)
+ * @param size Size of payload in bytes
+ * @return 0 on success, negative on failure (including a full queue the policy gave up on)
+ */
+int fossil_sys_event_queue_post(fossil_sys_event_queue_t* queue, const char* id, void* payload, size_t size);
+
+/**
+ * Post an event choosing how its payload is stored.
+ * Inline and slab payloads avoid malloc/free entirely; a moved
+ * buffer is handed over without copying and is released with
+ * free(). If the post fails a moved buffer still belongs to the
+ * caller. Payloads must be smaller than 4 GiB.
+ * 
+ * @param queue Target queue
+ * @param id String identifier for the event
+ * @param payload User-defined data (can be NULL)
+ * @param size Size of payload in bytes
+ * @param mode Payload storage mode
+ * @return 0 on success, negative on failure (including a full queue)
+ */
+int fossil_sys_event_queue_post_ex(fossil_sys_event_queue_t* queue, const char* id, void* payload, size_t size,
+                                   fossil_sys_event_post_mode_t mode);
+
+/**
+ * Post an event to a priority lane. Each lane has its own ring,
+ * so a full NORMAL lane does not block CRITICAL posts.
+ * 
+ * @param queue Target queue
+ * @param id String identifier for the event
+ * @param payload User-defined data (can be NULL)
+ * @param size Size of payload in bytes
+ * @param mode Payload storage mode
+ * @param priority Lane to post to
+ * @return 0 on success, negative on failure (including a full lane)
+ */
+int fossil_sys_event_queue_post_priority(fossil_sys_event_queue_t* queue, const char* id, void* payload, size_t size,
+                                         fossil_sys_event_post_mode_t mode, fossil_sys_event_priority_t priority);
+
+/**
+ * Post an event by interned key, skipping the string lookup.
+ * 
+ * @param queue Queue to post to
+ * @param key Key returned by fossil_sys_event_intern (0 = no id)
+ * @param payload User-defined data (can be NULL)
+ * @param size Size of payload in bytes
+ * @param mode Payload storage mode
+ * @param priority Lane to post to
+ * @return 0 on success, negative on failure (including an unknown key)
+ */
+int fossil_sys_event_queue_post_key(fossil_sys_event_queue_t* queue, uint32_t key, void* payload, size_t size,
+                                    fossil_sys_event_post_mode_t mode, fossil_sys_event_priority_t priority);
+
+/**
+ * Subscribe a handler to an event id on a queue.
+ * 
+ * @param queue Queue whose dispatch calls run the handler
+ * @param id String identifier to subscribe to
+ * @param handler Function called for each matching event
+ * @param context User pointer passed to the handler
+ * @return Subscription handle (> 0) on success, negative on failure
+ */
+int fossil_sys_event_queue_subscribe(fossil_sys_event_queue_t* queue, const char* id,
+                                     fossil_sys_event_handler_t handler, void* context);
+
+/**
+ * Remove a subscription. A dispatch already in progress may still
+ * run the handler once.
+ * 
+ * @param queue Queue the subscription was made on
+ * @param subscription Handle returned by subscribe
+ * @return 0 on success, negative if the subscription is unknown
+ */
+int fossil_sys_event_queue_unsubscribe(fossil_sys_event_queue_t* queue, int subscription);
+
+/**
+ * Run every handler subscribed to an event's key. Handlers may
+ * post, subscribe and unsubscribe. The event is not released.
+ * A FOSSIL_EVENT_CALL event runs its call instead.
+ * 
+ * @param queue Queue holding the subscriptions
+ * @param event Event to dispatch
+ * @return Number of handlers run, negative on failure
+ */
+int fossil_sys_event_queue_dispatch(fossil_sys_event_queue_t* queue, const fossil_sys_event_t* event);
+
+/**
+ * Poll up to max events, dispatch each one and release it.
+ * Does not block.
+ * 
+ * @param queue Queue to drain
+ * @param max Maximum number of events to handle
+ * @return Number of events handled, negative on failure
+ */
+int fossil_sys_event_queue_dispatch_pending(fossil_sys_event_queue_t* queue, size_t max);
+
+/**
+ * Post a run of events to a queue with a single reservation.
+ * Each entry supplies id, type, payload and size; the remaining
+ * fields are ignored. Payloads are stored as in post_ex. Events are
+ * published in order; if the queue fills up and its policy gives
+ * up, the leading events that fit are posted and the rest are left
+ * to the caller (moved buffers of unposted events still belong to
+ * the caller).
+ * 
+ * @param queue Target queue
+ * @param events Events to post
+ * @param count Number of events
+ * @param mode Payload storage mode applied to every event
+ * @return Number of events posted, negative on error
+ */
+int fossil_sys_event_queue_post_batch(fossil_sys_event_queue_t* queue, const fossil_sys_event_t* events, size_t count,
+                                      fossil_sys_event_post_mode_t mode);
+
+/**
+ * Release the payload of a received event, whatever its storage,
+ * and the copy of its id if that id was never interned (key 0).
+ * Slab payloads must be released before their queue is destroyed.
+ * Payloads posted with plain post may still be freed with free(),
+ * but then the event's id copy leaks unless its id was interned.
+ * 
+ * @param event Event returned by a poll or wait (can be NULL)
+ */
+void fossil_sys_event_release(fossil_sys_event_t* event);
+
+/**
+ * Poll a queue without blocking.
+ * 
+ * @param queue Source queue
+ * @param out_event Pointer to event structure to fill with event data
+ * @return 1 if event was retrieved, 0 if no event available, negative on error
+ */
+int fossil_sys_event_queue_poll(fossil_sys_event_queue_t* queue, fossil_sys_event_t* out_event);
+
+/**
+ * Poll up to max events from a queue without blocking, consuming
+ * the whole run with a single reservation.
+ * Each returned event must be released as with poll.
+ * 
+ * @param queue Source queue
+ * @param out_events Array receiving at least max events
+ * @param max Maximum number of events to retrieve
+ * @return Number of events retrieved (0 if none), negative on error
+ */
+int fossil_sys_event_queue_poll_batch(fossil_sys_event_queue_t* queue, fossil_sys_event_t* out_events, size_t max);
+
+/**
+ * Wait for the next event on a queue, sleeping until one is posted.
+ * 
+ * @param queue Source queue
+ * @param out_event Pointer to event structure to fill with event data
+ * @param timeout_ms Maximum time to wait in milliseconds (0 = infinite)
+ * @return 1 if event was retrieved, 0 on timeout, negative on error
+ */
+int fossil_sys_event_queue_wait(fossil_sys_event_queue_t* queue, fossil_sys_event_t* out_event, uint32_t timeout_ms);
+
+/**
+ * Watch a descriptor for readiness. Readiness is edge-triggered:
+ * an event is delivered each time the descriptor becomes ready, so
+ * read or write until it would block before waiting again. The
+ * descriptor stays owned by the caller; remove the source before
+ * closing it.
+ * 
+ * @param queue Queue that receives FOSSIL_EVENT_IO events
+ * @param fd Descriptor to watch
+ * @param interest FOSSIL_SYS_EVENT_IO_READ and/or FOSSIL_SYS_EVENT_IO_WRITE
+ * @param id String identifier given to the events (can be NULL)
+ * @return Source handle (> 0) on success, negative on failure
+ */
+int fossil_sys_event_queue_watch_fd(fossil_sys_event_queue_t* queue, int fd, uint32_t interest, const char* id);
+
+/**
+ * Add a timer that fires after delay_ms and then every interval_ms.
+ * Expirations missed while the queue was full are reported with
+ * the next event.
+ * 
+ * @param queue Queue that receives FOSSIL_EVENT_TIMER events
+ * @param delay_ms First expiration in milliseconds (0 = interval_ms)
+ * @param interval_ms Period in milliseconds (0 = one-shot)
+ * @param id String identifier given to the events (can be NULL)
+ * @return Source handle (> 0) on success, negative on failure
+ */
+int fossil_sys_event_queue_add_timer(fossil_sys_event_queue_t* queue, uint32_t delay_ms, uint32_t interval_ms,
+                                     const char* id);
+
+/**
+ * Deliver a signal as an event instead of running a handler.
+ * The signal is blocked in the calling thread; register before
+ * starting other threads (they inherit the mask) or block it in
+ * them too. Removing the source does not unblock it.
+ * 
+ * @param queue Queue that receives FOSSIL_EVENT_SIGNAL events
+ * @param signo Signal number
+ * @param id String identifier given to the events (can be NULL)
+ * @return Source handle (> 0) on success, negative on failure
+ */
+int fossil_sys_event_queue_add_signal(fossil_sys_event_queue_t* queue, int signo, const char* id);
+
+/**
+ * Unregister a source. Events it already delivered stay queued.
+ * 
+ * @param queue Queue the source was registered with
+ * @param source Handle returned by a registration call
+ * @return 0 on success, negative if the source is unknown
+ */
+int fossil_sys_event_queue_remove_source(fossil_sys_event_queue_t* queue, int source);
+
+/**
+ * Arm a one-shot timeout. Timeouts share one timer wheel and one
+ * timerfd per queue, so arming, cancelling and rescheduling cost a
+ * few list operations rather than a kernel timer each. Expiry is
+ * delivered as a FOSSIL_EVENT_TIMER event whose info carries the
+ * handle and context, with millisecond resolution.
+ * 
+ * @param queue Queue that receives the event
+ * @param delay_ms Delay in milliseconds
+ * @param id String identifier given to the event (can be NULL)
+ * @param context User pointer returned in the event (can be NULL)
+ * @return Timeout handle, 0 on failure
+ */
+fossil_sys_event_timeout_t fossil_sys_event_queue_arm_timeout(fossil_sys_event_queue_t* queue, uint32_t delay_ms,
+                                                              const char* id, void* context);
+
+/**
+ * Cancel a pending timeout.
+ * 
+ * @param queue Queue the timeout was armed on
+ * @param timeout Handle returned by arm
+ * @return 0 on success, negative if it already fired or is unknown
+ */
+int fossil_sys_event_queue_cancel_timeout(fossil_sys_event_queue_t* queue, fossil_sys_event_timeout_t timeout);
+
+/**
+ * Move a pending timeout to delay_ms from now, keeping its handle.
+ * 
+ * @param queue Queue the timeout was armed on
+ * @param timeout Handle returned by arm
+ * @param delay_ms New delay in milliseconds
+ * @return 0 on success, negative if it already fired or is unknown
+ */
+int fossil_sys_event_queue_reschedule_timeout(fossil_sys_event_queue_t* queue, fossil_sys_event_timeout_t timeout,
+                                              uint32_t delay_ms);
+
+/* ------------------------------------------------------
+ * Queue Statistics
+ *
+ * Every queue counts what goes through it. Counters are
+ * striped across cache lines by thread and summed when
+ * read, and one enqueue position in 64 per lane carries a
+ * timestamp into an HDR latency histogram, so the hot path
+ * pays a relaxed add and, rarely, a clock read.
+ * ----------------------------------------------------- */
+#define FOSSIL_SYS_EVENT_LATENCY_SAMPLE 64 // one enqueue position in this many is timed
+
+/**
+ * Snapshot of a queue's counters. Values are read without stopping
+ * producers or consumers, so a snapshot taken under load is approximate.
+ * Latencies are in nanoseconds, accurate to within 1/16 of the value.
+ */
+typedef struct {
+    uint64_t posted;          // events that entered a lane, from posts and sources
+    uint64_t delivered;       // events taken out by poll, wait, dispatch or destroy
+    uint64_t dropped;         // events refused or evicted because their lane was full
+    uint64_t spilled;         // events that went to the overflow list (spill policy)
+    uint64_t blocked;         // posts that had to wait for room (block policy)
+    size_t depth;             // events queued right now, all lanes and overflow lists
+    size_t high_water;        // deepest any single lane has been (compare with the capacity)
+    uint64_t latency_samples; // timed events behind the figures below
+    uint64_t latency_min_ns;
+    uint64_t latency_mean_ns;
+    uint64_t latency_p50_ns;
+    uint64_t latency_p90_ns;
+    uint64_t latency_p99_ns;
+    uint64_t latency_p999_ns;
+    uint64_t latency_max_ns;
+} fossil_sys_event_stats_t;
+
+/**
+ * Read a queue's statistics.
+ * 
+ * @param queue Queue to query
+ * @param out Snapshot to fill
+ * @return 0 on success, -1 on invalid arguments
+ */
+int fossil_sys_event_queue_get_stats(const fossil_sys_event_queue_t* queue, fossil_sys_event_stats_t* out);
+
+/**
+ * Zero a queue's counters, high-water mark and latency histogram.
+ * Updates racing with the reset may survive it.
+ * 
+ * @param queue Queue to reset
+ */
+void fossil_sys_event_queue_reset_stats(fossil_sys_event_queue_t* queue);
+
+/* ------------------------------------------------------
+ * Dispatchers
+ *
+ * A dispatcher runs a queue's subscribed handlers on a pool
+ * of worker threads. Each worker takes a run of events at a
+ * time into its own deque and idle workers steal from the
+ * others, so a burst picked up by one thread is shared out.
+ * ----------------------------------------------------- */
+
+/**
+ * Opaque handle to a dispatcher thread pool.
+ */
+typedef struct fossil_sys_event_dispatcher fossil_sys_event_dispatcher_t;
+
+/**
+ * Whether events sharing an id may run concurrently.
+ */
+typedef enum {
+    FOSSIL_SYS_EVENT_DISPATCH_PARALLEL, // any worker runs any event
+    FOSSIL_SYS_EVENT_DISPATCH_ORDERED   // events with the same id run one at a time, in queue order
+} fossil_sys_event_dispatch_order_t;
+
+/**
+ * Start a dispatcher on a queue. Workers dispatch and release
+ * every event they take; nothing else should consume the queue.
+ * In ordered mode events are sharded by id: handlers for one
+ * id never overlap and see its events in queue order, while
+ * different ids still run in parallel.
+ * 
+ * @param queue Queue to drain
+ * @param workers Number of worker threads (0 = one per online CPU)
+ * @param order Parallel or per-id ordered dispatch
+ * @return New dispatcher, or NULL on failure
+ */
+fossil_sys_event_dispatcher_t* fossil_sys_event_dispatcher_create(fossil_sys_event_queue_t* queue, size_t workers,
+                                                                  fossil_sys_event_dispatch_order_t order);
+
+/**
+ * Stop a dispatcher and join its workers. Events the workers
+ * already took are dispatched first; events still in the queue
+ * stay there.
+ * 
+ * @param dispatcher Dispatcher to stop (can be NULL)
+ */
+void fossil_sys_event_dispatcher_destroy(fossil_sys_event_dispatcher_t* dispatcher);
+
+/**
+ * Get the number of worker threads of a dispatcher.
+ * 
+ * @param dispatcher Dispatcher to query
+ * @return Worker count (0 for NULL)
+ */
+size_t fossil_sys_event_dispatcher_workers(const fossil_sys_event_dispatcher_t* dispatcher);
+
+/* ------------------------------------------------------
+ * Asynchronous Consumers
+ *
+ * Instead of blocking a thread, a consumer can leave a
+ * callback that takes the next dispatched event. Whoever
+ * dispatches the queue (a dispatcher or dispatch_pending)
+ * hands each event to the oldest waiting callback first,
+ * and to the subscribers only when nobody waits. A posted
+ * call runs a function on the dispatching thread. The C++
+ * wrapper builds its coroutine awaitables on these.
+ * ----------------------------------------------------- */
+
+/**
+ * Callback that receives an awaited event. It owns the payload
+ * and must release it; the event itself is only valid during the call.
+ */
+typedef void (*fossil_sys_event_resume_t)(fossil_sys_event_t* event, void* context);
+
+/**
+ * Function run by a posted call.
+ */
+typedef void (*fossil_sys_event_call_t)(void* context);
+
+/**
+ * Take the next event of a queue without blocking the caller.
+ * resume runs exactly once, with the next event dispatched on
+ * the queue, on the dispatching thread; it may run before this
+ * call returns. Callbacks left when the queue is destroyed are
+ * dropped without being called.
+ * 
+ * @param queue Queue to consume
+ * @param resume Callback that takes the event
+ * @param context Passed to resume
+ * @return 0 if resume was queued, negative on error
+ */
+int fossil_sys_event_queue_await(fossil_sys_event_queue_t* queue, fossil_sys_event_resume_t resume, void* context);
+
+/**
+ * Post a FOSSIL_EVENT_CALL event that runs fn(context) on the
+ * thread that dispatches it. The call skips subscribers and
+ * awaiting callbacks. A full queue rejects or blocks the call as
+ * its policy says, but once posted a call always runs: DROP_OLDEST
+ * runs a call it would evict on the posting thread instead, and
+ * destroy and shutdown run the calls they drain.
+ * Poll and wait return CALL events like any other; a consumer
+ * that takes one must pass it to fossil_sys_event_queue_dispatch,
+ * which runs it, and must not just release it.
+ * 
+ * @param queue Target queue
+ * @param fn Function to run
+ * @param context Passed to fn
+ * @return 0 on success, negative on failure
+ */
+int fossil_sys_event_queue_post_call(fossil_sys_event_queue_t* queue, fossil_sys_event_call_t fn, void* context);
+
 /* ------------------------------------------------------
  * Event API
+ *
+ * These operate on the default queue.
  * ----------------------------------------------------- */
 
 /**
@@ -68,47 +681,437 @@ int fossil_sys_event_init(void);
 /**
  * Poll for events without blocking.
  * Retrieves the next available event if one exists.
+ * Safe to call from any number of threads concurrently.
  * 
  * @param out_event Pointer to event structure to fill with event data
- * @return 0 if event was retrieved, 1 if no event available, negative on error
+ * @return 1 if event was retrieved, 0 if no event available, negative on error
  */
 int fossil_sys_event_poll(fossil_sys_event_t* out_event);
 
+/**
+ * Poll up to max events from the default queue without blocking.
+ * See fossil_sys_event_queue_poll_batch.
+ * 
+ * @param out_events Array receiving at least max events
+ * @param max Maximum number of events to retrieve
+ * @return Number of events retrieved (0 if none), negative on error
+ */
+int fossil_sys_event_poll_batch(fossil_sys_event_t* out_events, size_t max);
+
 /**
  * Wait for the next event with optional timeout.
  * Blocks until an event is available or timeout expires.
+ * The thread sleeps in the kernel while waiting and is
+ * woken by the next post or by whichever registered source
+ * fires first; the timeout is measured on the monotonic clock.
  * 
  * @param out_event Pointer to event structure to fill with event data
  * @param timeout_ms Maximum time to wait in milliseconds (0 = infinite)
- * @return 0 on success, 1 on timeout, negative on error
+ * @return 1 if event was retrieved, 0 on timeout, negative on error
  */
 int fossil_sys_event_wait(fossil_sys_event_t* out_event, uint32_t timeout_ms);
 
 /**
  * Post a custom event to the event queue.
  * The payload is copied internally if necessary.
+ * Safe to call from any number of threads concurrently.
  * 
  * @param id String identifier for the event
  * @param payload User-defined data (can be NULL)
  * @param size Size of payload in bytes
- * @return 0 on success, negative on failure
+ * @return 0 on success, negative on failure (including a full queue)
  */
 int fossil_sys_event_post(const char* id, void* payload, size_t size);
 
 /**
- * Shutdown the event subsystem and release all resources.
- * Should be called when event system is no longer needed.
+ * Post an event to the default queue choosing how its payload is stored.
+ * See fossil_sys_event_queue_post_ex.
+ * 
+ * @param id String identifier for the event
+ * @param payload User-defined data (can be NULL)
+ * @param size Size of payload in bytes
+ * @param mode Payload storage mode
+ * @return 0 on success, negative on failure
  */
-void fossil_sys_event_shutdown(void);
+int fossil_sys_event_post_ex(const char* id, void* payload, size_t size, fossil_sys_event_post_mode_t mode);
 
-#ifdef __cplusplus
-}
+/**
+ * Post an event to a priority lane of the default queue.
+ * See fossil_sys_event_queue_post_priority.
+ * 
+ * @param id String identifier for the event
+ * @param payload User-defined data (can be NULL)
+ * @param size Size of payload in bytes
+ * @param mode Payload storage mode
+ * @param priority Lane to post to
+ * @return 0 on success, negative on failure
+ */
+int fossil_sys_event_post_priority(const char* id, void* payload, size_t size, fossil_sys_event_post_mode_t mode,
+                                   fossil_sys_event_priority_t priority);
 
-namespace fossil::sys {
+/**
+ * Choose how the default queue drains its priority lanes.
+ * See fossil_sys_event_queue_set_drain.
+ * 
+ * @param policy Strict or weighted draining
+ * @param weights Lane weights (NULL = 8, 4, 2, 1)
+ * @return 0 on success, negative on invalid arguments
+ */
+int fossil_sys_event_set_drain(fossil_sys_event_drain_t policy, const uint32_t* weights);
 
-    class Event {
-    public:
-        /**
+/**
+ * Intern an event id. The same string always yields the same
+ * key, and keys are never reused. Interned ids are kept for the
+ * life of the process, so intern a bounded set of names; subscribe
+ * and the event source calls intern their ids, posts do not.
+ * 
+ * @param id String identifier (can be NULL)
+ * @return Key (> 0), or 0 for NULL or when the table is full
+ */
+uint32_t fossil_sys_event_intern(const char* id);
+
+/**
+ * Look up the string for an interned key.
+ * 
+ * @param key Key returned by fossil_sys_event_intern
+ * @return Interned string, or NULL for 0 and unknown keys
+ */
+const char* fossil_sys_event_name(uint32_t key);
+
+/**
+ * Post an event by interned key to the default queue.
+ * See fossil_sys_event_queue_post_key.
+ * 
+ * @param key Key returned by fossil_sys_event_intern (0 = no id)
+ * @param payload User-defined data (can be NULL)
+ * @param size Size of payload in bytes
+ * @param mode Payload storage mode
+ * @param priority Lane to post to
+ * @return 0 on success, negative on failure
+ */
+int fossil_sys_event_post_key(uint32_t key, void* payload, size_t size, fossil_sys_event_post_mode_t mode,
+                              fossil_sys_event_priority_t priority);
+
+/**
+ * Subscribe a handler on the default queue.
+ * See fossil_sys_event_queue_subscribe.
+ * 
+ * @param id String identifier to subscribe to
+ * @param handler Function called for each matching event
+ * @param context User pointer passed to the handler
+ * @return Subscription handle (> 0) on success, negative on failure
+ */
+int fossil_sys_event_subscribe(const char* id, fossil_sys_event_handler_t handler, void* context);
+
+/**
+ * Remove a subscription from the default queue.
+ * 
+ * @param subscription Handle returned by fossil_sys_event_subscribe
+ * @return 0 on success, negative if the subscription is unknown
+ */
+int fossil_sys_event_unsubscribe(int subscription);
+
+/**
+ * Run the default queue's handlers for an event.
+ * See fossil_sys_event_queue_dispatch.
+ * 
+ * @param event Event to dispatch
+ * @return Number of handlers run, negative on failure
+ */
+int fossil_sys_event_dispatch(const fossil_sys_event_t* event);
+
+/**
+ * Poll, dispatch and release up to max events from the default queue.
+ * 
+ * @param max Maximum number of events to handle
+ * @return Number of events handled, negative on failure
+ */
+int fossil_sys_event_dispatch_pending(size_t max);
+
+/**
+ * Post a run of events to the default queue, copying their payloads.
+ * See fossil_sys_event_queue_post_batch.
+ * 
+ * @param events Events to post
+ * @param count Number of events
+ * @return Number of events posted, negative on error
+ */
+int fossil_sys_event_post_batch(const fossil_sys_event_t* events, size_t count);
+
+/**
+ * Watch a descriptor on the default queue.
+ * See fossil_sys_event_queue_watch_fd.
+ * 
+ * @param fd Descriptor to watch
+ * @param interest FOSSIL_SYS_EVENT_IO_READ and/or FOSSIL_SYS_EVENT_IO_WRITE
+ * @param id String identifier given to the events (can be NULL)
+ * @return Source handle (> 0) on success, negative on failure
+ */
+int fossil_sys_event_watch_fd(int fd, uint32_t interest, const char* id);
+
+/**
+ * Add a timer to the default queue.
+ * See fossil_sys_event_queue_add_timer.
+ * 
+ * @param delay_ms First expiration in milliseconds (0 = interval_ms)
+ * @param interval_ms Period in milliseconds (0 = one-shot)
+ * @param id String identifier given to the events (can be NULL)
+ * @return Source handle (> 0) on success, negative on failure
+ */
+int fossil_sys_event_add_timer(uint32_t delay_ms, uint32_t interval_ms, const char* id);
+
+/**
+ * Deliver a signal to the default queue.
+ * See fossil_sys_event_queue_add_signal.
+ * 
+ * @param signo Signal number
+ * @param id String identifier given to the events (can be NULL)
+ * @return Source handle (> 0) on success, negative on failure
+ */
+int fossil_sys_event_add_signal(int signo, const char* id);
+
+/**
+ * Unregister a source from the default queue.
+ * 
+ * @param source Handle returned by a registration call
+ * @return 0 on success, negative if the source is unknown
+ */
+int fossil_sys_event_remove_source(int source);
+
+/**
+ * Arm a one-shot timeout on the default queue.
+ * See fossil_sys_event_queue_arm_timeout.
+ * 
+ * @param delay_ms Delay in milliseconds
+ * @param id String identifier given to the event (can be NULL)
+ * @param context User pointer returned in the event (can be NULL)
+ * @return Timeout handle, 0 on failure
+ */
+fossil_sys_event_timeout_t fossil_sys_event_arm_timeout(uint32_t delay_ms, const char* id, void* context);
+
+/**
+ * Cancel a pending timeout on the default queue.
+ * 
+ * @param timeout Handle returned by arm
+ * @return 0 on success, negative if it already fired or is unknown
+ */
+int fossil_sys_event_cancel_timeout(fossil_sys_event_timeout_t timeout);
+
+/**
+ * Reschedule a pending timeout on the default queue.
+ * 
+ * @param timeout Handle returned by arm
+ * @param delay_ms New delay in milliseconds
+ * @return 0 on success, negative if it already fired or is unknown
+ */
+int fossil_sys_event_reschedule_timeout(fossil_sys_event_timeout_t timeout, uint32_t delay_ms);
+
+/**
+ * Read the default queue's statistics.
+ * See fossil_sys_event_queue_get_stats.
+ * 
+ * @param out Snapshot to fill
+ * @return 0 on success, -1 on invalid arguments
+ */
+int fossil_sys_event_get_stats(fossil_sys_event_stats_t* out);
+
+/**
+ * Zero the default queue's statistics.
+ */
+void fossil_sys_event_reset_stats(void);
+
+/**
+ * Leave a callback for the next event dispatched on the default queue.
+ * See fossil_sys_event_queue_await.
+ * 
+ * @param resume Callback that takes the event
+ * @param context Passed to resume
+ * @return 0 if resume was queued, negative on error
+ */
+int fossil_sys_event_await(fossil_sys_event_resume_t resume, void* context);
+
+/**
+ * Run fn(context) on whichever thread dispatches the default queue.
+ * See fossil_sys_event_queue_post_call.
+ * 
+ * @param fn Function to run
+ * @param context Passed to fn
+ * @return 0 on success, negative on failure
+ */
+int fossil_sys_event_post_call(fossil_sys_event_call_t fn, void* context);
+
+/**
+ * Shutdown the event subsystem and release all resources.
+ * Should be called when event system is no longer needed.
+ */
+void fossil_sys_event_shutdown(void);
+
+#ifdef __cplusplus
+}
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#include <coroutine>
+#define FOSSIL_SYS_EVENT_COROUTINES 1
+#endif
+#endif
+
+namespace fossil::sys {
+
+    /**
+     * Move-only owner of a received event that releases its payload
+     * when it goes out of scope.
+     */
+    class OwnedEvent {
+    public:
+        OwnedEvent() noexcept : event_(), valid_(false) {
+        }
+
+        /**
+         * Take ownership of an event returned by poll, wait or an
+         * await callback.
+         */
+        explicit OwnedEvent(const fossil_sys_event_t& event) noexcept : event_(event), valid_(true) {
+            adopt();
+        }
+
+        ~OwnedEvent() {
+            reset();
+        }
+
+        OwnedEvent(const OwnedEvent&) = delete;
+        OwnedEvent& operator=(const OwnedEvent&) = delete;
+
+        OwnedEvent(OwnedEvent&& other) noexcept : event_(other.event_), valid_(other.valid_) {
+            other.valid_ = false;
+            adopt();
+        }
+
+        OwnedEvent& operator=(OwnedEvent&& other) noexcept {
+            if (this != &other) {
+                reset();
+                event_ = other.event_;
+                valid_ = other.valid_;
+                other.valid_ = false;
+                adopt();
+            }
+            return *this;
+        }
+
+        /**
+         * True if an event is held.
+         */
+        explicit operator bool() const noexcept {
+            return valid_;
+        }
+
+        /**
+         * The held event, or nullptr.
+         */
+        const fossil_sys_event_t* get() const noexcept {
+            return valid_ ? &event_ : nullptr;
+        }
+
+        const fossil_sys_event_t* operator->() const noexcept {
+            return &event_;
+        }
+
+        /**
+         * Release the payload now.
+         */
+        void reset() noexcept {
+            if (valid_) {
+                fossil_sys_event_release(&event_);
+                valid_ = false;
+            }
+        }
+
+    private:
+        // Inline payloads live in the event itself, so a copy must point at its own.
+        void adopt() noexcept {
+            if (valid_ && event_.storage == FOSSIL_SYS_EVENT_STORAGE_INLINE)
+                event_.payload = event_.inline_data;
+        }
+
+        fossil_sys_event_t event_;
+        bool valid_;
+    };
+
+#ifdef FOSSIL_SYS_EVENT_COROUTINES
+    /**
+     * Awaitable for the next event of a queue. The coroutine is
+     * resumed on the thread that dispatches the event and receives
+     * an empty OwnedEvent if the wait could not be registered.
+     */
+    class EventAwaiter {
+    public:
+        explicit EventAwaiter(fossil_sys_event_queue_t* queue) noexcept : queue_(queue), handle_() {
+        }
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) noexcept {
+            handle_ = handle;
+            // The callback may resume and finish the coroutine before
+            // this returns, so nothing in *this is touched afterwards.
+            return fossil_sys_event_queue_await(queue_, &EventAwaiter::resume, this) == 0;
+        }
+
+        OwnedEvent await_resume() noexcept {
+            return static_cast<OwnedEvent&&>(event_);
+        }
+
+    private:
+        static void resume(fossil_sys_event_t* event, void* context) {
+            EventAwaiter* self = static_cast<EventAwaiter*>(context);
+            self->event_ = OwnedEvent(*event);
+            self->handle_.resume();
+        }
+
+        fossil_sys_event_queue_t* queue_;
+        std::coroutine_handle<> handle_;
+        OwnedEvent event_;
+    };
+
+    /**
+     * Awaitable that moves a coroutine onto the thread dispatching a
+     * queue and yields a status code. A nonzero status or a failed
+     * hop leaves the coroutine running where it is. On a DROP_OLDEST
+     * queue that overflows, the coroutine may resume on the thread
+     * whose post pushed the call out.
+     */
+    class ResumeAwaiter {
+    public:
+        ResumeAwaiter(fossil_sys_event_queue_t* queue, int status) noexcept : queue_(queue), status_(status) {
+        }
+
+        bool await_ready() const noexcept {
+            return status_ != 0;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) noexcept {
+            return fossil_sys_event_queue_post_call(queue_, &ResumeAwaiter::resume, handle.address()) == 0;
+        }
+
+        int await_resume() const noexcept {
+            return status_;
+        }
+
+    private:
+        static void resume(void* address) {
+            std::coroutine_handle<>::from_address(address).resume();
+        }
+
+        fossil_sys_event_queue_t* queue_;
+        int status_;
+    };
+#endif
+
+    class Event {
+    public:
+        /**
          * Initialize the event subsystem.
          * Must be called before using any other event functions.
          * 
@@ -121,9 +1124,10 @@ namespace fossil::sys {
         /**
          * Poll for events without blocking.
          * Retrieves the next available event if one exists.
+         * Safe to call from any number of threads concurrently.
          * 
          * @param out_event Pointer to event structure to fill with event data
-         * @return 0 if event was retrieved, 1 if no event available, negative on error
+         * @return 1 if event was retrieved, 0 if no event available, negative on error
          */
         static int poll(fossil_sys_event_t* out_event) {
             return fossil_sys_event_poll(out_event);
@@ -132,10 +1136,11 @@ namespace fossil::sys {
         /**
          * Wait for the next event with optional timeout.
          * Blocks until an event is available or timeout expires.
+         * The thread sleeps while waiting and is woken by the next post.
          * 
          * @param out_event Pointer to event structure to fill with event data
          * @param timeout_ms Maximum time to wait in milliseconds (0 = infinite)
-         * @return 0 on success, 1 on timeout, negative on error
+         * @return 1 if event was retrieved, 0 on timeout, negative on error
          */
         static int wait(fossil_sys_event_t* out_event, uint32_t timeout_ms) {
             return fossil_sys_event_wait(out_event, timeout_ms);
@@ -154,6 +1159,282 @@ namespace fossil::sys {
             return fossil_sys_event_post(id, payload, size);
         }
 
+        /**
+         * Post an event choosing how its payload is stored.
+         * 
+         * @param id String identifier for the event
+         * @param payload User-defined data (can be NULL)
+         * @param size Size of payload in bytes
+         * @param mode Payload storage mode
+         * @return 0 on success, negative on failure
+         */
+        static int post(const char* id, void* payload, size_t size, fossil_sys_event_post_mode_t mode) {
+            return fossil_sys_event_post_ex(id, payload, size, mode);
+        }
+
+        /**
+         * Post an event to a priority lane.
+         * 
+         * @param id String identifier for the event
+         * @param payload User-defined data (can be NULL)
+         * @param size Size of payload in bytes
+         * @param mode Payload storage mode
+         * @param priority Lane to post to
+         * @return 0 on success, negative on failure
+         */
+        static int post(const char* id, void* payload, size_t size, fossil_sys_event_post_mode_t mode,
+                        fossil_sys_event_priority_t priority) {
+            return fossil_sys_event_post_priority(id, payload, size, mode, priority);
+        }
+
+        /**
+         * Choose how poll and wait drain the priority lanes.
+         * 
+         * @param policy Strict or weighted draining
+         * @param weights Lane weights (nullptr = 8, 4, 2, 1)
+         * @return 0 on success, negative on invalid arguments
+         */
+        static int set_drain(fossil_sys_event_drain_t policy, const uint32_t* weights = nullptr) {
+            return fossil_sys_event_set_drain(policy, weights);
+        }
+
+        /**
+         * Intern an event id; it is kept for the life of the process.
+         * 
+         * @param id String identifier
+         * @return Key (> 0), or 0 for nullptr or when the table is full
+         */
+        static uint32_t intern(const char* id) {
+            return fossil_sys_event_intern(id);
+        }
+
+        /**
+         * Look up the string for an interned key.
+         * 
+         * @param key Interned key
+         * @return Interned string, or nullptr for unknown keys
+         */
+        static const char* name(uint32_t key) {
+            return fossil_sys_event_name(key);
+        }
+
+        /**
+         * Post an event by interned key.
+         * 
+         * @param key Interned key (0 = no id)
+         * @param payload User-defined data (can be nullptr)
+         * @param size Size of payload in bytes
+         * @param mode Payload storage mode
+         * @param priority Lane to post to
+         * @return 0 on success, negative on failure
+         */
+        static int post_key(uint32_t key, void* payload, size_t size,
+                            fossil_sys_event_post_mode_t mode = FOSSIL_SYS_EVENT_POST_COPY,
+                            fossil_sys_event_priority_t priority = FOSSIL_SYS_EVENT_PRIORITY_NORMAL) {
+            return fossil_sys_event_post_key(key, payload, size, mode, priority);
+        }
+
+        /**
+         * Subscribe a handler to an event id.
+         * 
+         * @param id String identifier
+         * @param handler Function called for each matching event
+         * @param context User pointer passed to the handler
+         * @return Subscription handle (> 0), negative on failure
+         */
+        static int subscribe(const char* id, fossil_sys_event_handler_t handler, void* context = nullptr) {
+            return fossil_sys_event_subscribe(id, handler, context);
+        }
+
+        /**
+         * Remove a subscription.
+         * 
+         * @param subscription Handle returned by subscribe
+         * @return 0 on success, negative if unknown
+         */
+        static int unsubscribe(int subscription) {
+            return fossil_sys_event_unsubscribe(subscription);
+        }
+
+        /**
+         * Run the handlers subscribed to an event's id.
+         * 
+         * @param event Event to dispatch
+         * @return Number of handlers run, negative on failure
+         */
+        static int dispatch(const fossil_sys_event_t& event) {
+            return fossil_sys_event_dispatch(&event);
+        }
+
+        /**
+         * Poll, dispatch and release up to max events.
+         * 
+         * @param max Maximum number of events to handle
+         * @return Number of events handled, negative on failure
+         */
+        static int dispatch_pending(size_t max) {
+            return fossil_sys_event_dispatch_pending(max);
+        }
+
+        /**
+         * Post a run of events, copying their payloads.
+         * 
+         * @param events Events to post
+         * @param count Number of events
+         * @return Number of events posted, negative on error
+         */
+        static int post_batch(const fossil_sys_event_t* events, size_t count) {
+            return fossil_sys_event_post_batch(events, count);
+        }
+
+        /**
+         * Poll up to max events without blocking.
+         * 
+         * @param out_events Array receiving at least max events
+         * @param max Maximum number of events to retrieve
+         * @return Number of events retrieved, negative on error
+         */
+        static int poll_batch(fossil_sys_event_t* out_events, size_t max) {
+            return fossil_sys_event_poll_batch(out_events, max);
+        }
+
+        /**
+         * Watch a descriptor for readiness (edge-triggered).
+         * 
+         * @param fd Descriptor to watch
+         * @param interest FOSSIL_SYS_EVENT_IO_READ and/or FOSSIL_SYS_EVENT_IO_WRITE
+         * @param id String identifier given to the events
+         * @return Source handle (> 0) on success, negative on failure
+         */
+        static int watch_fd(int fd, uint32_t interest, const char* id) {
+            return fossil_sys_event_watch_fd(fd, interest, id);
+        }
+
+        /**
+         * Add a timer.
+         * 
+         * @param delay_ms First expiration in milliseconds (0 = interval_ms)
+         * @param interval_ms Period in milliseconds (0 = one-shot)
+         * @param id String identifier given to the events
+         * @return Source handle (> 0) on success, negative on failure
+         */
+        static int add_timer(uint32_t delay_ms, uint32_t interval_ms, const char* id) {
+            return fossil_sys_event_add_timer(delay_ms, interval_ms, id);
+        }
+
+        /**
+         * Deliver a signal as an event.
+         * 
+         * @param signo Signal number
+         * @param id String identifier given to the events
+         * @return Source handle (> 0) on success, negative on failure
+         */
+        static int add_signal(int signo, const char* id) {
+            return fossil_sys_event_add_signal(signo, id);
+        }
+
+        /**
+         * Unregister a source.
+         * 
+         * @param source Handle returned by a registration call
+         * @return 0 on success, negative if the source is unknown
+         */
+        static int remove_source(int source) {
+            return fossil_sys_event_remove_source(source);
+        }
+
+        /**
+         * Arm a one-shot timeout.
+         * 
+         * @param delay_ms Delay in milliseconds
+         * @param id String identifier given to the event
+         * @param context User pointer returned in the event
+         * @return Timeout handle, 0 on failure
+         */
+        static fossil_sys_event_timeout_t arm_timeout(uint32_t delay_ms, const char* id, void* context = nullptr) {
+            return fossil_sys_event_arm_timeout(delay_ms, id, context);
+        }
+
+        /**
+         * Cancel a pending timeout.
+         * 
+         * @param timeout Handle returned by arm_timeout
+         * @return 0 on success, negative if it already fired or is unknown
+         */
+        static int cancel_timeout(fossil_sys_event_timeout_t timeout) {
+            return fossil_sys_event_cancel_timeout(timeout);
+        }
+
+        /**
+         * Reschedule a pending timeout.
+         * 
+         * @param timeout Handle returned by arm_timeout
+         * @param delay_ms New delay in milliseconds
+         * @return 0 on success, negative if it already fired or is unknown
+         */
+        static int reschedule_timeout(fossil_sys_event_timeout_t timeout, uint32_t delay_ms) {
+            return fossil_sys_event_reschedule_timeout(timeout, delay_ms);
+        }
+
+        /**
+         * Read the default queue's statistics.
+         * 
+         * @return Snapshot of counters, depth and latency percentiles
+         */
+        static fossil_sys_event_stats_t stats() {
+            fossil_sys_event_stats_t out = {};
+            fossil_sys_event_get_stats(&out);
+            return out;
+        }
+
+        /**
+         * Zero the default queue's statistics.
+         */
+        static void reset_stats() {
+            fossil_sys_event_reset_stats();
+        }
+
+#ifdef FOSSIL_SYS_EVENT_COROUTINES
+        /**
+         * co_await the next event dispatched on the default queue.
+         * 
+         * @return Awaitable yielding an OwnedEvent
+         */
+        static EventAwaiter next() {
+            return EventAwaiter(fossil_sys_event_queue_default());
+        }
+
+        /**
+         * Post an event, then resume the awaiting coroutine on the
+         * thread that dispatches the default queue.
+         * 
+         * @param id String identifier for the event
+         * @param payload User-defined data (can be NULL)
+         * @param size Size of payload in bytes
+         * @return Awaitable yielding the post's result
+         */
+        static ResumeAwaiter post_async(const char* id, void* payload, size_t size) {
+            return ResumeAwaiter(fossil_sys_event_queue_default(), fossil_sys_event_post(id, payload, size));
+        }
+
+        /**
+         * Resume the awaiting coroutine on the thread that dispatches
+         * the default queue.
+         */
+        static ResumeAwaiter schedule() {
+            return ResumeAwaiter(fossil_sys_event_queue_default(), 0);
+        }
+#endif
+
+        /**
+         * Release the payload of a received event, whatever its storage.
+         * 
+         * @param event Event returned by poll or wait
+         */
+        static void release(fossil_sys_event_t* event) {
+            fossil_sys_event_release(event);
+        }
+
         /**
          * Shutdown the event subsystem and release all resources.
          * Should be called when event system is no longer needed.
@@ -163,6 +1444,406 @@ namespace fossil::sys {
         }
     };
 
+    class EventQueue {
+    public:
+        /**
+         * Create an independent event queue.
+         * 
+         * @param capacity Maximum queued events per priority lane, rounded up to a power of two (0 = default)
+         * @param mode Threading mode of the producer and consumer sides
+         */
+        explicit EventQueue(size_t capacity = 0, fossil_sys_event_queue_mode_t mode = FOSSIL_SYS_EVENT_QUEUE_MPMC)
+            : queue_(fossil_sys_event_queue_create(capacity, mode)) {
+        }
+
+        /**
+         * Create a queue with a policy for full lanes.
+         * 
+         * @param capacity Maximum queued events per priority lane (0 = FOSSIL_SYS_EVENT_CAPACITY)
+         * @param mode Threading mode of the producer and consumer sides
+         * @param policy What a post does when its lane is full
+         * @param block_timeout_ms Longest a blocked post waits (0 = infinite)
+         */
+        EventQueue(size_t capacity, fossil_sys_event_queue_mode_t mode, fossil_sys_event_backpressure_t policy,
+                   uint32_t block_timeout_ms = 0)
+            : queue_(fossil_sys_event_queue_create_ex(capacity, mode, policy, block_timeout_ms)) {
+        }
+
+        ~EventQueue() {
+            fossil_sys_event_queue_destroy(queue_);
+        }
+
+        EventQueue(const EventQueue&) = delete;
+        EventQueue& operator=(const EventQueue&) = delete;
+
+        EventQueue(EventQueue&& other) noexcept : queue_(other.queue_) {
+            other.queue_ = nullptr;
+        }
+
+        EventQueue& operator=(EventQueue&& other) noexcept {
+            if (this != &other) {
+                fossil_sys_event_queue_destroy(queue_);
+                queue_ = other.queue_;
+                other.queue_ = nullptr;
+            }
+            return *this;
+        }
+
+        /**
+         * Post a custom event. The payload is copied.
+         * 
+         * @param id String identifier for the event
+         * @param payload User-defined data (can be nullptr)
+         * @param size Size of payload in bytes
+         * @return 0 on success, negative on failure
+         */
+        int post(const char* id, void* payload, size_t size) {
+            return fossil_sys_event_queue_post(queue_, id, payload, size);
+        }
+
+        /**
+         * Post an event choosing how its payload is stored.
+         * 
+         * @param id String identifier for the event
+         * @param payload User-defined data (can be nullptr)
+         * @param size Size of payload in bytes
+         * @param mode Payload storage mode
+         * @return 0 on success, negative on failure
+         */
+        int post(const char* id, void* payload, size_t size, fossil_sys_event_post_mode_t mode) {
+            return fossil_sys_event_queue_post_ex(queue_, id, payload, size, mode);
+        }
+
+        /**
+         * Post an event to a priority lane.
+         * 
+         * @param id String identifier for the event
+         * @param payload User-defined data (can be nullptr)
+         * @param size Size of payload in bytes
+         * @param mode Payload storage mode
+         * @param priority Lane to post to
+         * @return 0 on success, negative on failure
+         */
+        int post(const char* id, void* payload, size_t size, fossil_sys_event_post_mode_t mode,
+                 fossil_sys_event_priority_t priority) {
+            return fossil_sys_event_queue_post_priority(queue_, id, payload, size, mode, priority);
+        }
+
+        /**
+         * Choose how poll and wait drain the priority lanes.
+         * 
+         * @param policy Strict or weighted draining
+         * @param weights Lane weights (nullptr = 8, 4, 2, 1)
+         * @return 0 on success, negative on invalid arguments
+         */
+        int set_drain(fossil_sys_event_drain_t policy, const uint32_t* weights = nullptr) {
+            return fossil_sys_event_queue_set_drain(queue_, policy, weights);
+        }
+
+        /**
+         * Post an event by interned key.
+         * 
+         * @param key Interned key (0 = no id)
+         * @param payload User-defined data (can be nullptr)
+         * @param size Size of payload in bytes
+         * @param mode Payload storage mode
+         * @param priority Lane to post to
+         * @return 0 on success, negative on failure
+         */
+        int post_key(uint32_t key, void* payload, size_t size,
+                     fossil_sys_event_post_mode_t mode = FOSSIL_SYS_EVENT_POST_COPY,
+                     fossil_sys_event_priority_t priority = FOSSIL_SYS_EVENT_PRIORITY_NORMAL) {
+            return fossil_sys_event_queue_post_key(queue_, key, payload, size, mode, priority);
+        }
+
+        /**
+         * Subscribe a handler to an event id on this queue.
+         * 
+         * @param id String identifier
+         * @param handler Function called for each matching event
+         * @param context User pointer passed to the handler
+         * @return Subscription handle (> 0), negative on failure
+         */
+        int subscribe(const char* id, fossil_sys_event_handler_t handler, void* context = nullptr) {
+            return fossil_sys_event_queue_subscribe(queue_, id, handler, context);
+        }
+
+        /**
+         * Remove a subscription.
+         * 
+         * @param subscription Handle returned by subscribe
+         * @return 0 on success, negative if unknown
+         */
+        int unsubscribe(int subscription) {
+            return fossil_sys_event_queue_unsubscribe(queue_, subscription);
+        }
+
+        /**
+         * Run the handlers subscribed to an event's id.
+         * 
+         * @param event Event to dispatch
+         * @return Number of handlers run, negative on failure
+         */
+        int dispatch(const fossil_sys_event_t& event) {
+            return fossil_sys_event_queue_dispatch(queue_, &event);
+        }
+
+        /**
+         * Poll, dispatch and release up to max events.
+         * 
+         * @param max Maximum number of events to handle
+         * @return Number of events handled, negative on failure
+         */
+        int dispatch_pending(size_t max) {
+            return fossil_sys_event_queue_dispatch_pending(queue_, max);
+        }
+
+        /**
+         * Post a run of events with a single reservation.
+         * 
+         * @param events Events to post
+         * @param count Number of events
+         * @param mode Payload storage mode
+         * @return Number of events posted, negative on error
+         */
+        int post_batch(const fossil_sys_event_t* events, size_t count,
+                       fossil_sys_event_post_mode_t mode = FOSSIL_SYS_EVENT_POST_COPY) {
+            return fossil_sys_event_queue_post_batch(queue_, events, count, mode);
+        }
+
+        /**
+         * Poll without blocking.
+         * 
+         * @param out_event Pointer to event structure to fill with event data
+         * @return 1 if event was retrieved, 0 if no event available, negative on error
+         */
+        int poll(fossil_sys_event_t* out_event) {
+            return fossil_sys_event_queue_poll(queue_, out_event);
+        }
+
+        /**
+         * Poll up to max events without blocking.
+         * 
+         * @param out_events Array receiving at least max events
+         * @param max Maximum number of events to retrieve
+         * @return Number of events retrieved, negative on error
+         */
+        int poll_batch(fossil_sys_event_t* out_events, size_t max) {
+            return fossil_sys_event_queue_poll_batch(queue_, out_events, max);
+        }
+
+        /**
+         * Watch a descriptor for readiness (edge-triggered).
+         * 
+         * @param fd Descriptor to watch
+         * @param interest FOSSIL_SYS_EVENT_IO_READ and/or FOSSIL_SYS_EVENT_IO_WRITE
+         * @param id String identifier given to the events
+         * @return Source handle (> 0) on success, negative on failure
+         */
+        int watch_fd(int fd, uint32_t interest, const char* id) {
+            return fossil_sys_event_queue_watch_fd(queue_, fd, interest, id);
+        }
+
+        /**
+         * Add a timer.
+         * 
+         * @param delay_ms First expiration in milliseconds (0 = interval_ms)
+         * @param interval_ms Period in milliseconds (0 = one-shot)
+         * @param id String identifier given to the events
+         * @return Source handle (> 0) on success, negative on failure
+         */
+        int add_timer(uint32_t delay_ms, uint32_t interval_ms, const char* id) {
+            return fossil_sys_event_queue_add_timer(queue_, delay_ms, interval_ms, id);
+        }
+
+        /**
+         * Deliver a signal as an event.
+         * 
+         * @param signo Signal number
+         * @param id String identifier given to the events
+         * @return Source handle (> 0) on success, negative on failure
+         */
+        int add_signal(int signo, const char* id) {
+            return fossil_sys_event_queue_add_signal(queue_, signo, id);
+        }
+
+        /**
+         * Unregister a source.
+         * 
+         * @param source Handle returned by a registration call
+         * @return 0 on success, negative if the source is unknown
+         */
+        int remove_source(int source) {
+            return fossil_sys_event_queue_remove_source(queue_, source);
+        }
+
+        /**
+         * Arm a one-shot timeout.
+         * 
+         * @param delay_ms Delay in milliseconds
+         * @param id String identifier given to the event
+         * @param context User pointer returned in the event
+         * @return Timeout handle, 0 on failure
+         */
+        fossil_sys_event_timeout_t arm_timeout(uint32_t delay_ms, const char* id, void* context = nullptr) {
+            return fossil_sys_event_queue_arm_timeout(queue_, delay_ms, id, context);
+        }
+
+        /**
+         * Cancel a pending timeout.
+         * 
+         * @param timeout Handle returned by arm_timeout
+         * @return 0 on success, negative if it already fired or is unknown
+         */
+        int cancel_timeout(fossil_sys_event_timeout_t timeout) {
+            return fossil_sys_event_queue_cancel_timeout(queue_, timeout);
+        }
+
+        /**
+         * Reschedule a pending timeout.
+         * 
+         * @param timeout Handle returned by arm_timeout
+         * @param delay_ms New delay in milliseconds
+         * @return 0 on success, negative if it already fired or is unknown
+         */
+        int reschedule_timeout(fossil_sys_event_timeout_t timeout, uint32_t delay_ms) {
+            return fossil_sys_event_queue_reschedule_timeout(queue_, timeout, delay_ms);
+        }
+
+        /**
+         * Wait for the next event.
+         * 
+         * @param out_event Pointer to event structure to fill with event data
+         * @param timeout_ms Maximum time to wait in milliseconds (0 = infinite)
+         * @return 1 if event was retrieved, 0 on timeout, negative on error
+         */
+        int wait(fossil_sys_event_t* out_event, uint32_t timeout_ms) {
+            return fossil_sys_event_queue_wait(queue_, out_event, timeout_ms);
+        }
+
+        /**
+         * Maximum number of queued events per priority lane.
+         */
+        size_t capacity() const {
+            return fossil_sys_event_queue_capacity(queue_);
+        }
+
+        /**
+         * Read the queue's statistics.
+         * 
+         * @return Snapshot of counters, depth and latency percentiles
+         */
+        fossil_sys_event_stats_t stats() const {
+            fossil_sys_event_stats_t out = {};
+            fossil_sys_event_queue_get_stats(queue_, &out);
+            return out;
+        }
+
+        /**
+         * Zero the queue's statistics.
+         */
+        void reset_stats() {
+            fossil_sys_event_queue_reset_stats(queue_);
+        }
+
+#ifdef FOSSIL_SYS_EVENT_COROUTINES
+        /**
+         * co_await the next event dispatched on this queue.
+         * 
+         * @return Awaitable yielding an OwnedEvent
+         */
+        EventAwaiter next() {
+            return EventAwaiter(queue_);
+        }
+
+        /**
+         * Post an event, then resume the awaiting coroutine on the
+         * thread that dispatches this queue.
+         * 
+         * @param id String identifier for the event
+         * @param payload User-defined data (can be NULL)
+         * @param size Size of payload in bytes
+         * @return Awaitable yielding the post's result
+         */
+        ResumeAwaiter post_async(const char* id, void* payload, size_t size) {
+            return ResumeAwaiter(queue_, fossil_sys_event_queue_post(queue_, id, payload, size));
+        }
+
+        /**
+         * Resume the awaiting coroutine on the thread that dispatches
+         * this queue.
+         */
+        ResumeAwaiter schedule() {
+            return ResumeAwaiter(queue_, 0);
+        }
+#endif
+
+        /**
+         * Access the underlying C handle.
+         */
+        fossil_sys_event_queue_t* handle() const {
+            return queue_;
+        }
+
+    private:
+        fossil_sys_event_queue_t* queue_;
+    };
+
+    /**
+     * RAII wrapper for a dispatcher thread pool.
+     */
+    class EventDispatcher {
+    public:
+        /**
+         * Start dispatching a queue on a pool of workers.
+         * 
+         * @param queue Queue to drain
+         * @param workers Number of worker threads (0 = one per online CPU)
+         * @param order Parallel or per-id ordered dispatch
+         */
+        explicit EventDispatcher(EventQueue& queue, size_t workers = 0,
+                                 fossil_sys_event_dispatch_order_t order = FOSSIL_SYS_EVENT_DISPATCH_PARALLEL)
+            : dispatcher_(fossil_sys_event_dispatcher_create(queue.handle(), workers, order)) {
+        }
+
+        ~EventDispatcher() {
+            fossil_sys_event_dispatcher_destroy(dispatcher_);
+        }
+
+        EventDispatcher(const EventDispatcher&) = delete;
+        EventDispatcher& operator=(const EventDispatcher&) = delete;
+
+        EventDispatcher(EventDispatcher&& other) noexcept : dispatcher_(other.dispatcher_) {
+            other.dispatcher_ = nullptr;
+        }
+
+        EventDispatcher& operator=(EventDispatcher&& other) noexcept {
+            if (this != &other) {
+                fossil_sys_event_dispatcher_destroy(dispatcher_);
+                dispatcher_ = other.dispatcher_;
+                other.dispatcher_ = nullptr;
+            }
+            return *this;
+        }
+
+        /**
+         * Number of worker threads (0 if the dispatcher failed to start).
+         */
+        size_t workers() const {
+            return fossil_sys_event_dispatcher_workers(dispatcher_);
+        }
+
+        /**
+         * Access the underlying C handle.
+         */
+        fossil_sys_event_dispatcher_t* handle() const {
+            return dispatcher_;
+        }
+
+    private:
+        fossil_sys_event_dispatcher_t* dispatcher_;
+    };
+
 } // namespace fossil::sys
 
 #endif
@@ -158,6 +158,35 @@ fossil_sys_memory_t fossil_sys_memory_move(fossil_sys_memory_t dest, const fossi
  */
 fossil_sys_memory_t fossil_sys_memory_resize(fossil_sys_memory_t ptr, size_t old_size, size_t new_size);
 
+/**
+ * Growth policy for fossil_sys_memory_resize_ex.
+ */
+typedef enum
+{
+    FOSSIL_SYS_MEMORY_RESIZE_EXACT,    // Request exactly new_size bytes
+    FOSSIL_SYS_MEMORY_RESIZE_GEOMETRIC // When growing, request at least 1.5x old_size
+} fossil_sys_memory_resize_policy_t;
+
+/**
+ * Resize memory, growing in place when possible.
+ *
+ * Slack already present in the block is reused without calling the
+ * allocator; otherwise the block is reallocated, which extends it in place
+ * when the neighbouring space is free. With the geometric policy a run of
+ * small growths costs amortised O(1) per byte.
+ *
+ * @param ptr A pointer to the memory to resize.
+ * @param old_size The old size of the memory.
+ * @param new_size The new size of the memory (0 frees the block).
+ * @param policy Growth policy.
+ * @param out_capacity Receives the usable size of the returned block (can be NULL).
+ * @param out_moved Receives true if the block moved, so callers can skip pointer fix-ups otherwise (can be NULL).
+ * @return A pointer to the resized memory, or NULL on failure (the original block is left untouched).
+ */
+fossil_sys_memory_t fossil_sys_memory_resize_ex(fossil_sys_memory_t ptr, size_t old_size, size_t new_size,
+                                               fossil_sys_memory_resize_policy_t policy,
+                                               size_t *out_capacity, bool *out_moved);
+
 /**
  * Check if a memory pointer is valid.
  *
@@ -166,6 +195,48 @@ fossil_sys_memory_t fossil_sys_memory_resize(fossil_sys_memory_t ptr, size_t old
  */
 bool fossil_sys_memory_is_valid(const fossil_sys_memory_t ptr);
 
+/**
+ * @brief Allocate aligned memory.
+ *
+ * Useful for cache-line (64-byte) aligned tables that must not share
+ * lines with neighbouring data.
+ *
+ * @param size The size of the memory to allocate.
+ * @param alignment Required alignment in bytes, must be a power of two.
+ * @return A pointer to the aligned memory, or NULL on failure.
+ * @note Release with fossil_sys_memory_free_aligned.
+ */
+fossil_sys_memory_t fossil_sys_memory_alloc_aligned(size_t size, size_t alignment);
+
+/**
+ * @brief Free memory obtained from fossil_sys_memory_alloc_aligned.
+ *
+ * @param ptr A pointer to the aligned memory (can be NULL).
+ */
+void fossil_sys_memory_free_aligned(fossil_sys_memory_t ptr);
+
+/**
+ * @brief Allocate memory backed by huge pages where the platform allows it.
+ *
+ * On Linux this first tries explicit 2 MiB huge pages (MAP_HUGETLB with
+ * MAP_HUGE_2MB) and falls back to a 2 MiB aligned mapping advised for
+ * transparent huge pages (MADV_HUGEPAGE). Other platforms use large pages
+ * when available and regular pages otherwise. The memory is zero-filled and page aligned.
+ *
+ * @param size The size of the memory to allocate (rounded up to 2 MiB).
+ * @return A pointer to the memory, or NULL on failure.
+ * @note Release with fossil_sys_memory_free_huge using the same size.
+ */
+fossil_sys_memory_t fossil_sys_memory_alloc_huge(size_t size);
+
+/**
+ * @brief Free memory obtained from fossil_sys_memory_alloc_huge.
+ *
+ * @param ptr A pointer to the memory (can be NULL).
+ * @param size The size passed to fossil_sys_memory_alloc_huge.
+ */
+void fossil_sys_memory_free_huge(fossil_sys_memory_t ptr, size_t size);
+
 /**
  * @brief Fill memory with a repeating pattern.
  *
@@ -217,6 +288,78 @@ void fossil_sys_memory_swap(fossil_sys_memory_t a, fossil_sys_memory_t b, size_t
  */
 void *fossil_sys_memory_find(const fossil_sys_memory_t ptr, uint8_t value, size_t size);
 
+/**
+ * @brief Get the instruction set used by the bulk memory kernels.
+ *
+ * fossil_sys_memory_swap, fossil_sys_memory_find, fossil_sys_memory_compare
+ * and fossil_sys_memory_fill dispatch once, on first use, to the widest
+ * kernel set the CPU supports. The FOSSIL_SYS_MEMORY_SIMD environment
+ * variable may name a lower level to force it.
+ *
+ * @return One of "avx512", "avx2", "sse2", "neon" or "scalar".
+ */
+const char *fossil_sys_memory_simd_level(void);
+
+/**
+ * @brief Report whether the guard-page debug allocator is active.
+ *
+ * When FOSSIL_SYS_MEMORY_GUARD=1 is set in the environment (or the library
+ * was built with -DFOSSIL_SYS_MEMORY_GUARD=1), every fossil_sys_memory_*
+ * allocation gets its own mapping with inaccessible pages on both sides and
+ * its last byte flush against the trailing guard, so overruns fault
+ * immediately. Freed blocks stay mapped but inaccessible for a window of
+ * FOSSIL_SYS_MEMORY_GUARD_QUARANTINE frees (default 1024), so use after free
+ * faults too. Each allocation costs at least three pages of address space;
+ * raise vm.max_map_count for large soak runs. The mode is fixed on first use.
+ *
+ * @return true if guard mode is active.
+ */
+bool fossil_sys_memory_guard_enabled(void);
+
+/**
+ * Output formats for fossil_sys_memory_profile_dump.
+ */
+typedef enum
+{
+    FOSSIL_SYS_MEMORY_PROFILE_PPROF, // gperftools heap profile text, readable by pprof
+    FOSSIL_SYS_MEMORY_PROFILE_FOLDED // "frame;frame;frame bytes" lines for flame graphs
+} fossil_sys_memory_profile_format_t;
+
+/**
+ * @brief Start the sampling heap profiler.
+ *
+ * Allocations made through fossil_sys_memory_alloc, calloc, realloc, resize
+ * and strdup are Poisson-sampled: on average one backtrace is recorded per
+ * sample_bytes allocated, so the cost is independent of allocation counts.
+ * Sampled blocks are tracked until freed, so a dump shows which call stacks
+ * hold live memory. Starting again discards the previous profile. Link with
+ * -rdynamic for symbol names in folded dumps.
+ *
+ * @param sample_bytes Mean bytes between samples (0 selects 512 KiB).
+ * @return 0 on success, -1 if the profile tables cannot be allocated.
+ */
+int fossil_sys_memory_profile_start(size_t sample_bytes);
+
+/**
+ * @brief Stop taking new samples.
+ *
+ * Recorded samples are kept, and still retired when their blocks are freed,
+ * until the profiler is started again.
+ */
+void fossil_sys_memory_profile_stop(void);
+
+/**
+ * @brief Write the live-heap profile to a file.
+ *
+ * The pprof format carries raw sample counts and the sampling rate, and pprof
+ * scales them itself. The folded format is weighted by estimated live bytes.
+ *
+ * @param path Output file path.
+ * @param format Output format.
+ * @return 0 on success, -1 on failure.
+ */
+int fossil_sys_memory_profile_dump(const char *path, fossil_sys_memory_profile_format_t format);
+
 /**
  * @brief Duplicate a NULL-terminated string using memory API.
  *
@@ -231,16 +374,189 @@ char *fossil_sys_memory_strdup(const char *str);
 /**
  * @brief Get memory usage statistics.
  *
- * Returns current allocation count and optionally total allocated bytes.
- * (Useful for leak detection in debug builds.)
+ * Returns the number of live allocations and the bytes they occupy.
+ * (Useful for leak detection.)
  *
- * @param out_allocs Pointer to receive allocation count (can be NULL).
- * @param out_bytes Pointer to receive total allocated bytes (can be NULL).
+ * @param out_allocs Pointer to receive the live allocation count (can be NULL).
+ * @param out_bytes Pointer to receive the live allocated bytes (can be NULL).
  */
 void fossil_sys_memory_stats(size_t *out_allocs, size_t *out_bytes);
 
+#define FOSSIL_SYS_MEMORY_SIZE_CLASSES 16
+
+/**
+ * Detailed allocation statistics.
+ *
+ * Counters are kept per thread and summed when read, so a snapshot taken
+ * while other threads allocate is approximate. Byte counts use the usable
+ * size reported by the platform allocator where available.
+ */
+typedef struct
+{
+    uint64_t alloc_count;   // Successful alloc/calloc/dup/strdup allocations
+    uint64_t realloc_count; // Successful realloc/resize calls
+    uint64_t free_count;    // Blocks released through fossil_sys_memory_free
+    uint64_t alloc_bytes;   // Total bytes requested over the process lifetime
+    uint64_t live_bytes;    // Bytes currently allocated
+    uint64_t peak_bytes;    // Highest observed live_bytes (within 64 KiB per thread)
+    // Allocation counts by requested size: class 0 holds sizes up to 16 bytes,
+    // class i holds sizes in (2^(i+3), 2^(i+4)], the last class holds the rest.
+    uint64_t size_classes[FOSSIL_SYS_MEMORY_SIZE_CLASSES];
+} fossil_sys_memory_stats_t;
+
+/**
+ * @brief Get detailed memory usage statistics.
+ *
+ * @param out Pointer to receive the statistics.
+ */
+void fossil_sys_memory_get_stats(fossil_sys_memory_stats_t *out);
+
+// ----------------------- Arena Allocator -----------------------
+
+/**
+ * Opaque arena (region) allocator handle.
+ *
+ * An arena hands out memory by bumping an offset inside large blocks and
+ * releases everything at once, so per-request scratch memory needs no
+ * matching free calls. Arenas are not thread-safe; use one per thread.
+ */
+typedef struct fossil_sys_memory_arena fossil_sys_memory_arena_t;
+
+/**
+ * Saved arena position, produced by fossil_sys_memory_arena_mark.
+ */
+typedef struct
+{
+    void *block;   // Block that was current when the mark was taken
+    size_t offset; // Bytes used in that block
+} fossil_sys_memory_arena_mark_t;
+
+/**
+ * @brief Create an arena.
+ *
+ * @param block_size Size of each backing block in bytes (0 selects a default of 64 KiB).
+ * @return A pointer to the new arena, or NULL on failure.
+ */
+fossil_sys_memory_arena_t *fossil_sys_memory_arena_create(size_t block_size);
+
+/**
+ * @brief Allocate memory from an arena.
+ *
+ * The memory is aligned for any fundamental type and stays valid until the
+ * arena is rewound past it, reset or destroyed.
+ *
+ * @param arena The arena to allocate from.
+ * @param size Number of bytes to allocate.
+ * @return A pointer to the memory, or NULL on failure.
+ */
+fossil_sys_memory_t fossil_sys_memory_arena_alloc(fossil_sys_memory_arena_t *arena, size_t size);
+
+/**
+ * @brief Allocate aligned memory from an arena.
+ *
+ * @param arena The arena to allocate from.
+ * @param size Number of bytes to allocate.
+ * @param alignment Required alignment, must be a power of two.
+ * @return A pointer to the memory, or NULL on failure.
+ */
+fossil_sys_memory_t fossil_sys_memory_arena_alloc_aligned(fossil_sys_memory_arena_t *arena, size_t size, size_t alignment);
+
+/**
+ * @brief Record the current arena position.
+ *
+ * @param arena The arena.
+ * @return A mark that can later be passed to fossil_sys_memory_arena_rewind.
+ */
+fossil_sys_memory_arena_mark_t fossil_sys_memory_arena_mark(const fossil_sys_memory_arena_t *arena);
+
+/**
+ * @brief Release every allocation made after a mark was taken.
+ *
+ * Blocks are kept for reuse, so this is O(1).
+ *
+ * @param arena The arena.
+ * @param mark A mark previously obtained from the same arena.
+ */
+void fossil_sys_memory_arena_rewind(fossil_sys_memory_arena_t *arena, fossil_sys_memory_arena_mark_t mark);
+
+/**
+ * @brief Release every allocation in the arena, keeping its blocks for reuse.
+ *
+ * @param arena The arena.
+ */
+void fossil_sys_memory_arena_reset(fossil_sys_memory_arena_t *arena);
+
+/**
+ * @brief Destroy an arena and return all of its blocks to the system.
+ *
+ * @param arena The arena (can be NULL).
+ */
+void fossil_sys_memory_arena_destroy(fossil_sys_memory_arena_t *arena);
+
+// ----------------------- Object Pool -----------------------
+
+/**
+ * Opaque fixed-size object pool handle.
+ *
+ * Objects are carved from large slabs and recycled through per-thread
+ * magazines, so the common alloc/free pair touches no shared state. Full
+ * or empty magazines are exchanged with a global depot, which also absorbs
+ * objects freed on a different thread than the one that allocated them.
+ */
+typedef struct fossil_sys_memory_pool fossil_sys_memory_pool_t;
+
+/**
+ * @brief Create an object pool.
+ *
+ * @param object_size Size of every object in bytes.
+ * @param objects_per_slab Number of objects carved from each slab (0 selects a default).
+ * @return A pointer to the new pool, or NULL on failure.
+ */
+fossil_sys_memory_pool_t *fossil_sys_memory_pool_create(size_t object_size, size_t objects_per_slab);
+
+/**
+ * @brief Allocate one object from a pool.
+ *
+ * The object is aligned for any fundamental type whose size does not
+ * exceed the pool's object size. Safe to call from any thread.
+ *
+ * @param pool The pool to allocate from.
+ * @return A pointer to the object, or NULL on failure.
+ */
+fossil_sys_memory_t fossil_sys_memory_pool_alloc(fossil_sys_memory_pool_t *pool);
+
+/**
+ * @brief Return an object to its pool.
+ *
+ * The object may be freed from any thread, not just the one that allocated it.
+ *
+ * @param pool The pool the object was allocated from.
+ * @param ptr The object to free.
+ */
+void fossil_sys_memory_pool_free(fossil_sys_memory_pool_t *pool, fossil_sys_memory_t ptr);
+
+/**
+ * @brief Get the object size a pool hands out.
+ *
+ * @param pool The pool.
+ * @return The usable size of each object (at least the requested size), or 0 if pool is NULL.
+ */
+size_t fossil_sys_memory_pool_object_size(const fossil_sys_memory_pool_t *pool);
+
+/**
+ * @brief Destroy a pool and release all of its slabs.
+ *
+ * Every object allocated from the pool becomes invalid. No other thread may
+ * be using the pool while it is destroyed.
+ *
+ * @param pool The pool (can be NULL).
+ */
+void fossil_sys_memory_pool_destroy(fossil_sys_memory_pool_t *pool);
+
 #ifdef __cplusplus
 }
+#include <new>
+#include <utility>
 
 /**
  * Fossil namespace.
@@ -400,6 +716,24 @@ namespace fossil::sys
             return fossil_sys_memory_resize(ptr, old_size, new_size);
         }
 
+        /**
+         * Resize memory, growing in place when possible.
+         *
+         * @param ptr A pointer to the memory to resize.
+         * @param old_size The old size of the memory.
+         * @param new_size The new size of the memory.
+         * @param policy Growth policy.
+         * @param out_capacity Receives the usable size of the returned block (can be nullptr).
+         * @param out_moved Receives true if the block moved (can be nullptr).
+         * @return A pointer to the resized memory, or nullptr on failure.
+         */
+        static fossil_sys_memory_t resize_ex(fossil_sys_memory_t ptr, size_t old_size, size_t new_size,
+                                             fossil_sys_memory_resize_policy_t policy,
+                                             size_t *out_capacity = nullptr, bool *out_moved = nullptr)
+        {
+            return fossil_sys_memory_resize_ex(ptr, old_size, new_size, policy, out_capacity, out_moved);
+        }
+
         /**
          * Check if a memory pointer is valid.
          *
@@ -411,6 +745,50 @@ namespace fossil::sys
             return fossil_sys_memory_is_valid(ptr);
         }
 
+        /**
+         * Allocate aligned memory.
+         *
+         * @param size The size of the memory to allocate.
+         * @param alignment Required alignment in bytes, must be a power of two.
+         * @return A pointer to the aligned memory, or nullptr on failure.
+         */
+        static fossil_sys_memory_t alloc_aligned(size_t size, size_t alignment)
+        {
+            return fossil_sys_memory_alloc_aligned(size, alignment);
+        }
+
+        /**
+         * Free memory obtained from alloc_aligned.
+         *
+         * @param ptr A pointer to the aligned memory.
+         */
+        static void free_aligned(fossil_sys_memory_t ptr)
+        {
+            fossil_sys_memory_free_aligned(ptr);
+        }
+
+        /**
+         * Allocate memory backed by huge pages where available.
+         *
+         * @param size The size of the memory to allocate.
+         * @return A pointer to the memory, or nullptr on failure.
+         */
+        static fossil_sys_memory_t alloc_huge(size_t size)
+        {
+            return fossil_sys_memory_alloc_huge(size);
+        }
+
+        /**
+         * Free memory obtained from alloc_huge.
+         *
+         * @param ptr A pointer to the memory.
+         * @param size The size passed to alloc_huge.
+         */
+        static void free_huge(fossil_sys_memory_t ptr, size_t size)
+        {
+            fossil_sys_memory_free_huge(ptr, size);
+        }
+
         /**
          * Fill memory with a repeating pattern.
          *
@@ -461,6 +839,57 @@ namespace fossil::sys
             return fossil_sys_memory_find(ptr, value, size);
         }
 
+        /**
+         * Get the instruction set used by the bulk memory kernels.
+         *
+         * @return One of "avx512", "avx2", "sse2", "neon" or "scalar".
+         */
+        static const char *simd_level()
+        {
+            return fossil_sys_memory_simd_level();
+        }
+
+        /**
+         * Report whether the guard-page debug allocator is active.
+         *
+         * @return true if guard mode is active.
+         */
+        static bool guard_enabled()
+        {
+            return fossil_sys_memory_guard_enabled();
+        }
+
+        /**
+         * Start the sampling heap profiler.
+         *
+         * @param sample_bytes Mean bytes between samples (0 selects 512 KiB).
+         * @return 0 on success, -1 on failure.
+         */
+        static int profile_start(size_t sample_bytes = 0)
+        {
+            return fossil_sys_memory_profile_start(sample_bytes);
+        }
+
+        /**
+         * Stop taking new samples; recorded samples are kept.
+         */
+        static void profile_stop()
+        {
+            fossil_sys_memory_profile_stop();
+        }
+
+        /**
+         * Write the live-heap profile to a file.
+         *
+         * @param path Output file path.
+         * @param format Output format.
+         * @return 0 on success, -1 on failure.
+         */
+        static int profile_dump(const char *path, fossil_sys_memory_profile_format_t format)
+        {
+            return fossil_sys_memory_profile_dump(path, format);
+        }
+
         /**
          * Duplicate a NULL-terminated string using memory API.
          *
@@ -482,6 +911,235 @@ namespace fossil::sys
         {
             fossil_sys_memory_stats(out_allocs, out_bytes);
         }
+
+        /**
+         * Get detailed memory usage statistics.
+         *
+         * @return The aggregated statistics.
+         */
+        static fossil_sys_memory_stats_t get_stats()
+        {
+            fossil_sys_memory_stats_t out;
+            fossil_sys_memory_get_stats(&out);
+            return out;
+        }
+    };
+
+    /**
+     * Arena (region) allocator with RAII ownership.
+     *
+     * Memory handed out by the arena is released all at once when the arena
+     * is reset, rewound or destroyed.
+     */
+    class Arena
+    {
+    public:
+        /**
+         * Create an arena.
+         *
+         * @param block_size Size of each backing block in bytes (0 selects the default).
+         */
+        explicit Arena(size_t block_size = 0) : arena_(fossil_sys_memory_arena_create(block_size))
+        {
+        }
+
+        ~Arena()
+        {
+            fossil_sys_memory_arena_destroy(arena_);
+        }
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        Arena(Arena &&other) noexcept : arena_(other.arena_)
+        {
+            other.arena_ = nullptr;
+        }
+
+        Arena &operator=(Arena &&other) noexcept
+        {
+            if (this != &other)
+            {
+                fossil_sys_memory_arena_destroy(arena_);
+                arena_ = other.arena_;
+                other.arena_ = nullptr;
+            }
+            return *this;
+        }
+
+        /**
+         * Allocate memory from the arena.
+         *
+         * @param size Number of bytes to allocate.
+         * @return A pointer to the memory, or nullptr on failure.
+         */
+        fossil_sys_memory_t alloc(size_t size)
+        {
+            return fossil_sys_memory_arena_alloc(arena_, size);
+        }
+
+        /**
+         * Allocate aligned memory from the arena.
+         *
+         * @param size Number of bytes to allocate.
+         * @param alignment Required alignment, must be a power of two.
+         * @return A pointer to the memory, or nullptr on failure.
+         */
+        fossil_sys_memory_t alloc_aligned(size_t size, size_t alignment)
+        {
+            return fossil_sys_memory_arena_alloc_aligned(arena_, size, alignment);
+        }
+
+        /**
+         * Record the current arena position.
+         *
+         * @return A mark that can be passed to rewind().
+         */
+        fossil_sys_memory_arena_mark_t mark() const
+        {
+            return fossil_sys_memory_arena_mark(arena_);
+        }
+
+        /**
+         * Release every allocation made after a mark was taken.
+         *
+         * @param mark A mark previously obtained from this arena.
+         */
+        void rewind(fossil_sys_memory_arena_mark_t mark)
+        {
+            fossil_sys_memory_arena_rewind(arena_, mark);
+        }
+
+        /**
+         * Release every allocation in the arena.
+         */
+        void reset()
+        {
+            fossil_sys_memory_arena_reset(arena_);
+        }
+
+        /**
+         * Access the underlying C handle.
+         *
+         * @return The arena handle.
+         */
+        fossil_sys_memory_arena_t *handle() const
+        {
+            return arena_;
+        }
+
+    private:
+        fossil_sys_memory_arena_t *arena_;
+    };
+
+    /**
+     * Typed fixed-size object pool.
+     *
+     * @tparam T Type of the pooled objects.
+     */
+    template <typename T>
+    class Pool
+    {
+        static_assert(alignof(T) <= alignof(max_align_t), "over-aligned types are not supported");
+
+    public:
+        /**
+         * Create a pool for objects of type T.
+         *
+         * @param objects_per_slab Number of objects carved from each slab (0 selects the default).
+         */
+        explicit Pool(size_t objects_per_slab = 0)
+            : pool_(fossil_sys_memory_pool_create(sizeof(T), objects_per_slab))
+        {
+        }
+
+        ~Pool()
+        {
+            fossil_sys_memory_pool_destroy(pool_);
+        }
+
+        Pool(const Pool &) = delete;
+        Pool &operator=(const Pool &) = delete;
+
+        Pool(Pool &&other) noexcept : pool_(other.pool_)
+        {
+            other.pool_ = nullptr;
+        }
+
+        Pool &operator=(Pool &&other) noexcept
+        {
+            if (this != &other)
+            {
+                fossil_sys_memory_pool_destroy(pool_);
+                pool_ = other.pool_;
+                other.pool_ = nullptr;
+            }
+            return *this;
+        }
+
+        /**
+         * Allocate raw storage for one T without constructing it.
+         *
+         * @return A pointer to the storage, or nullptr on failure.
+         */
+        void *allocate()
+        {
+            return fossil_sys_memory_pool_alloc(pool_);
+        }
+
+        /**
+         * Return raw storage obtained from allocate().
+         *
+         * @param ptr The storage to release.
+         */
+        void deallocate(void *ptr)
+        {
+            fossil_sys_memory_pool_free(pool_, ptr);
+        }
+
+        /**
+         * Allocate and construct a T.
+         *
+         * @param args Constructor arguments.
+         * @return A pointer to the new object, or nullptr on allocation failure.
+         */
+        template <typename... Args>
+        T *create(Args &&...args)
+        {
+            void *mem = allocate();
+            if (!mem)
+            {
+                return nullptr;
+            }
+            return new (mem) T(std::forward<Args>(args)...);
+        }
+
+        /**
+         * Destroy a T created with create() and return its storage.
+         *
+         * @param obj The object to destroy (can be nullptr).
+         */
+        void destroy(T *obj)
+        {
+            if (obj)
+            {
+                obj->~T();
+                deallocate(obj);
+            }
+        }
+
+        /**
+         * Access the underlying C handle.
+         *
+         * @return The pool handle.
+         */
+        fossil_sys_memory_pool_t *handle() const
+        {
+            return pool_;
+        }
+
+    private:
+        fossil_sys_memory_pool_t *pool_;
     };
 
 }
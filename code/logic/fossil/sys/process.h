@@ -43,7 +43,7 @@ typedef struct
     char name[FOSSIL_SYS_PROCESS_NAME_MAX]; // Process name
     uint64_t memory_bytes;                  // Resident memory
     uint64_t virtual_memory_bytes;          // Virtual memory
-    float cpu_percent;                      // CPU usage %
+    float cpu_percent;                      // CPU usage % (0 unless read through a sampler)
     uint32_t thread_count;                  // Number of threads
 } fossil_sys_process_info_t;
 
@@ -185,6 +185,57 @@ int fossil_sys_process_get_ppid(uint32_t pid);
  */
 int fossil_sys_process_send_signal(uint32_t pid, int signal);
 
+/**
+ * CPU usage sampler
+ *
+ * fossil_sys_process_info_t.cpu_percent needs two readings of a
+ * process's CPU time. A sampler remembers the last reading of every
+ * pid it has seen, so each refresh or get_info through it reports the
+ * usage since the previous one. 100 means one CPU fully busy. A pid's
+ * first sample reports 0, and samples less than 100 ms apart repeat
+ * the previous value. Exited processes are forgotten on their own.
+ * A sampler must not be used from two threads at once.
+ */
+typedef struct fossil_sys_process_sampler fossil_sys_process_sampler_t;
+
+/**
+ * Create a CPU usage sampler.
+ *
+ * @param expected Number of processes expected, to size the table (0 = small default)
+ * @return Sampler, or NULL on allocation failure
+ */
+fossil_sys_process_sampler_t *fossil_sys_process_sampler_create(size_t expected);
+
+/**
+ * Destroy a sampler. NULL is ignored.
+ *
+ * @param sampler Sampler to destroy
+ */
+void fossil_sys_process_sampler_destroy(fossil_sys_process_sampler_t *sampler);
+
+/**
+ * Sample every running process, like fossil_sys_process_list with
+ * cpu_percent filled in. Processes past FOSSIL_SYS_PROCESS_MAX are
+ * still sampled but not listed.
+ *
+ * @param sampler Sampler to update
+ * @param plist List to fill (can be NULL to only update the sampler)
+ * @return 0 on success, negative error code on failure
+ */
+int fossil_sys_process_sampler_refresh(fossil_sys_process_sampler_t *sampler, fossil_sys_process_list_t *plist);
+
+/**
+ * Sample one process, like fossil_sys_process_get_info with
+ * cpu_percent filled in.
+ *
+ * @param sampler Sampler to update
+ * @param pid Process ID
+ * @param info Filled with the process information
+ * @return 0 on success, negative error code on failure (including no such process)
+ */
+int fossil_sys_process_sampler_get_info(fossil_sys_process_sampler_t *sampler, uint32_t pid,
+                                        fossil_sys_process_info_t *info);
+
 #ifdef __cplusplus
 }
 #include <string>
@@ -403,6 +454,91 @@ namespace fossil::sys
         {
             return fossil_sys_process_send_signal(pid, signal);
         }
+
+        /**
+         * @brief RAII wrapper for a CPU usage sampler.
+         */
+        class Sampler
+        {
+        public:
+            /**
+             * @brief Creates a sampler.
+             *
+             * @param expected Number of processes expected (0 = small default).
+             */
+            explicit Sampler(size_t expected = 0)
+                : sampler_(fossil_sys_process_sampler_create(expected))
+            {
+            }
+
+            ~Sampler()
+            {
+                fossil_sys_process_sampler_destroy(sampler_);
+            }
+
+            Sampler(const Sampler &) = delete;
+            Sampler &operator=(const Sampler &) = delete;
+
+            Sampler(Sampler &&other) noexcept : sampler_(other.sampler_)
+            {
+                other.sampler_ = nullptr;
+            }
+
+            Sampler &operator=(Sampler &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    fossil_sys_process_sampler_destroy(sampler_);
+                    sampler_ = other.sampler_;
+                    other.sampler_ = nullptr;
+                }
+                return *this;
+            }
+
+            /**
+             * @brief Samples every running process.
+             *
+             * @param plist Reference to a list filled with the processes and their CPU usage.
+             * @return int 0 on success, or a negative error code on failure.
+             */
+            int refresh(fossil_sys_process_list_t &plist)
+            {
+                return fossil_sys_process_sampler_refresh(sampler_, &plist);
+            }
+
+            /**
+             * @brief Samples every running process without listing them.
+             *
+             * @return int 0 on success, or a negative error code on failure.
+             */
+            int refresh()
+            {
+                return fossil_sys_process_sampler_refresh(sampler_, nullptr);
+            }
+
+            /**
+             * @brief Samples one process.
+             *
+             * @param pid The process ID of the target process.
+             * @param info Reference filled with the process information and its CPU usage.
+             * @return int 0 on success, or a negative error code on failure.
+             */
+            int get_info(uint32_t pid, fossil_sys_process_info_t &info)
+            {
+                return fossil_sys_process_sampler_get_info(sampler_, pid, &info);
+            }
+
+            /**
+             * @brief Access the underlying C handle.
+             */
+            fossil_sys_process_sampler_t *handle() const
+            {
+                return sampler_;
+            }
+
+        private:
+            fossil_sys_process_sampler_t *sampler_;
+        };
     };
 
 }
@@ -22,14 +22,1483 @@
  * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
  * -----------------------------------------------------------------------------
  */
+// Must be defined before any system header for MAP_ANONYMOUS, MAP_HUGETLB, madvise and explicit_bzero
+#if defined(__linux__)
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+#elif defined(__APPLE__)
+#ifndef _DARWIN_C_SOURCE
+#define _DARWIN_C_SOURCE
+#endif
+#define __STDC_WANT_LIB_EXT1__ 1 // memset_s
+#endif
+
 #include "fossil/sys/memory.h"
 #include <stdlib.h> // Needed for posix_memalign
 #include <string.h>
 #include <stdio.h>
+#include <stdatomic.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <malloc.h> // _msize
+#define FOSSIL_SYS_USABLE_SIZE(p) _msize(p)
+#else
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h> // sysconf
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#define FOSSIL_SYS_USABLE_SIZE(p) malloc_size(p)
+#elif defined(__linux__)
+#include <malloc.h> // malloc_usable_size
+#define FOSSIL_SYS_USABLE_SIZE(p) malloc_usable_size(p)
+#endif
+#endif
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h> // backtrace for the heap profiler
+#define FOSSIL_SYS_PROFILE_BACKTRACE 1
+#endif
+
+#ifndef FOSSIL_SYS_USABLE_SIZE
+#define FOSSIL_SYS_USABLE_SIZE(p) ((void)(p), (size_t)0) // Live byte tracking unavailable
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FOSSIL_SYS_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FOSSIL_SYS_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#define FOSSIL_SYS_THREAD_LOCAL __declspec(thread)
+#else
+#define FOSSIL_SYS_THREAD_LOCAL _Thread_local
+#endif
+
+// ----------------------- Internal Lock -----------------------
+
+#if defined(_WIN32)
+typedef SRWLOCK fossil_sys_memory_lock_t;
+#define FOSSIL_SYS_MEMORY_LOCK_INITIALIZER SRWLOCK_INIT
+
+static void fossil_sys_memory_lock_init(fossil_sys_memory_lock_t *lock) { InitializeSRWLock(lock); }
+static void fossil_sys_memory_lock_acquire(fossil_sys_memory_lock_t *lock) { AcquireSRWLockExclusive(lock); }
+static void fossil_sys_memory_lock_release(fossil_sys_memory_lock_t *lock) { ReleaseSRWLockExclusive(lock); }
+static void fossil_sys_memory_lock_destroy(fossil_sys_memory_lock_t *lock) { (void)lock; }
+#else
+typedef pthread_mutex_t fossil_sys_memory_lock_t;
+#define FOSSIL_SYS_MEMORY_LOCK_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+
+static void fossil_sys_memory_lock_init(fossil_sys_memory_lock_t *lock) { pthread_mutex_init(lock, NULL); }
+static void fossil_sys_memory_lock_acquire(fossil_sys_memory_lock_t *lock) { pthread_mutex_lock(lock); }
+static void fossil_sys_memory_lock_release(fossil_sys_memory_lock_t *lock) { pthread_mutex_unlock(lock); }
+static void fossil_sys_memory_lock_destroy(fossil_sys_memory_lock_t *lock) { pthread_mutex_destroy(lock); }
+#endif
+
+// ----------------------- Allocation Accounting -----------------------
+
+// Every thread owns one stats block and is its only writer, so counters are
+// bumped with a relaxed load/store pair instead of a shared atomic RMW.
+// Readers walk the registry and sum all blocks.
+
+#define FOSSIL_SYS_STATS_PUBLISH (64 * 1024) // Live-byte drift before a thread updates the global peak
+
+typedef struct fossil_sys_stats_block
+{
+    struct fossil_sys_stats_block *next; // Registry link, immutable once published
+    atomic_bool in_use;                  // Cleared when the owning thread exits so the block can be reused
+    _Atomic uint64_t alloc_count;
+    _Atomic uint64_t realloc_count;
+    _Atomic uint64_t free_count;
+    _Atomic uint64_t alloc_bytes;
+    _Atomic int64_t live_bytes; // Signed: a thread may free blocks another thread allocated
+    _Atomic uint64_t size_classes[FOSSIL_SYS_MEMORY_SIZE_CLASSES];
+    int64_t unpublished; // Owner-only live-byte delta not yet folded into g_stats_live
+} fossil_sys_stats_block_t;
+
+static _Atomic(fossil_sys_stats_block_t *) g_stats_head = NULL;
+static _Atomic int64_t g_stats_live = 0; // Published live bytes, only used to track the peak
+static _Atomic uint64_t g_stats_peak = 0;
+static FOSSIL_SYS_THREAD_LOCAL fossil_sys_stats_block_t *g_stats_local = NULL;
+
+static void fossil_sys_stats_publish(fossil_sys_stats_block_t *block)
+{
+    int64_t live = atomic_fetch_add_explicit(&g_stats_live, block->unpublished, memory_order_relaxed) + block->unpublished;
+    block->unpublished = 0;
+
+    uint64_t peak = atomic_load_explicit(&g_stats_peak, memory_order_relaxed);
+    while (live > 0 && (uint64_t)live > peak &&
+           !atomic_compare_exchange_weak_explicit(&g_stats_peak, &peak, (uint64_t)live,
+                                                  memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+}
+
+// Runs at thread exit and hands the thread's block back for adoption.
+static void fossil_sys_stats_detach(fossil_sys_stats_block_t *block)
+{
+    fossil_sys_stats_publish(block);
+    g_stats_local = NULL;
+    atomic_store_explicit(&block->in_use, false, memory_order_release);
+}
+
+#if defined(_WIN32)
+// Windows has no thread-local destructors; a fiber-local slot's callback
+// runs when the thread (or fiber) exits, which is the nearest equivalent.
+static DWORD g_stats_key = FLS_OUT_OF_INDEXES;
+static INIT_ONCE g_stats_once = INIT_ONCE_STATIC_INIT;
+
+static VOID NTAPI fossil_sys_stats_release(PVOID arg)
+{
+    fossil_sys_stats_detach((fossil_sys_stats_block_t *)arg);
+}
+
+static BOOL CALLBACK fossil_sys_stats_key_init(PINIT_ONCE once, PVOID param, PVOID *context)
+{
+    (void)once;
+    (void)param;
+    (void)context;
+    g_stats_key = FlsAlloc(fossil_sys_stats_release);
+    return TRUE;
+}
+#else
+static pthread_key_t g_stats_key;
+static pthread_once_t g_stats_once = PTHREAD_ONCE_INIT;
+
+static void fossil_sys_stats_release(void *arg)
+{
+    fossil_sys_stats_detach((fossil_sys_stats_block_t *)arg);
+}
+
+static void fossil_sys_stats_key_init(void)
+{
+    pthread_key_create(&g_stats_key, fossil_sys_stats_release);
+}
+#endif
+
+static fossil_sys_stats_block_t *fossil_sys_stats_attach(void)
+{
+    // Adopt a block left behind by an exited thread before growing the registry.
+    // Its counters carry over, which keeps the process-wide totals intact.
+    fossil_sys_stats_block_t *block = atomic_load_explicit(&g_stats_head, memory_order_acquire);
+    for (; block; block = block->next)
+    {
+        bool expected = false;
+        if (!atomic_load_explicit(&block->in_use, memory_order_relaxed) &&
+            atomic_compare_exchange_strong_explicit(&block->in_use, &expected, true,
+                                                    memory_order_acquire, memory_order_relaxed))
+            break;
+    }
+
+    if (!block)
+    {
+        block = (fossil_sys_stats_block_t *)calloc(1, sizeof(*block));
+        if (!block)
+            return NULL;
+        atomic_init(&block->in_use, true);
+        block->next = atomic_load_explicit(&g_stats_head, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&g_stats_head, &block->next, block,
+                                                      memory_order_release, memory_order_relaxed))
+        {
+        }
+    }
+
+#if defined(_WIN32)
+    InitOnceExecuteOnce(&g_stats_once, fossil_sys_stats_key_init, NULL, NULL);
+    if (g_stats_key != FLS_OUT_OF_INDEXES)
+        FlsSetValue(g_stats_key, block);
+#else
+    pthread_once(&g_stats_once, fossil_sys_stats_key_init);
+    pthread_setspecific(g_stats_key, block);
+#endif
+    g_stats_local = block;
+    return block;
+}
+
+static inline fossil_sys_stats_block_t *fossil_sys_stats_local(void)
+{
+    fossil_sys_stats_block_t *block = g_stats_local;
+    return block ? block : fossil_sys_stats_attach();
+}
+
+static inline void fossil_sys_stats_bump(_Atomic uint64_t *counter, uint64_t delta)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + delta, memory_order_relaxed);
+}
+
+static inline void fossil_sys_stats_live(fossil_sys_stats_block_t *block, int64_t delta)
+{
+    atomic_store_explicit(&block->live_bytes, atomic_load_explicit(&block->live_bytes, memory_order_relaxed) + delta,
+                          memory_order_relaxed);
+    block->unpublished += delta;
+    if (block->unpublished >= FOSSIL_SYS_STATS_PUBLISH || block->unpublished <= -FOSSIL_SYS_STATS_PUBLISH)
+        fossil_sys_stats_publish(block);
+}
+
+static inline size_t fossil_sys_stats_class(size_t size)
+{
+    if (size <= 16)
+        return 0;
+#if defined(__GNUC__) || defined(__clang__)
+    size_t cls = (size_t)(64 - __builtin_clzll((unsigned long long)(size - 1))) - 4;
+#else
+    size_t cls = 0;
+    for (size_t limit = 16; size > limit && cls < FOSSIL_SYS_MEMORY_SIZE_CLASSES; limit <<= 1)
+        cls++;
+#endif
+    return cls < FOSSIL_SYS_MEMORY_SIZE_CLASSES ? cls : FOSSIL_SYS_MEMORY_SIZE_CLASSES - 1;
+}
+
+static void fossil_sys_stats_on_alloc(size_t usable, size_t requested)
+{
+    fossil_sys_stats_block_t *block = fossil_sys_stats_local();
+    if (!block)
+        return;
+    fossil_sys_stats_bump(&block->alloc_count, 1);
+    fossil_sys_stats_bump(&block->alloc_bytes, requested);
+    fossil_sys_stats_bump(&block->size_classes[fossil_sys_stats_class(requested)], 1);
+    fossil_sys_stats_live(block, (int64_t)usable);
+}
+
+static void fossil_sys_stats_on_realloc(size_t old_usable, size_t new_usable)
+{
+    fossil_sys_stats_block_t *block = fossil_sys_stats_local();
+    if (!block)
+        return;
+    fossil_sys_stats_bump(&block->realloc_count, 1);
+    fossil_sys_stats_live(block, (int64_t)new_usable - (int64_t)old_usable);
+}
+
+static void fossil_sys_stats_on_free(size_t usable)
+{
+    fossil_sys_stats_block_t *block = fossil_sys_stats_local();
+    if (!block)
+        return;
+    fossil_sys_stats_bump(&block->free_count, 1);
+    fossil_sys_stats_live(block, -(int64_t)usable);
+}
+
+// ----------------------- SIMD Kernels -----------------------
+
+// Bulk swap/find/compare/fill run through a kernel table picked once, on
+// first use, from the instruction sets the CPU and OS actually support.
+// FOSSIL_SYS_MEMORY_SIMD=scalar|sse2|avx2|avx512|neon can force a lower level.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FOSSIL_SYS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define FOSSIL_SYS_TARGET(isa)
+#endif
+
+typedef struct
+{
+    const char *name;
+    void (*swap)(uint8_t *a, uint8_t *b, size_t size);
+    void *(*find)(const uint8_t *ptr, uint8_t value, size_t size);
+    int (*compare)(const uint8_t *a, const uint8_t *b, size_t size);
+    void (*fill)(uint8_t *dst, const uint8_t *pattern, size_t pattern_size, size_t total_size);
+} fossil_sys_memory_kernels_t;
+
+static inline unsigned fossil_sys_ctz32(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctz(x);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return (unsigned)index;
+#else
+    unsigned n = 0;
+    while (!(x & 1u))
+    {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static inline unsigned fossil_sys_ctz64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(x);
+#else
+    uint32_t low = (uint32_t)x;
+    return low ? fossil_sys_ctz32(low) : 32u + fossil_sys_ctz32((uint32_t)(x >> 32));
+#endif
+}
+
+static void fossil_sys_swap_scalar(uint8_t *a, uint8_t *b, size_t size)
+{
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t x, y;
+        memcpy(&x, a + i, sizeof(x));
+        memcpy(&y, b + i, sizeof(y));
+        memcpy(a + i, &y, sizeof(y));
+        memcpy(b + i, &x, sizeof(x));
+    }
+    for (; i < size; i++)
+    {
+        uint8_t tmp = a[i];
+        a[i] = b[i];
+        b[i] = tmp;
+    }
+}
+
+static void *fossil_sys_find_scalar(const uint8_t *ptr, uint8_t value, size_t size)
+{
+    return memchr(ptr, value, size);
+}
+
+static int fossil_sys_compare_scalar(const uint8_t *a, const uint8_t *b, size_t size)
+{
+    return memcmp(a, b, size);
+}
+
+#define FOSSIL_SYS_FILL_CHUNK (64 * 1024)        // Stop doubling once the source prefix would leave L2
+#define FOSSIL_SYS_FILL_LANE 64                  // Splat paths handle power-of-two patterns up to this size
+#define FOSSIL_SYS_FILL_STREAM (8 * 1024 * 1024) // Fills this large bypass the cache on x86
+
+// Log-time fill: write the pattern once, then copy the already-filled prefix
+// onto the rest, doubling it each step until it reaches FOSSIL_SYS_FILL_CHUNK.
+static void fossil_sys_fill_doubling(uint8_t *dst, const uint8_t *pattern, size_t pattern_size, size_t total_size)
+{
+    if (pattern_size == 1)
+    {
+        memset(dst, pattern[0], total_size);
+        return;
+    }
+
+    size_t filled = pattern_size < total_size ? pattern_size : total_size;
+    memcpy(dst, pattern, filled);
+
+    // step is always a whole number of patterns, so every copy stays in phase.
+    size_t step = filled;
+    while (filled < total_size)
+    {
+        size_t n = step < total_size - filled ? step : total_size - filled;
+        memcpy(dst + filled, dst, n);
+        filled += n;
+        if (step < FOSSIL_SYS_FILL_CHUNK)
+            step = filled;
+    }
+}
+
+// Repeats a power-of-two pattern of at most FOSSIL_SYS_FILL_LANE bytes across
+// two lane widths, so a vector loaded at lane + k continues the pattern at phase k.
+static void fossil_sys_fill_lane(uint8_t lane[2 * FOSSIL_SYS_FILL_LANE], const uint8_t *pattern, size_t pattern_size)
+{
+    for (size_t i = 0; i < 2 * FOSSIL_SYS_FILL_LANE; i += pattern_size)
+        memcpy(lane + i, pattern, pattern_size);
+}
+
+// True when the vector splat paths apply: the pattern tiles a 64-byte lane
+// (1, 2, 4, 8, 16, 32 or 64 bytes) and the fill covers at least one lane.
+static inline bool fossil_sys_fill_splat_ok(size_t pattern_size, size_t total_size)
+{
+    return FOSSIL_SYS_FILL_LANE % pattern_size == 0 && total_size >= FOSSIL_SYS_FILL_LANE;
+}
+
+static const fossil_sys_memory_kernels_t g_kernels_scalar = {
+    "scalar", fossil_sys_swap_scalar, fossil_sys_find_scalar, fossil_sys_compare_scalar, fossil_sys_fill_doubling};
+
+#if defined(FOSSIL_SYS_SIMD_X86)
+
+FOSSIL_SYS_TARGET("sse2")
+static void fossil_sys_swap_sse2(uint8_t *a, uint8_t *b, size_t size)
+{
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+        _mm_storeu_si128((__m128i *)(a + i), y);
+        _mm_storeu_si128((__m128i *)(b + i), x);
+    }
+    fossil_sys_swap_scalar(a + i, b + i, size - i);
+}
+
+FOSSIL_SYS_TARGET("sse2")
+static void *fossil_sys_find_sse2(const uint8_t *ptr, uint8_t value, size_t size)
+{
+    __m128i needle = _mm_set1_epi8((char)value);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(ptr + i)), needle));
+        if (mask)
+            return (void *)(ptr + i + fossil_sys_ctz32(mask));
+    }
+    return fossil_sys_find_scalar(ptr + i, value, size - i);
+}
+
+FOSSIL_SYS_TARGET("sse2")
+static int fossil_sys_compare_sse2(const uint8_t *a, const uint8_t *b, size_t size)
+{
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+        uint32_t diff = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) ^ 0xFFFFu;
+        if (diff)
+        {
+            size_t j = i + fossil_sys_ctz32(diff);
+            return (int)a[j] - (int)b[j];
+        }
+    }
+    return fossil_sys_compare_scalar(a + i, b + i, size - i);
+}
+
+FOSSIL_SYS_TARGET("sse2")
+static void fossil_sys_fill_sse2(uint8_t *dst, const uint8_t *pattern, size_t pattern_size, size_t total_size)
+{
+    if (!fossil_sys_fill_splat_ok(pattern_size, total_size))
+    {
+        fossil_sys_fill_doubling(dst, pattern, pattern_size, total_size);
+        return;
+    }
+
+    uint8_t lane[2 * FOSSIL_SYS_FILL_LANE];
+    fossil_sys_fill_lane(lane, pattern, pattern_size);
+
+    // Write an unaligned head so the main loop can use aligned stores.
+    size_t head = (size_t)(-(uintptr_t)dst & (FOSSIL_SYS_FILL_LANE - 1));
+    memcpy(dst, lane, head);
+    const uint8_t *phase = lane + head;
+    __m128i v0 = _mm_loadu_si128((const __m128i *)(phase + 0));
+    __m128i v1 = _mm_loadu_si128((const __m128i *)(phase + 16));
+    __m128i v2 = _mm_loadu_si128((const __m128i *)(phase + 32));
+    __m128i v3 = _mm_loadu_si128((const __m128i *)(phase + 48));
+
+    size_t i = head;
+    if (total_size >= FOSSIL_SYS_FILL_STREAM)
+    {
+        for (; i + 64 <= total_size; i += 64)
+        {
+            _mm_stream_si128((__m128i *)(dst + i + 0), v0);
+            _mm_stream_si128((__m128i *)(dst + i + 16), v1);
+            _mm_stream_si128((__m128i *)(dst + i + 32), v2);
+            _mm_stream_si128((__m128i *)(dst + i + 48), v3);
+        }
+        _mm_sfence();
+    }
+    for (; i + 64 <= total_size; i += 64)
+    {
+        _mm_store_si128((__m128i *)(dst + i + 0), v0);
+        _mm_store_si128((__m128i *)(dst + i + 16), v1);
+        _mm_store_si128((__m128i *)(dst + i + 32), v2);
+        _mm_store_si128((__m128i *)(dst + i + 48), v3);
+    }
+    memcpy(dst + i, phase, total_size - i);
+}
+
+FOSSIL_SYS_TARGET("avx2")
+static void fossil_sys_swap_avx2(uint8_t *a, uint8_t *b, size_t size)
+{
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        _mm256_storeu_si256((__m256i *)(a + i), y);
+        _mm256_storeu_si256((__m256i *)(b + i), x);
+    }
+    fossil_sys_swap_scalar(a + i, b + i, size - i);
+}
+
+FOSSIL_SYS_TARGET("avx2")
+static void *fossil_sys_find_avx2(const uint8_t *ptr, uint8_t value, size_t size)
+{
+    __m256i needle = _mm256_set1_epi8((char)value);
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(ptr + i)), needle));
+        if (mask)
+            return (void *)(ptr + i + fossil_sys_ctz32(mask));
+    }
+    return fossil_sys_find_scalar(ptr + i, value, size - i);
+}
+
+FOSSIL_SYS_TARGET("avx2")
+static int fossil_sys_compare_avx2(const uint8_t *a, const uint8_t *b, size_t size)
+{
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));
+        uint32_t diff = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y));
+        if (diff)
+        {
+            size_t j = i + fossil_sys_ctz32(diff);
+            return (int)a[j] - (int)b[j];
+        }
+    }
+    return fossil_sys_compare_scalar(a + i, b + i, size - i);
+}
+
+FOSSIL_SYS_TARGET("avx2")
+static void fossil_sys_fill_avx2(uint8_t *dst, const uint8_t *pattern, size_t pattern_size, size_t total_size)
+{
+    if (!fossil_sys_fill_splat_ok(pattern_size, total_size))
+    {
+        fossil_sys_fill_doubling(dst, pattern, pattern_size, total_size);
+        return;
+    }
+
+    uint8_t lane[2 * FOSSIL_SYS_FILL_LANE];
+    fossil_sys_fill_lane(lane, pattern, pattern_size);
+
+    size_t head = (size_t)(-(uintptr_t)dst & (FOSSIL_SYS_FILL_LANE - 1));
+    memcpy(dst, lane, head);
+    const uint8_t *phase = lane + head;
+    __m256i v0 = _mm256_loadu_si256((const __m256i *)(phase + 0));
+    __m256i v1 = _mm256_loadu_si256((const __m256i *)(phase + 32));
+
+    size_t i = head;
+    if (total_size >= FOSSIL_SYS_FILL_STREAM)
+    {
+        for (; i + 64 <= total_size; i += 64)
+        {
+            _mm256_stream_si256((__m256i *)(dst + i + 0), v0);
+            _mm256_stream_si256((__m256i *)(dst + i + 32), v1);
+        }
+        _mm_sfence();
+    }
+    for (; i + 64 <= total_size; i += 64)
+    {
+        _mm256_store_si256((__m256i *)(dst + i + 0), v0);
+        _mm256_store_si256((__m256i *)(dst + i + 32), v1);
+    }
+    memcpy(dst + i, phase, total_size - i);
+}
+
+FOSSIL_SYS_TARGET("avx512f,avx512bw")
+static void fossil_sys_swap_avx512(uint8_t *a, uint8_t *b, size_t size)
+{
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64)
+    {
+        __m512i x = _mm512_loadu_si512((const void *)(a + i));
+        __m512i y = _mm512_loadu_si512((const void *)(b + i));
+        _mm512_storeu_si512((void *)(a + i), y);
+        _mm512_storeu_si512((void *)(b + i), x);
+    }
+    fossil_sys_swap_scalar(a + i, b + i, size - i);
+}
+
+FOSSIL_SYS_TARGET("avx512f,avx512bw")
+static void *fossil_sys_find_avx512(const uint8_t *ptr, uint8_t value, size_t size)
+{
+    __m512i needle = _mm512_set1_epi8((char)value);
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64)
+    {
+        uint64_t mask = (uint64_t)_mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const void *)(ptr + i)), needle);
+        if (mask)
+            return (void *)(ptr + i + fossil_sys_ctz64(mask));
+    }
+    return fossil_sys_find_scalar(ptr + i, value, size - i);
+}
+
+FOSSIL_SYS_TARGET("avx512f,avx512bw")
+static int fossil_sys_compare_avx512(const uint8_t *a, const uint8_t *b, size_t size)
+{
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64)
+    {
+        __m512i x = _mm512_loadu_si512((const void *)(a + i));
+        __m512i y = _mm512_loadu_si512((const void *)(b + i));
+        uint64_t diff = (uint64_t)_mm512_cmpneq_epi8_mask(x, y);
+        if (diff)
+        {
+            size_t j = i + fossil_sys_ctz64(diff);
+            return (int)a[j] - (int)b[j];
+        }
+    }
+    return fossil_sys_compare_scalar(a + i, b + i, size - i);
+}
+
+FOSSIL_SYS_TARGET("avx512f,avx512bw")
+static void fossil_sys_fill_avx512(uint8_t *dst, const uint8_t *pattern, size_t pattern_size, size_t total_size)
+{
+    if (!fossil_sys_fill_splat_ok(pattern_size, total_size))
+    {
+        fossil_sys_fill_doubling(dst, pattern, pattern_size, total_size);
+        return;
+    }
+
+    uint8_t lane[2 * FOSSIL_SYS_FILL_LANE];
+    fossil_sys_fill_lane(lane, pattern, pattern_size);
+
+    size_t head = (size_t)(-(uintptr_t)dst & (FOSSIL_SYS_FILL_LANE - 1));
+    memcpy(dst, lane, head);
+    const uint8_t *phase = lane + head;
+    __m512i v = _mm512_loadu_si512((const void *)phase);
+
+    size_t i = head;
+    if (total_size >= FOSSIL_SYS_FILL_STREAM)
+    {
+        for (; i + 64 <= total_size; i += 64)
+            _mm512_stream_si512((void *)(dst + i), v);
+        _mm_sfence();
+    }
+    for (; i + 64 <= total_size; i += 64)
+        _mm512_store_si512((void *)(dst + i), v);
+    memcpy(dst + i, phase, total_size - i);
+}
+
+static const fossil_sys_memory_kernels_t g_kernels_sse2 = {
+    "sse2", fossil_sys_swap_sse2, fossil_sys_find_sse2, fossil_sys_compare_sse2, fossil_sys_fill_sse2};
+static const fossil_sys_memory_kernels_t g_kernels_avx2 = {
+    "avx2", fossil_sys_swap_avx2, fossil_sys_find_avx2, fossil_sys_compare_avx2, fossil_sys_fill_avx2};
+static const fossil_sys_memory_kernels_t g_kernels_avx512 = {
+    "avx512", fossil_sys_swap_avx512, fossil_sys_find_avx512, fossil_sys_compare_avx512, fossil_sys_fill_avx512};
+
+#elif defined(FOSSIL_SYS_SIMD_NEON)
+
+static void fossil_sys_swap_neon(uint8_t *a, uint8_t *b, size_t size)
+{
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        uint8x16_t x = vld1q_u8(a + i);
+        uint8x16_t y = vld1q_u8(b + i);
+        vst1q_u8(a + i, y);
+        vst1q_u8(b + i, x);
+    }
+    fossil_sys_swap_scalar(a + i, b + i, size - i);
+}
+
+static void *fossil_sys_find_neon(const uint8_t *ptr, uint8_t value, size_t size)
+{
+    uint8x16_t needle = vdupq_n_u8(value);
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        if (vmaxvq_u8(vceqq_u8(vld1q_u8(ptr + i), needle)))
+            return fossil_sys_find_scalar(ptr + i, value, 16);
+    }
+    return fossil_sys_find_scalar(ptr + i, value, size - i);
+}
+
+static int fossil_sys_compare_neon(const uint8_t *a, const uint8_t *b, size_t size)
+{
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        if (vminvq_u8(vceqq_u8(vld1q_u8(a + i), vld1q_u8(b + i))) != 0xFF)
+            return fossil_sys_compare_scalar(a + i, b + i, 16);
+    }
+    return fossil_sys_compare_scalar(a + i, b + i, size - i);
+}
+
+static void fossil_sys_fill_neon(uint8_t *dst, const uint8_t *pattern, size_t pattern_size, size_t total_size)
+{
+    if (!fossil_sys_fill_splat_ok(pattern_size, total_size))
+    {
+        fossil_sys_fill_doubling(dst, pattern, pattern_size, total_size);
+        return;
+    }
+
+    uint8_t lane[2 * FOSSIL_SYS_FILL_LANE];
+    fossil_sys_fill_lane(lane, pattern, pattern_size);
+
+    size_t head = (size_t)(-(uintptr_t)dst & (FOSSIL_SYS_FILL_LANE - 1));
+    memcpy(dst, lane, head);
+    const uint8_t *phase = lane + head;
+    uint8x16_t v0 = vld1q_u8(phase + 0);
+    uint8x16_t v1 = vld1q_u8(phase + 16);
+    uint8x16_t v2 = vld1q_u8(phase + 32);
+    uint8x16_t v3 = vld1q_u8(phase + 48);
+
+    size_t i = head;
+    for (; i + 64 <= total_size; i += 64)
+    {
+        vst1q_u8(dst + i + 0, v0);
+        vst1q_u8(dst + i + 16, v1);
+        vst1q_u8(dst + i + 32, v2);
+        vst1q_u8(dst + i + 48, v3);
+    }
+    memcpy(dst + i, phase, total_size - i);
+}
+
+static const fossil_sys_memory_kernels_t g_kernels_neon = {
+    "neon", fossil_sys_swap_neon, fossil_sys_find_neon, fossil_sys_compare_neon, fossil_sys_fill_neon};
+
+#endif
+
+static const fossil_sys_memory_kernels_t *fossil_sys_memory_kernels_select(void)
+{
+    // Supported tables, best first.
+    const fossil_sys_memory_kernels_t *supported[4];
+    size_t count = 0;
+
+#if defined(FOSSIL_SYS_SIMD_X86)
+    bool sse2 = false, avx2 = false, avx512 = false;
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    sse2 = __builtin_cpu_supports("sse2");
+    avx2 = __builtin_cpu_supports("avx2");
+    avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#elif defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    int max_leaf = regs[0];
+    __cpuid(regs, 1);
+    sse2 = (regs[3] >> 26) & 1;
+    bool osxsave = (regs[2] >> 27) & 1;
+    bool avx = (regs[2] >> 28) & 1;
+    if (osxsave && avx && max_leaf >= 7)
+    {
+        unsigned long long xcr0 = _xgetbv(0);
+        __cpuidex(regs, 7, 0);
+        avx2 = (xcr0 & 0x6) == 0x6 && ((regs[1] >> 5) & 1);
+        avx512 = (xcr0 & 0xE6) == 0xE6 && ((regs[1] >> 16) & 1) && ((regs[1] >> 30) & 1);
+    }
+#endif
+    if (avx512)
+        supported[count++] = &g_kernels_avx512;
+    if (avx2)
+        supported[count++] = &g_kernels_avx2;
+    if (sse2)
+        supported[count++] = &g_kernels_sse2;
+#elif defined(FOSSIL_SYS_SIMD_NEON)
+    supported[count++] = &g_kernels_neon;
+#endif
+    supported[count++] = &g_kernels_scalar;
+
+    const char *forced = getenv("FOSSIL_SYS_MEMORY_SIMD");
+    if (forced)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            if (strcmp(forced, supported[i]->name) == 0)
+                return supported[i];
+        }
+    }
+    return supported[0];
+}
+
+static _Atomic(const fossil_sys_memory_kernels_t *) g_kernels = NULL;
+
+static inline const fossil_sys_memory_kernels_t *fossil_sys_memory_kernels(void)
+{
+    const fossil_sys_memory_kernels_t *kernels = atomic_load_explicit(&g_kernels, memory_order_acquire);
+    if (!kernels)
+    {
+        // Selection is idempotent, so racing first callers simply agree.
+        kernels = fossil_sys_memory_kernels_select();
+        atomic_store_explicit(&g_kernels, kernels, memory_order_release);
+    }
+    return kernels;
+}
+
+const char *fossil_sys_memory_simd_level(void)
+{
+    return fossil_sys_memory_kernels()->name;
+}
+
+// ----------------------- Guard Page Debug Allocator -----------------------
+
+// Opt-in with FOSSIL_SYS_MEMORY_GUARD=1 in the environment, or at build time
+// with -DFOSSIL_SYS_MEMORY_GUARD=1 (meson option memory_guard); the
+// environment wins when both are set. Every allocation then gets its own
+// mapping with an inaccessible page on each side and the data pushed flush
+// against the trailing guard, so overruns fault on the first byte. Freed
+// mappings are made inaccessible and held in a quarantine of
+// FOSSIL_SYS_MEMORY_GUARD_QUARANTINE blocks (default 1024) before being
+// unmapped, so stale pointers fault too. The mode is fixed on first use.
+
+#define FOSSIL_SYS_GUARD_MAGIC UINT64_C(0x46534755415244ED)     // Live guarded block
+#define FOSSIL_SYS_GUARD_FREED UINT64_C(0x4653475541524446)     // Quarantined block
+#define FOSSIL_SYS_GUARD_QUARANTINE_DEFAULT ((size_t)1024)
+#define FOSSIL_SYS_GUARD_QUARANTINE_MAX ((size_t)1 << 20)
+
+// Stored immediately below the user pointer; read with memcpy since a
+// naturally aligned user pointer leaves it unaligned.
+typedef struct
+{
+    uint64_t magic;
+    size_t size;   // Requested bytes
+    uint8_t *base; // Start of the mapping, leading guard included
+    size_t length; // Mapping length, both guards included
+} fossil_sys_guard_header_t;
+
+typedef struct
+{
+    uint8_t *base;
+    size_t length;
+} fossil_sys_guard_region_t;
+
+static _Atomic int g_guard_state = 0; // 0 unresolved, 1 off, 2 on
+static _Atomic size_t g_guard_page = 0;
+static _Atomic size_t g_guard_quarantine_cap = 0;
+
+static fossil_sys_memory_lock_t g_guard_lock = FOSSIL_SYS_MEMORY_LOCK_INITIALIZER;
+static fossil_sys_guard_region_t *g_guard_quarantine = NULL; // Ring, allocated on first free
+static size_t g_guard_quarantine_head = 0;
+static size_t g_guard_quarantine_count = 0;
+
+static bool fossil_sys_guard_on(void)
+{
+    int state = atomic_load_explicit(&g_guard_state, memory_order_acquire);
+    if (state)
+        return state == 2;
+
+    // Resolution is idempotent, so racing first callers simply agree.
+#if defined(FOSSIL_SYS_MEMORY_GUARD) && FOSSIL_SYS_MEMORY_GUARD
+    bool enabled = true;
+#else
+    bool enabled = false;
+#endif
+    const char *env = getenv("FOSSIL_SYS_MEMORY_GUARD");
+    if (env && *env)
+        enabled = strcmp(env, "0") != 0;
+
+    size_t quarantine = FOSSIL_SYS_GUARD_QUARANTINE_DEFAULT;
+    env = getenv("FOSSIL_SYS_MEMORY_GUARD_QUARANTINE");
+    if (env && *env)
+    {
+        unsigned long long value = strtoull(env, NULL, 10);
+        quarantine = value < FOSSIL_SYS_GUARD_QUARANTINE_MAX ? (size_t)value : FOSSIL_SYS_GUARD_QUARANTINE_MAX;
+    }
+
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    size_t page = info.dwPageSize;
+#else
+    long queried = sysconf(_SC_PAGESIZE);
+    size_t page = queried > 0 ? (size_t)queried : 4096;
+#endif
+
+    atomic_store_explicit(&g_guard_page, page, memory_order_relaxed);
+    atomic_store_explicit(&g_guard_quarantine_cap, quarantine, memory_order_relaxed);
+    atomic_store_explicit(&g_guard_state, enabled ? 2 : 1, memory_order_release);
+    return enabled;
+}
+
+static void fossil_sys_guard_unmap(uint8_t *base, size_t length)
+{
+#if defined(_WIN32)
+    (void)length;
+    VirtualFree(base, 0, MEM_RELEASE);
+#else
+    munmap(base, length);
+#endif
+}
+
+static void *fossil_sys_guard_alloc(size_t size, size_t alignment)
+{
+    // Without an explicit alignment use the largest power of two dividing
+    // size (capped at max_align_t): that is all any object of this size can
+    // need and it lets the last byte sit right against the trailing guard.
+    if (alignment == 0)
+    {
+        alignment = size & (~size + 1);
+        if (alignment > _Alignof(max_align_t))
+            alignment = _Alignof(max_align_t);
+    }
+
+    size_t page = atomic_load_explicit(&g_guard_page, memory_order_relaxed);
+    size_t overhead = sizeof(fossil_sys_guard_header_t) + alignment - 1;
+    if (size > SIZE_MAX - overhead - 3 * page)
+        return NULL;
+    size_t body = (size + overhead + page - 1) & ~(page - 1);
+    size_t length = body + 2 * page;
+
+#if defined(_WIN32)
+    uint8_t *base = (uint8_t *)VirtualAlloc(NULL, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!base)
+        return NULL;
+    DWORD old;
+    if (!VirtualProtect(base, page, PAGE_NOACCESS, &old) ||
+        !VirtualProtect(base + page + body, page, PAGE_NOACCESS, &old))
+    {
+        VirtualFree(base, 0, MEM_RELEASE);
+        return NULL;
+    }
+#else
+    uint8_t *base = (uint8_t *)mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if ((void *)base == MAP_FAILED)
+        return NULL;
+    if (mprotect(base, page, PROT_NONE) != 0 || mprotect(base + page + body, page, PROT_NONE) != 0)
+    {
+        munmap(base, length);
+        return NULL;
+    }
+#endif
+
+    uint8_t *user = (uint8_t *)((uintptr_t)(base + page + body - size) & ~(uintptr_t)(alignment - 1));
+    fossil_sys_guard_header_t header = {FOSSIL_SYS_GUARD_MAGIC, size, base, length};
+    memcpy(user - sizeof(header), &header, sizeof(header));
+    return user;
+}
+
+static bool fossil_sys_guard_header(const void *ptr, fossil_sys_guard_header_t *out, const char *caller)
+{
+    memcpy(out, (const uint8_t *)ptr - sizeof(*out), sizeof(*out));
+    if (out->magic == FOSSIL_SYS_GUARD_MAGIC)
+        return true;
+    fprintf(stderr, "Error: %s() - Guard header is corrupt (heap underrun or foreign pointer).\n", caller);
+    return false;
+}
+
+static size_t fossil_sys_guard_size(const void *ptr)
+{
+    fossil_sys_guard_header_t header;
+    memcpy(&header, (const uint8_t *)ptr - sizeof(header), sizeof(header));
+    return header.magic == FOSSIL_SYS_GUARD_MAGIC ? header.size : 0; // The free path reports corruption
+}
+
+static void fossil_sys_guard_free(void *ptr, const char *caller)
+{
+    fossil_sys_guard_header_t header;
+    if (!fossil_sys_guard_header(ptr, &header, caller))
+        return; // Leak rather than unmap something we do not own
+
+    uint64_t freed = FOSSIL_SYS_GUARD_FREED;
+    memcpy((uint8_t *)ptr - sizeof(header), &freed, sizeof(freed));
+
+    // Drop the pages but keep the address range reserved and inaccessible, so
+    // a use after free faults while the quarantine costs no physical memory.
+    size_t page = atomic_load_explicit(&g_guard_page, memory_order_relaxed);
+    uint8_t *body = header.base + page;
+    size_t body_length = header.length - 2 * page;
+#if defined(_WIN32)
+    VirtualFree(body, body_length, MEM_DECOMMIT);
+#else
+    mprotect(body, body_length, PROT_NONE);
+#if defined(__linux__)
+    madvise(body, body_length, MADV_DONTNEED);
+#endif
+#endif
+
+    size_t cap = atomic_load_explicit(&g_guard_quarantine_cap, memory_order_relaxed);
+    fossil_sys_guard_region_t evicted = {header.base, header.length};
+    if (cap)
+    {
+        fossil_sys_memory_lock_acquire(&g_guard_lock);
+        if (!g_guard_quarantine)
+            g_guard_quarantine = (fossil_sys_guard_region_t *)calloc(cap, sizeof(*g_guard_quarantine));
+        if (g_guard_quarantine)
+        {
+            size_t slot = (g_guard_quarantine_head + g_guard_quarantine_count) % cap;
+            if (g_guard_quarantine_count == cap)
+            {
+                fossil_sys_guard_region_t oldest = g_guard_quarantine[slot];
+                g_guard_quarantine[slot] = evicted;
+                g_guard_quarantine_head = (g_guard_quarantine_head + 1) % cap;
+                evicted = oldest;
+            }
+            else
+            {
+                g_guard_quarantine[slot] = evicted;
+                g_guard_quarantine_count++;
+                evicted.base = NULL;
+            }
+        }
+        fossil_sys_memory_lock_release(&g_guard_lock);
+    }
+
+    if (evicted.base)
+        fossil_sys_guard_unmap(evicted.base, evicted.length);
+}
+
+// Bytes the stats hooks account for; guarded blocks report their exact size.
+static inline size_t fossil_sys_memory_usable(void *ptr)
+{
+    return fossil_sys_guard_on() ? fossil_sys_guard_size(ptr) : FOSSIL_SYS_USABLE_SIZE(ptr);
+}
+
+bool fossil_sys_memory_guard_enabled(void)
+{
+    return fossil_sys_guard_on();
+}
+
+// ----------------------- Sampling Heap Profiler -----------------------
+
+// Each thread counts down a byte budget drawn from an exponential
+// distribution with mean = sample rate, and records a backtrace only when it
+// runs out, so the expected cost is one sample per rate bytes whatever the
+// allocation sizes. Live samples sit in an open-addressed table that frees
+// probe without a lock; inserts and removals, both rare, take the lock.
+
+#define FOSSIL_SYS_PROFILE_RATE_DEFAULT ((size_t)512 * 1024)
+#define FOSSIL_SYS_PROFILE_DEPTH 32
+#define FOSSIL_SYS_PROFILE_SKIP 2 // The sampler and the public entry point
+#define FOSSIL_SYS_PROFILE_BUCKETS 4096
+#define FOSSIL_SYS_PROFILE_LIVE 65536
+#define FOSSIL_SYS_PROFILE_PROBE 64
+#define FOSSIL_SYS_PROFILE_TOMBSTONE ((uintptr_t)1)
+
+// The sampler must be its own frame and the hook must not be one, so the
+// frame count to skip is the same at every optimisation level.
+#if defined(__GNUC__) || defined(__clang__)
+#define FOSSIL_SYS_NOINLINE __attribute__((noinline))
+#define FOSSIL_SYS_ALWAYS_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define FOSSIL_SYS_NOINLINE __declspec(noinline)
+#define FOSSIL_SYS_ALWAYS_INLINE __forceinline
+#else
+#define FOSSIL_SYS_NOINLINE
+#define FOSSIL_SYS_ALWAYS_INLINE inline
+#endif
+
+// One per distinct allocation stack.
+typedef struct
+{
+    uint64_t hash; // 0 marks an unused bucket
+    size_t depth;
+    void *frames[FOSSIL_SYS_PROFILE_DEPTH];
+    uint64_t alloc_objs; // Raw sampled counts, as pprof expects
+    uint64_t alloc_bytes;
+    uint64_t inuse_objs;
+    uint64_t inuse_bytes;
+    uint64_t inuse_estimate; // Unsampled estimate of live bytes
+} fossil_sys_profile_bucket_t;
+
+typedef struct
+{
+    _Atomic uintptr_t key; // 0 empty, FOSSIL_SYS_PROFILE_TOMBSTONE removed
+    size_t size;
+    uint64_t estimate;
+    uint32_t bucket;
+} fossil_sys_profile_live_t;
+
+static _Atomic size_t g_profile_rate = 0; // 0 while stopped
+static _Atomic size_t g_profile_live_count = 0;
+static _Atomic uint32_t g_profile_epoch = 0; // Bumped by every start so threads redraw their budget
+static fossil_sys_memory_lock_t g_profile_lock = FOSSIL_SYS_MEMORY_LOCK_INITIALIZER;
+static fossil_sys_profile_bucket_t *g_profile_buckets = NULL;
+static fossil_sys_profile_live_t *g_profile_live = NULL;
+static size_t g_profile_sampled_rate = FOSSIL_SYS_PROFILE_RATE_DEFAULT; // Rate of the data in the tables
+static uint64_t g_profile_dropped = 0;
+static FOSSIL_SYS_THREAD_LOCAL int64_t g_profile_countdown = 0;
+static FOSSIL_SYS_THREAD_LOCAL uint64_t g_profile_rng = 0;
+static FOSSIL_SYS_THREAD_LOCAL uint32_t g_profile_epoch_seen = 0;
+
+static inline size_t fossil_sys_profile_slot(uintptr_t key)
+{
+    uint64_t h = (uint64_t)key * UINT64_C(0x9E3779B97F4A7C15);
+    return (size_t)(h >> 48) & (FOSSIL_SYS_PROFILE_LIVE - 1);
+}
+
+// -ln(u) for u in (0, 1], without libm: u = m * 2^e with m in [1, 2), then
+// ln(m) = 2 atanh((m - 1) / (m + 1)), whose series converges fast for t <= 1/3.
+static double fossil_sys_profile_neg_log(double u)
+{
+    uint64_t bits;
+    memcpy(&bits, &u, sizeof(bits));
+    int exponent = (int)((bits >> 52) & 0x7FF) - 1023;
+    bits = (bits & UINT64_C(0x000FFFFFFFFFFFFF)) | UINT64_C(0x3FF0000000000000);
+    double m;
+    memcpy(&m, &bits, sizeof(m));
+    double t = (m - 1.0) / (m + 1.0), t2 = t * t;
+    double ln_m = 2.0 * t * (1.0 + t2 * (1.0 / 3 + t2 * (1.0 / 5 + t2 * (1.0 / 7 + t2 / 9))));
+    return -(exponent * 0.69314718055994530942 + ln_m);
+}
+
+// exp(-x) for x >= 0: halve until tiny, use a short Taylor series, square back.
+static double fossil_sys_profile_exp_neg(double x)
+{
+    if (x > 700.0)
+        return 0.0;
+    int halvings = 0;
+    while (x > 1.0 / 64)
+    {
+        x *= 0.5;
+        halvings++;
+    }
+    double r = 1.0 - x * (1.0 - x * (0.5 - x * (1.0 / 6 - x / 24)));
+    while (halvings--)
+        r *= r;
+    return r;
+}
+
+static int64_t fossil_sys_profile_draw(size_t rate)
+{
+    // xorshift64*; quality is ample for picking sample points.
+    uint64_t x = g_profile_rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    g_profile_rng = x;
+    double u = (double)(((x * UINT64_C(0x2545F4914F6CDD1D)) >> 11) + 1) * (1.0 / 9007199254740992.0);
+    double budget = fossil_sys_profile_neg_log(u) * (double)rate;
+    return budget < (double)INT64_MAX / 2 ? (int64_t)budget + 1 : INT64_MAX / 2;
+}
+
+static FOSSIL_SYS_NOINLINE void fossil_sys_profile_sample(void *ptr, size_t size)
+{
+    size_t rate = atomic_load_explicit(&g_profile_rate, memory_order_relaxed);
+    if (!rate)
+        return;
+    uint32_t epoch = atomic_load_explicit(&g_profile_epoch, memory_order_relaxed);
+    if (g_profile_epoch_seen != epoch)
+    {
+        // First allocation on this thread since start: draw a budget at the
+        // current rate before deciding.
+        if (!g_profile_rng)
+            g_profile_rng = ((uint64_t)(uintptr_t)&g_profile_rng * UINT64_C(0x9E3779B97F4A7C15)) | 1;
+        g_profile_epoch_seen = epoch;
+        g_profile_countdown = fossil_sys_profile_draw(rate) - (int64_t)size;
+        if (g_profile_countdown > 0)
+            return;
+    }
+    g_profile_countdown = fossil_sys_profile_draw(rate);
+
+    void *frames[FOSSIL_SYS_PROFILE_DEPTH];
+    size_t depth = 0;
+#if defined(_WIN32)
+    depth = CaptureStackBackTrace(FOSSIL_SYS_PROFILE_SKIP, FOSSIL_SYS_PROFILE_DEPTH, frames, NULL);
+#elif defined(FOSSIL_SYS_PROFILE_BACKTRACE)
+    void *raw[FOSSIL_SYS_PROFILE_DEPTH + FOSSIL_SYS_PROFILE_SKIP];
+    int captured = backtrace(raw, FOSSIL_SYS_PROFILE_DEPTH + FOSSIL_SYS_PROFILE_SKIP);
+    if (captured > FOSSIL_SYS_PROFILE_SKIP)
+    {
+        depth = (size_t)captured - FOSSIL_SYS_PROFILE_SKIP;
+        memcpy(frames, raw + FOSSIL_SYS_PROFILE_SKIP, depth * sizeof(void *));
+    }
+#endif // Without an unwinder samples are still counted, under an empty stack
+    uint64_t hash = UINT64_C(1469598103934665603);
+    for (size_t i = 0; i < depth; i++)
+        hash = (hash ^ (uint64_t)(uintptr_t)frames[i]) * UINT64_C(1099511628211);
+    hash |= 1; // Never 0, which marks a free bucket
+
+    // An allocation of size bytes is sampled with probability 1 - exp(-size / rate).
+    double p = 1.0 - fossil_sys_profile_exp_neg((double)size / (double)rate);
+    uint64_t estimate = p > 0.0 ? (uint64_t)((double)size / p) : (uint64_t)rate;
+
+    fossil_sys_memory_lock_acquire(&g_profile_lock);
+    if (!g_profile_buckets || !g_profile_live)
+    {
+        fossil_sys_memory_lock_release(&g_profile_lock);
+        return;
+    }
+
+    fossil_sys_profile_bucket_t *bucket = NULL;
+    size_t b = (size_t)(hash >> 20) & (FOSSIL_SYS_PROFILE_BUCKETS - 1);
+    for (size_t probe = 0; probe < FOSSIL_SYS_PROFILE_BUCKETS; probe++, b = (b + 1) & (FOSSIL_SYS_PROFILE_BUCKETS - 1))
+    {
+        fossil_sys_profile_bucket_t *candidate = &g_profile_buckets[b];
+        if (candidate->hash == 0)
+        {
+            candidate->hash = hash;
+            candidate->depth = depth;
+            memcpy(candidate->frames, frames, depth * sizeof(void *));
+            bucket = candidate;
+            break;
+        }
+        if (candidate->hash == hash && candidate->depth == depth &&
+            memcmp(candidate->frames, frames, depth * sizeof(void *)) == 0)
+        {
+            bucket = candidate;
+            break;
+        }
+    }
+
+    fossil_sys_profile_live_t *entry = NULL;
+    size_t slot = fossil_sys_profile_slot((uintptr_t)ptr);
+    for (size_t probe = 0; bucket && probe < FOSSIL_SYS_PROFILE_PROBE; probe++, slot = (slot + 1) & (FOSSIL_SYS_PROFILE_LIVE - 1))
+    {
+        uintptr_t key = atomic_load_explicit(&g_profile_live[slot].key, memory_order_relaxed);
+        if (key == 0 || key == FOSSIL_SYS_PROFILE_TOMBSTONE)
+        {
+            entry = &g_profile_live[slot];
+            break;
+        }
+    }
+
+    if (entry)
+    {
+        bucket->alloc_objs++;
+        bucket->alloc_bytes += size;
+        bucket->inuse_objs++;
+        bucket->inuse_bytes += size;
+        bucket->inuse_estimate += estimate;
+        entry->size = size;
+        entry->estimate = estimate;
+        entry->bucket = (uint32_t)(bucket - g_profile_buckets);
+        atomic_store_explicit(&entry->key, (uintptr_t)ptr, memory_order_release);
+        atomic_fetch_add_explicit(&g_profile_live_count, 1, memory_order_release); // Publishes the tables
+    }
+    else
+    {
+        g_profile_dropped++; // Tables full; the estimate undercounts
+    }
+    fossil_sys_memory_lock_release(&g_profile_lock);
+}
 
-// Internal counters for memory stats (optional, for debug)
-static size_t g_alloc_count = 0;
-static size_t g_alloc_bytes = 0;
+// A sample taken off a block being reallocated, so a failed realloc can
+// put it back: the old block is still live then.
+typedef struct
+{
+    uint32_t epoch; // Profile the sample belongs to (0 = nothing taken)
+    uint32_t bucket;
+    size_t size;
+    uint64_t estimate;
+} fossil_sys_profile_held_t;
+
+static FOSSIL_SYS_NOINLINE void fossil_sys_profile_forget(void *ptr, fossil_sys_profile_held_t *held)
+{
+    // Lock-free miss path: the common case for every unsampled free.
+    size_t slot = fossil_sys_profile_slot((uintptr_t)ptr);
+    for (size_t probe = 0; probe < FOSSIL_SYS_PROFILE_PROBE; probe++, slot = (slot + 1) & (FOSSIL_SYS_PROFILE_LIVE - 1))
+    {
+        uintptr_t key = atomic_load_explicit(&g_profile_live[slot].key, memory_order_acquire);
+        if (key == 0)
+            return;
+        if (key != (uintptr_t)ptr)
+            continue;
+
+        fossil_sys_memory_lock_acquire(&g_profile_lock);
+        fossil_sys_profile_live_t *entry = &g_profile_live[slot];
+        if (atomic_load_explicit(&entry->key, memory_order_relaxed) == (uintptr_t)ptr)
+        {
+            fossil_sys_profile_bucket_t *bucket = &g_profile_buckets[entry->bucket];
+            if (held)
+            {
+                held->epoch = atomic_load_explicit(&g_profile_epoch, memory_order_relaxed);
+                held->bucket = entry->bucket;
+                held->size = entry->size;
+                held->estimate = entry->estimate;
+            }
+            bucket->inuse_objs--;
+            bucket->inuse_bytes -= entry->size;
+            bucket->inuse_estimate -= entry->estimate;
+            atomic_store_explicit(&entry->key, FOSSIL_SYS_PROFILE_TOMBSTONE, memory_order_relaxed);
+            atomic_fetch_sub_explicit(&g_profile_live_count, 1, memory_order_relaxed);
+        }
+        fossil_sys_memory_lock_release(&g_profile_lock);
+        return;
+    }
+}
+
+static FOSSIL_SYS_ALWAYS_INLINE void fossil_sys_profile_on_alloc(void *ptr, size_t size)
+{
+    if (!atomic_load_explicit(&g_profile_rate, memory_order_relaxed))
+        return;
+    g_profile_countdown -= (int64_t)size;
+    if (g_profile_countdown <= 0 ||
+        g_profile_epoch_seen != atomic_load_explicit(&g_profile_epoch, memory_order_relaxed))
+        fossil_sys_profile_sample(ptr, size);
+}
+
+static inline void fossil_sys_profile_on_free(void *ptr)
+{
+    if (atomic_load_explicit(&g_profile_live_count, memory_order_acquire))
+        fossil_sys_profile_forget(ptr, NULL);
+}
+
+// Retires the sample of a block about to be passed to realloc. It must go
+// first: once realloc returns, another thread may already own and have
+// sampled the old address.
+static inline void fossil_sys_profile_on_realloc(void *ptr, fossil_sys_profile_held_t *held)
+{
+    held->epoch = 0;
+    if (atomic_load_explicit(&g_profile_live_count, memory_order_acquire))
+        fossil_sys_profile_forget(ptr, held);
+}
+
+// Puts back the sample of a block whose realloc failed.
+static void fossil_sys_profile_on_realloc_failed(void *ptr, const fossil_sys_profile_held_t *held)
+{
+    if (!held->epoch)
+        return;
+
+    fossil_sys_memory_lock_acquire(&g_profile_lock);
+    // A start in between cleared the tables the sample was counted in.
+    if (held->epoch == atomic_load_explicit(&g_profile_epoch, memory_order_relaxed))
+    {
+        fossil_sys_profile_live_t *entry = NULL;
+        size_t slot = fossil_sys_profile_slot((uintptr_t)ptr);
+        for (size_t probe = 0; probe < FOSSIL_SYS_PROFILE_PROBE; probe++, slot = (slot + 1) & (FOSSIL_SYS_PROFILE_LIVE - 1))
+        {
+            uintptr_t key = atomic_load_explicit(&g_profile_live[slot].key, memory_order_relaxed);
+            if (key == 0 || key == FOSSIL_SYS_PROFILE_TOMBSTONE)
+            {
+                entry = &g_profile_live[slot];
+                break;
+            }
+        }
+
+        if (entry)
+        {
+            fossil_sys_profile_bucket_t *bucket = &g_profile_buckets[held->bucket];
+            bucket->inuse_objs++;
+            bucket->inuse_bytes += held->size;
+            bucket->inuse_estimate += held->estimate;
+            entry->size = held->size;
+            entry->estimate = held->estimate;
+            entry->bucket = held->bucket;
+            atomic_store_explicit(&entry->key, (uintptr_t)ptr, memory_order_release);
+            atomic_fetch_add_explicit(&g_profile_live_count, 1, memory_order_release);
+        }
+        else
+        {
+            g_profile_dropped++;
+        }
+    }
+    fossil_sys_memory_lock_release(&g_profile_lock);
+}
+
+int fossil_sys_memory_profile_start(size_t sample_bytes)
+{
+    if (sample_bytes == 0)
+        sample_bytes = FOSSIL_SYS_PROFILE_RATE_DEFAULT;
+
+    fossil_sys_memory_lock_acquire(&g_profile_lock);
+    if (!g_profile_buckets)
+        g_profile_buckets = (fossil_sys_profile_bucket_t *)calloc(FOSSIL_SYS_PROFILE_BUCKETS, sizeof(*g_profile_buckets));
+    if (!g_profile_live)
+        g_profile_live = (fossil_sys_profile_live_t *)calloc(FOSSIL_SYS_PROFILE_LIVE, sizeof(*g_profile_live));
+    if (!g_profile_buckets || !g_profile_live)
+    {
+        fossil_sys_memory_lock_release(&g_profile_lock);
+        fprintf(stderr, "Error: fossil_sys_memory_profile_start() - Memory allocation failed.\n");
+        return -1;
+    }
+
+    // Start from a clean profile; blocks sampled earlier are simply forgotten.
+    memset(g_profile_buckets, 0, FOSSIL_SYS_PROFILE_BUCKETS * sizeof(*g_profile_buckets));
+    for (size_t i = 0; i < FOSSIL_SYS_PROFILE_LIVE; i++)
+        atomic_store_explicit(&g_profile_live[i].key, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_profile_live_count, 0, memory_order_relaxed);
+    g_profile_dropped = 0;
+    g_profile_sampled_rate = sample_bytes;
+    atomic_fetch_add_explicit(&g_profile_epoch, 1, memory_order_relaxed);
+    atomic_store_explicit(&g_profile_rate, sample_bytes, memory_order_release);
+    fossil_sys_memory_lock_release(&g_profile_lock);
+    return 0;
+}
+
+void fossil_sys_memory_profile_stop(void)
+{
+    // Samples stay in place, and frees keep retiring them, until the next start.
+    atomic_store_explicit(&g_profile_rate, 0, memory_order_relaxed);
+}
+
+// Writes a frame as a bare symbol name when one is available, else its address.
+static void fossil_sys_profile_frame(FILE *out, void *frame, const char *symbol)
+{
+    if (symbol)
+    {
+        // glibc renders "object(name+0x1f) [0x...]"; keep just the name.
+        const char *open = strchr(symbol, '(');
+        const char *end = open ? strpbrk(open + 1, "+)") : NULL;
+        if (open && end && end > open + 1)
+        {
+            fprintf(out, "%.*s", (int)(end - open - 1), open + 1);
+            return;
+        }
+    }
+    fprintf(out, "0x%llx", (unsigned long long)(uintptr_t)frame);
+}
+
+int fossil_sys_memory_profile_dump(const char *path, fossil_sys_memory_profile_format_t format)
+{
+    if (!path)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_profile_dump() - Path is NULL.\n");
+        return -1;
+    }
+
+    FILE *out = fopen(path, "w");
+    if (!out)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_profile_dump() - Cannot open output file.\n");
+        return -1;
+    }
+
+    fossil_sys_memory_lock_acquire(&g_profile_lock);
+    if (format == FOSSIL_SYS_MEMORY_PROFILE_PPROF)
+    {
+        // gperftools legacy heap profile; pprof unsamples using the rate in the header.
+        uint64_t totals[4] = {0, 0, 0, 0};
+        for (size_t i = 0; g_profile_buckets && i < FOSSIL_SYS_PROFILE_BUCKETS; i++)
+        {
+            const fossil_sys_profile_bucket_t *bucket = &g_profile_buckets[i];
+            totals[0] += bucket->inuse_objs;
+            totals[1] += bucket->inuse_bytes;
+            totals[2] += bucket->alloc_objs;
+            totals[3] += bucket->alloc_bytes;
+        }
+        fprintf(out, "heap profile: %llu: %llu [%llu: %llu] @ heap_v2/%llu\n",
+                (unsigned long long)totals[0], (unsigned long long)totals[1],
+                (unsigned long long)totals[2], (unsigned long long)totals[3],
+                (unsigned long long)g_profile_sampled_rate);
+        for (size_t i = 0; g_profile_buckets && i < FOSSIL_SYS_PROFILE_BUCKETS; i++)
+        {
+            const fossil_sys_profile_bucket_t *bucket = &g_profile_buckets[i];
+            if (bucket->hash == 0)
+                continue;
+            fprintf(out, "%llu: %llu [%llu: %llu] @",
+                    (unsigned long long)bucket->inuse_objs, (unsigned long long)bucket->inuse_bytes,
+                    (unsigned long long)bucket->alloc_objs, (unsigned long long)bucket->alloc_bytes);
+            for (size_t f = 0; f < bucket->depth; f++)
+                fprintf(out, " 0x%llx", (unsigned long long)(uintptr_t)bucket->frames[f]);
+            fputc('\n', out);
+        }
+#if defined(__linux__)
+        // pprof needs the load addresses to symbolize.
+        fputs("\nMAPPED_LIBRARIES:\n", out);
+        FILE *maps = fopen("/proc/self/maps", "r");
+        if (maps)
+        {
+            char line[512];
+            while (fgets(line, sizeof(line), maps))
+                fputs(line, out);
+            fclose(maps);
+        }
+#endif
+    }
+    else
+    {
+        // Folded stacks, root first, weighted by estimated live bytes: the
+        // input format of flamegraph.pl and most flame graph viewers.
+        for (size_t i = 0; g_profile_buckets && i < FOSSIL_SYS_PROFILE_BUCKETS; i++)
+        {
+            const fossil_sys_profile_bucket_t *bucket = &g_profile_buckets[i];
+            if (bucket->hash == 0 || bucket->inuse_objs == 0)
+                continue;
+            char **symbols = NULL;
+#if defined(FOSSIL_SYS_PROFILE_BACKTRACE)
+            symbols = bucket->depth ? backtrace_symbols(bucket->frames, (int)bucket->depth) : NULL;
+#endif
+            if (bucket->depth == 0)
+                fputs("[unknown]", out);
+            for (size_t f = bucket->depth; f-- > 0;)
+            {
+                fossil_sys_profile_frame(out, bucket->frames[f], symbols ? symbols[f] : NULL);
+                if (f)
+                    fputc(';', out);
+            }
+            fprintf(out, " %llu\n", (unsigned long long)bucket->inuse_estimate);
+            free(symbols);
+        }
+    }
+    uint64_t dropped = g_profile_dropped;
+    fossil_sys_memory_lock_release(&g_profile_lock);
+
+    if (dropped)
+        fprintf(stderr, "Warning: fossil_sys_memory_profile_dump() - %llu samples dropped, profile tables were full.\n",
+                (unsigned long long)dropped);
+    return fclose(out) == 0 ? 0 : -1;
+}
 
 // ----------------------- Aligned Memory -----------------------
 
@@ -41,12 +1510,14 @@ fossil_sys_memory_t fossil_sys_memory_alloc(size_t size)
         return NULL;
     }
 
-    fossil_sys_memory_t ptr = malloc(size);
+    fossil_sys_memory_t ptr = fossil_sys_guard_on() ? fossil_sys_guard_alloc(size, 0) : malloc(size);
     if (!ptr)
     {
         fprintf(stderr, "Error: fossil_sys_memory_alloc() - Memory allocation failed.\n");
         return NULL;
     }
+    fossil_sys_stats_on_alloc(fossil_sys_memory_usable(ptr), size);
+    fossil_sys_profile_on_alloc(ptr, size);
     return ptr;
 }
 
@@ -58,12 +1529,37 @@ fossil_sys_memory_t fossil_sys_memory_realloc(fossil_sys_memory_t ptr, size_t si
         return NULL;
     }
 
-    fossil_sys_memory_t new_ptr = realloc(ptr, size);
+    size_t old_usable = fossil_sys_memory_usable(ptr);
+    fossil_sys_profile_held_t held;
+    fossil_sys_profile_on_realloc(ptr, &held);
+    fossil_sys_memory_t new_ptr;
+    if (fossil_sys_guard_on())
+    {
+        // Always move, so stale pointers to the old block fault.
+        new_ptr = size ? fossil_sys_guard_alloc(size, 0) : NULL;
+        if (new_ptr)
+            memcpy(new_ptr, ptr, old_usable < size ? old_usable : size);
+        if (new_ptr || size == 0)
+            fossil_sys_guard_free(ptr, "fossil_sys_memory_realloc");
+    }
+    else
+    {
+        new_ptr = realloc(ptr, size);
+    }
     if (!new_ptr && size > 0)
     {
+        fossil_sys_profile_on_realloc_failed(ptr, &held); // old block is untouched
         fprintf(stderr, "Error: fossil_sys_memory_realloc() - Memory reallocation failed.\n");
         return NULL;
     }
+
+    if (new_ptr)
+    {
+        fossil_sys_stats_on_realloc(old_usable, fossil_sys_memory_usable(new_ptr));
+        fossil_sys_profile_on_alloc(new_ptr, size);
+    }
+    else
+        fossil_sys_stats_on_free(old_usable); // realloc(ptr, 0) released the block
     return new_ptr;
 }
 
@@ -75,12 +1571,18 @@ fossil_sys_memory_t fossil_sys_memory_calloc(size_t num, size_t size)
         return NULL;
     }
 
-    fossil_sys_memory_t ptr = calloc(num, size);
+    fossil_sys_memory_t ptr;
+    if (fossil_sys_guard_on())
+        ptr = num <= SIZE_MAX / size ? fossil_sys_guard_alloc(num * size, 0) : NULL; // Fresh mappings are zeroed
+    else
+        ptr = calloc(num, size);
     if (!ptr)
     {
         fprintf(stderr, "Error: fossil_sys_memory_calloc() - Memory allocation failed.\n");
         return NULL;
     }
+    fossil_sys_stats_on_alloc(fossil_sys_memory_usable(ptr), num * size);
+    fossil_sys_profile_on_alloc(ptr, num * size);
     return ptr;
 }
 
@@ -108,7 +1610,12 @@ void fossil_sys_memory_free(fossil_sys_memory_t ptr)
         fprintf(stderr, "Error: fossil_sys_memory_free() - Pointer is NULL.\n");
         return;
     }
-    free(ptr); // No need for NULL check, free() already handles NULL.
+    fossil_sys_stats_on_free(fossil_sys_memory_usable(ptr));
+    fossil_sys_profile_on_free(ptr);
+    if (fossil_sys_guard_on())
+        fossil_sys_guard_free(ptr, "fossil_sys_memory_free");
+    else
+        free(ptr);
 }
 
 fossil_sys_memory_t fossil_sys_memory_copy(fossil_sys_memory_t dest, const fossil_sys_memory_t src, size_t size)
@@ -125,116 +1632,363 @@ fossil_sys_memory_t fossil_sys_memory_copy(fossil_sys_memory_t dest, const fossi
         return NULL;
     }
 
-    return memcpy(dest, src, size);
-}
+    return memcpy(dest, src, size);
+}
+
+fossil_sys_memory_t fossil_sys_memory_set(fossil_sys_memory_t ptr, int32_t value, size_t size)
+{
+    if (!ptr)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_set() - Pointer is NULL.\n");
+        return NULL;
+    }
+
+    if (size == 0)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_set() - Cannot set zero bytes.\n");
+        return NULL;
+    }
+
+    return memset(ptr, value, size);
+}
+
+fossil_sys_memory_t fossil_sys_memory_dup(const fossil_sys_memory_t src, size_t size)
+{
+    if (!src || size == 0)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_dup() - Invalid source or zero size.\n");
+        return NULL;
+    }
+
+    fossil_sys_memory_t dest = fossil_sys_memory_alloc(size);
+    if (!dest)
+    {
+        return NULL; // Error already handled in fossil_sys_memory_alloc
+    }
+
+    return memcpy(dest, src, size);
+}
+
+void fossil_sys_memory_zero(fossil_sys_memory_t ptr, size_t size)
+{
+    if (!ptr || size == 0)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_zero() - Invalid pointer or zero size.\n");
+        return;
+    }
+
+    memset(ptr, 0, size);
+}
+
+int fossil_sys_memory_compare(const fossil_sys_memory_t ptr1, const fossil_sys_memory_t ptr2, size_t size)
+{
+    if (!ptr1 || !ptr2 || size == 0)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_compare() - Invalid pointers or zero size.\n");
+        return -1; // Return -1 for invalid input
+    }
+
+    return fossil_sys_memory_kernels()->compare((const uint8_t *)ptr1, (const uint8_t *)ptr2, size);
+}
+
+fossil_sys_memory_t fossil_sys_memory_move(fossil_sys_memory_t dest, const fossil_sys_memory_t src, size_t size)
+{
+    if (!dest || !src || size == 0)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_move() - Invalid source or destination pointers, or zero size.\n");
+        return NULL;
+    }
+
+    return memmove(dest, src, size);
+}
+
+fossil_sys_memory_t fossil_sys_memory_resize_ex(fossil_sys_memory_t ptr, size_t old_size, size_t new_size,
+                                               fossil_sys_memory_resize_policy_t policy,
+                                               size_t *out_capacity, bool *out_moved)
+{
+    if (out_capacity)
+        *out_capacity = 0;
+    if (out_moved)
+        *out_moved = false;
+
+    if (ptr == NULL)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_resize_ex() - Pointer is NULL.\n");
+        return NULL;
+    }
+
+    if (new_size == 0)
+    {
+        fossil_sys_memory_free(ptr);
+        return NULL;
+    }
+
+    // ptr is indeterminate once realloc moves it, so remember its address now
+    // (volatile stops the compiler sinking the read past the call).
+    volatile uintptr_t before = (uintptr_t)ptr;
+    size_t target = new_size;
+    if (policy == FOSSIL_SYS_MEMORY_RESIZE_GEOMETRIC && new_size > old_size)
+    {
+        size_t grown = old_size + old_size / 2;
+        if (grown > target && grown >= old_size) // second check guards overflow
+            target = grown;
+    }
+
+    size_t usable = fossil_sys_memory_usable(ptr);
+    if (fossil_sys_guard_on())
+    {
+        // Always move, so stale pointers to the old block fault.
+        fossil_sys_memory_t moved = fossil_sys_guard_alloc(target, 0);
+        if (!moved)
+        {
+            fprintf(stderr, "Error: fossil_sys_memory_resize_ex() - Memory allocation failed.\n");
+            return NULL;
+        }
+        memcpy(moved, ptr, usable < new_size ? usable : new_size);
+        fossil_sys_profile_on_free(ptr);
+        fossil_sys_guard_free(ptr, "fossil_sys_memory_resize_ex");
+        fossil_sys_stats_on_realloc(usable, target);
+        fossil_sys_profile_on_alloc(moved, target);
+        if (out_capacity)
+            *out_capacity = target;
+        if (out_moved)
+            *out_moved = true;
+        return moved;
+    }
+
+    // The allocator often hands out more than was asked for; reuse that slack
+    // unless the block would end up less than half used.
+    if (new_size <= usable && new_size >= usable / 2)
+    {
+        fossil_sys_stats_on_realloc(usable, usable);
+        if (out_capacity)
+            *out_capacity = usable;
+        return ptr;
+    }
+
+    // realloc extends in place when the neighbouring space is free and, on
+    // glibc, moves large mmap-backed blocks with mremap instead of copying.
+    fossil_sys_profile_held_t held;
+    fossil_sys_profile_on_realloc(ptr, &held);
+    fossil_sys_memory_t new_ptr = realloc(ptr, target);
+    if (!new_ptr)
+    {
+        fossil_sys_profile_on_realloc_failed(ptr, &held);
+        fprintf(stderr, "Error: fossil_sys_memory_resize_ex() - Memory allocation failed.\n");
+        return NULL; // old buffer is untouched
+    }
+    size_t capacity = FOSSIL_SYS_USABLE_SIZE(new_ptr);
+    fossil_sys_stats_on_realloc(usable, capacity);
+    fossil_sys_profile_on_alloc(new_ptr, target);
+
+    if (out_capacity)
+    {
+        *out_capacity = capacity > target ? capacity : target;
+    }
+    if (out_moved)
+        *out_moved = (uintptr_t)new_ptr != before;
+    return new_ptr;
+}
+
+fossil_sys_memory_t fossil_sys_memory_resize(fossil_sys_memory_t ptr, size_t old_size, size_t new_size)
+{
+    if (ptr == NULL)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_resize() - Pointer is NULL.\n");
+        return NULL;
+    }
+
+    if (new_size == 0)
+    {
+        fossil_sys_memory_free(ptr);
+        return NULL;
+    }
+
+    fossil_sys_memory_t new_ptr = fossil_sys_memory_resize_ex(ptr, old_size, new_size,
+                                                              FOSSIL_SYS_MEMORY_RESIZE_EXACT, NULL, NULL);
+    return new_ptr ? new_ptr : ptr; // keep old buffer on failure
+}
+
+bool fossil_sys_memory_is_valid(const fossil_sys_memory_t ptr)
+{
+    if (!ptr)
+    {
+        return false;
+    }
+    // Optional: Add more validation logic if needed, but normally you'd rely on the caller to manage validity.
+    return true;
+}
+
+// ----------------------- Aligned / Huge Page Memory -----------------------
+
+#define FOSSIL_SYS_HUGE_PAGE ((size_t)2 * 1024 * 1024)
+
+#if defined(__linux__)
+// MAP_HUGETLB alone uses the system's default huge page size, which need not be
+// 2 MiB; lengths are rounded to FOSSIL_SYS_HUGE_PAGE, so ask for that size.
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#endif
 
-fossil_sys_memory_t fossil_sys_memory_set(fossil_sys_memory_t ptr, int32_t value, size_t size)
+fossil_sys_memory_t fossil_sys_memory_alloc_aligned(size_t size, size_t alignment)
 {
-    if (!ptr)
+    if (size == 0)
     {
-        fprintf(stderr, "Error: fossil_sys_memory_set() - Pointer is NULL.\n");
+        fprintf(stderr, "Error: fossil_sys_memory_alloc_aligned() - Cannot allocate zero bytes.\n");
         return NULL;
     }
 
-    if (size == 0)
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
     {
-        fprintf(stderr, "Error: fossil_sys_memory_set() - Cannot set zero bytes.\n");
+        fprintf(stderr, "Error: fossil_sys_memory_alloc_aligned() - Alignment must be a power of two.\n");
         return NULL;
     }
 
-    return memset(ptr, value, size);
-}
+    if (alignment < sizeof(void *))
+        alignment = sizeof(void *);
 
-fossil_sys_memory_t fossil_sys_memory_dup(const fossil_sys_memory_t src, size_t size)
-{
-    if (!src || size == 0)
+    fossil_sys_memory_t ptr = NULL;
+    if (fossil_sys_guard_on())
     {
-        fprintf(stderr, "Error: fossil_sys_memory_dup() - Invalid source or zero size.\n");
-        return NULL;
+        ptr = fossil_sys_guard_alloc(size, alignment);
+        if (!ptr)
+        {
+            fprintf(stderr, "Error: fossil_sys_memory_alloc_aligned() - Memory allocation failed.\n");
+            return NULL;
+        }
+        fossil_sys_stats_on_alloc(size, size);
+        return ptr;
     }
 
-    fossil_sys_memory_t dest = fossil_sys_memory_alloc(size);
-    if (!dest)
+#if defined(_WIN32)
+    ptr = _aligned_malloc(size, alignment);
+#else
+    if (posix_memalign(&ptr, alignment, size) != 0)
+        ptr = NULL;
+#endif
+    if (!ptr)
     {
-        return NULL; // Error already handled in fossil_sys_memory_alloc
+        fprintf(stderr, "Error: fossil_sys_memory_alloc_aligned() - Memory allocation failed.\n");
+        return NULL;
     }
 
-    return memcpy(dest, src, size);
+#if !defined(_WIN32) // _msize cannot size _aligned_malloc blocks
+    fossil_sys_stats_on_alloc(FOSSIL_SYS_USABLE_SIZE(ptr), size);
+#endif
+    return ptr;
 }
 
-void fossil_sys_memory_zero(fossil_sys_memory_t ptr, size_t size)
+void fossil_sys_memory_free_aligned(fossil_sys_memory_t ptr)
 {
-    if (!ptr || size == 0)
+    if (!ptr)
+        return;
+    if (fossil_sys_guard_on())
     {
-        fprintf(stderr, "Error: fossil_sys_memory_zero() - Invalid pointer or zero size.\n");
+        fossil_sys_stats_on_free(fossil_sys_guard_size(ptr));
+        fossil_sys_guard_free(ptr, "fossil_sys_memory_free_aligned");
         return;
     }
-
-    memset(ptr, 0, size);
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    fossil_sys_stats_on_free(FOSSIL_SYS_USABLE_SIZE(ptr));
+    free(ptr);
+#endif
 }
 
-int fossil_sys_memory_compare(const fossil_sys_memory_t ptr1, const fossil_sys_memory_t ptr2, size_t size)
+static size_t fossil_sys_memory_huge_length(size_t size)
 {
-    if (!ptr1 || !ptr2 || size == 0)
-    {
-        fprintf(stderr, "Error: fossil_sys_memory_compare() - Invalid pointers or zero size.\n");
-        return -1; // Return -1 for invalid input
-    }
-
-    return memcmp(ptr1, ptr2, size);
+    if (size > SIZE_MAX - (FOSSIL_SYS_HUGE_PAGE - 1))
+        return 0;
+    return (size + FOSSIL_SYS_HUGE_PAGE - 1) & ~(FOSSIL_SYS_HUGE_PAGE - 1);
 }
 
-fossil_sys_memory_t fossil_sys_memory_move(fossil_sys_memory_t dest, const fossil_sys_memory_t src, size_t size)
+fossil_sys_memory_t fossil_sys_memory_alloc_huge(size_t size)
 {
-    if (!dest || !src || size == 0)
+    size_t length = fossil_sys_memory_huge_length(size);
+    if (size == 0 || length == 0)
     {
-        fprintf(stderr, "Error: fossil_sys_memory_move() - Invalid source or destination pointers, or zero size.\n");
+        fprintf(stderr, "Error: fossil_sys_memory_alloc_huge() - Invalid size.\n");
         return NULL;
     }
 
-    return memmove(dest, src, size);
-}
-
-fossil_sys_memory_t fossil_sys_memory_resize(fossil_sys_memory_t ptr, size_t old_size, size_t new_size)
-{
-    if (ptr == NULL)
+#if defined(_WIN32)
+    SIZE_T large = GetLargePageMinimum();
+    if (large != 0 && length % large == 0)
     {
-        fprintf(stderr, "Error: fossil_sys_memory_resize() - Pointer is NULL.\n");
+        // Needs SeLockMemoryPrivilege; silently fall back to regular pages without it.
+        void *ptr = VirtualAlloc(NULL, length, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (ptr)
+            return ptr;
+    }
+    void *ptr = VirtualAlloc(NULL, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!ptr)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_alloc_huge() - Memory allocation failed.\n");
         return NULL;
     }
+    return ptr;
+#elif defined(__linux__)
+    // Explicit huge pages only succeed when the administrator reserved some of 2 MiB.
+    void *ptr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB,
+                     -1, 0);
+    if (ptr != MAP_FAILED)
+        return ptr;
 
-    if (new_size == 0)
+    // Otherwise over-map, trim to a 2 MiB boundary and ask for transparent huge pages.
+    if (length > SIZE_MAX - FOSSIL_SYS_HUGE_PAGE)
     {
-        fossil_sys_memory_free(ptr);
+        fprintf(stderr, "Error: fossil_sys_memory_alloc_huge() - Invalid size.\n");
         return NULL;
     }
-
-    // allocate new buffer
-    fossil_sys_memory_t new_ptr = malloc(new_size);
-    if (!new_ptr)
+    uint8_t *raw = (uint8_t *)mmap(NULL, length + FOSSIL_SYS_HUGE_PAGE, PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ((void *)raw == MAP_FAILED)
     {
-        fprintf(stderr, "Error: fossil_sys_memory_resize() - Memory allocation failed.\n");
-        return ptr; // keep old buffer
+        fprintf(stderr, "Error: fossil_sys_memory_alloc_huge() - Memory allocation failed.\n");
+        return NULL;
     }
 
-    // copy the smaller of old/new size
-    size_t copy_size = (new_size < old_size) ? new_size : old_size;
-    memcpy(new_ptr, ptr, copy_size);
-
-    // free old memory
-    fossil_sys_memory_free(ptr);
+    uint8_t *aligned = (uint8_t *)(((uintptr_t)raw + FOSSIL_SYS_HUGE_PAGE - 1) & ~(uintptr_t)(FOSSIL_SYS_HUGE_PAGE - 1));
+    size_t head = (size_t)(aligned - raw);
+    size_t tail = FOSSIL_SYS_HUGE_PAGE - head;
+    if (head)
+        munmap(raw, head);
+    if (tail)
+        munmap(aligned + length, tail);
 
-    return new_ptr;
+    madvise(aligned, length, MADV_HUGEPAGE); // Advisory; THP may be disabled
+    return aligned;
+#else
+    void *ptr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (ptr == MAP_FAILED)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_alloc_huge() - Memory allocation failed.\n");
+        return NULL;
+    }
+    return ptr;
+#endif
 }
 
-bool fossil_sys_memory_is_valid(const fossil_sys_memory_t ptr)
+void fossil_sys_memory_free_huge(fossil_sys_memory_t ptr, size_t size)
 {
     if (!ptr)
+        return;
+#if defined(_WIN32)
+    (void)size;
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    if (munmap(ptr, fossil_sys_memory_huge_length(size)) != 0)
     {
-        return false;
+#ifndef NDEBUG
+        fprintf(stderr, "Error: fossil_sys_memory_free_huge() - munmap failed; size does not match the allocation.\n");
+#endif
     }
-    // Optional: Add more validation logic if needed, but normally you'd rely on the caller to manage validity.
-    return true;
+#endif
 }
 
 // ----------------------- Memory Fill -----------------------
@@ -250,35 +2004,36 @@ fossil_sys_memory_t fossil_sys_memory_fill(fossil_sys_memory_t ptr,
         return NULL;
     }
 
-    uint8_t *dst = (uint8_t *)ptr;
-    size_t offset = 0;
-    while (offset + pattern_size <= total_size)
-    {
-        memcpy(dst + offset, pattern, pattern_size);
-        offset += pattern_size;
-    }
-    // Copy remaining bytes if any
-    if (offset < total_size)
-    {
-        memcpy(dst + offset, pattern, total_size - offset);
-    }
+    fossil_sys_memory_kernels()->fill((uint8_t *)ptr, (const uint8_t *)pattern, pattern_size, total_size);
     return ptr;
 }
 
 // ----------------------- Secure Zero -----------------------
 
+#if !defined(_MSC_VER) && !defined(__GNUC__) && !defined(__clang__)
+// Calling memset through a volatile pointer keeps the compiler from proving the store dead.
+static void *(*const volatile fossil_sys_memset_volatile)(void *, int, size_t) = memset;
+#endif
+
 void fossil_sys_memory_secure_zero(fossil_sys_memory_t ptr, size_t size)
 {
-    if (!ptr)
+    if (!ptr || size == 0)
         return;
 #if defined(_MSC_VER)
     SecureZeroMemory(ptr, size);
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 25))
+    explicit_bzero(ptr, size);
+#elif defined(__OpenBSD__) || defined(__FreeBSD__)
+    explicit_bzero(ptr, size);
+#elif defined(__APPLE__)
+    memset_s(ptr, size, 0, size);
 #elif defined(__GNUC__) || defined(__clang__)
-    volatile uint8_t *p = (volatile uint8_t *)ptr;
-    while (size--)
-        *p++ = 0;
+    // Full-width memset, then an empty asm that claims to read the buffer so the
+    // stores cannot be elided as dead.
+    memset(ptr, 0, size);
+    __asm__ __volatile__("" : : "r"(ptr) : "memory");
 #else
-    memset(ptr, 0, size); // Fallback (not guaranteed secure)
+    fossil_sys_memset_volatile(ptr, 0, size);
 #endif
 }
 
@@ -292,14 +2047,7 @@ void fossil_sys_memory_swap(fossil_sys_memory_t a, fossil_sys_memory_t b, size_t
         return;
     }
 
-    uint8_t *pa = (uint8_t *)a;
-    uint8_t *pb = (uint8_t *)b;
-    for (size_t i = 0; i < size; i++)
-    {
-        uint8_t tmp = pa[i];
-        pa[i] = pb[i];
-        pb[i] = tmp;
-    }
+    fossil_sys_memory_kernels()->swap((uint8_t *)a, (uint8_t *)b, size);
 }
 
 // ----------------------- Find Memory -----------------------
@@ -309,13 +2057,7 @@ void *fossil_sys_memory_find(const fossil_sys_memory_t ptr, uint8_t value, size_
     if (!ptr || size == 0)
         return NULL;
 
-    uint8_t *p = (uint8_t *)ptr;
-    for (size_t i = 0; i < size; i++)
-    {
-        if (p[i] == value)
-            return p + i;
-    }
-    return NULL;
+    return fossil_sys_memory_kernels()->find((const uint8_t *)ptr, value, size);
 }
 
 // ----------------------- strdup -----------------------
@@ -336,10 +2078,447 @@ char *fossil_sys_memory_strdup(const char *str)
 
 // ----------------------- Memory Stats -----------------------
 
+void fossil_sys_memory_get_stats(fossil_sys_memory_stats_t *out)
+{
+    if (!out)
+        return;
+    memset(out, 0, sizeof(*out));
+
+    int64_t live = 0;
+    fossil_sys_stats_block_t *block = atomic_load_explicit(&g_stats_head, memory_order_acquire);
+    for (; block; block = block->next)
+    {
+        out->alloc_count += atomic_load_explicit(&block->alloc_count, memory_order_relaxed);
+        out->realloc_count += atomic_load_explicit(&block->realloc_count, memory_order_relaxed);
+        out->free_count += atomic_load_explicit(&block->free_count, memory_order_relaxed);
+        out->alloc_bytes += atomic_load_explicit(&block->alloc_bytes, memory_order_relaxed);
+        live += atomic_load_explicit(&block->live_bytes, memory_order_relaxed);
+        for (size_t i = 0; i < FOSSIL_SYS_MEMORY_SIZE_CLASSES; i++)
+            out->size_classes[i] += atomic_load_explicit(&block->size_classes[i], memory_order_relaxed);
+    }
+
+    out->live_bytes = live > 0 ? (uint64_t)live : 0;
+    uint64_t peak = atomic_load_explicit(&g_stats_peak, memory_order_relaxed);
+    out->peak_bytes = peak > out->live_bytes ? peak : out->live_bytes;
+}
+
 void fossil_sys_memory_stats(size_t *out_allocs, size_t *out_bytes)
 {
+    fossil_sys_memory_stats_t stats;
+    fossil_sys_memory_get_stats(&stats);
+
     if (out_allocs)
-        *out_allocs = g_alloc_count;
+        *out_allocs = stats.alloc_count > stats.free_count ? (size_t)(stats.alloc_count - stats.free_count) : 0;
     if (out_bytes)
-        *out_bytes = g_alloc_bytes;
+        *out_bytes = (size_t)stats.live_bytes;
+}
+
+// ----------------------- Arena Allocator -----------------------
+
+#define FOSSIL_SYS_ARENA_DEFAULT_BLOCK (64 * 1024)
+
+typedef struct fossil_sys_arena_block
+{
+    struct fossil_sys_arena_block *next;
+    size_t capacity;
+    size_t used;
+    max_align_t data[]; // Block payload, aligned for any fundamental type
+} fossil_sys_arena_block_t;
+
+struct fossil_sys_memory_arena
+{
+    fossil_sys_arena_block_t *first;   // First block, never released before destroy
+    fossil_sys_arena_block_t *current; // Block currently bumped into
+    size_t block_size;
+};
+
+static fossil_sys_arena_block_t *fossil_sys_arena_block_new(size_t capacity)
+{
+    fossil_sys_arena_block_t *block = (fossil_sys_arena_block_t *)malloc(sizeof(*block) + capacity);
+    if (!block)
+        return NULL;
+    block->next = NULL;
+    block->capacity = capacity;
+    block->used = 0;
+    return block;
+}
+
+// Returns the offset inside block at which size bytes with the given
+// alignment fit, or SIZE_MAX if they do not fit.
+static size_t fossil_sys_arena_block_fit(const fossil_sys_arena_block_t *block, size_t size, size_t alignment)
+{
+    uintptr_t base = (uintptr_t)block->data;
+    uintptr_t addr = (base + block->used + (alignment - 1)) & ~(uintptr_t)(alignment - 1);
+    size_t offset = (size_t)(addr - base);
+    if (offset > block->capacity || size > block->capacity - offset)
+        return SIZE_MAX;
+    return offset;
+}
+
+fossil_sys_memory_arena_t *fossil_sys_memory_arena_create(size_t block_size)
+{
+    fossil_sys_memory_arena_t *arena = (fossil_sys_memory_arena_t *)malloc(sizeof(*arena));
+    if (!arena)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_arena_create() - Memory allocation failed.\n");
+        return NULL;
+    }
+
+    arena->block_size = block_size ? block_size : FOSSIL_SYS_ARENA_DEFAULT_BLOCK;
+    arena->first = fossil_sys_arena_block_new(arena->block_size);
+    if (!arena->first)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_arena_create() - Memory allocation failed.\n");
+        free(arena);
+        return NULL;
+    }
+    arena->current = arena->first;
+    return arena;
+}
+
+fossil_sys_memory_t fossil_sys_memory_arena_alloc_aligned(fossil_sys_memory_arena_t *arena, size_t size, size_t alignment)
+{
+    if (!arena || size == 0)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_arena_alloc() - Invalid arena or zero size.\n");
+        return NULL;
+    }
+
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_arena_alloc() - Alignment must be a power of two.\n");
+        return NULL;
+    }
+
+    fossil_sys_arena_block_t *block = arena->current;
+    size_t offset = fossil_sys_arena_block_fit(block, size, alignment);
+
+    // Walk forward through blocks kept from before a reset/rewind, then grow.
+    while (offset == SIZE_MAX)
+    {
+        fossil_sys_arena_block_t *next = block->next;
+        if (next)
+        {
+            next->used = 0;
+            offset = fossil_sys_arena_block_fit(next, size, alignment);
+            if (offset == SIZE_MAX)
+            {
+                // Retained block too small for this request: splice in a larger one.
+                next = NULL;
+            }
+        }
+
+        if (!next)
+        {
+            if (size > SIZE_MAX - alignment)
+            {
+                fprintf(stderr, "Error: fossil_sys_memory_arena_alloc() - Size overflow.\n");
+                return NULL;
+            }
+            size_t capacity = size + alignment > arena->block_size ? size + alignment : arena->block_size;
+            next = fossil_sys_arena_block_new(capacity);
+            if (!next)
+            {
+                fprintf(stderr, "Error: fossil_sys_memory_arena_alloc() - Memory allocation failed.\n");
+                return NULL;
+            }
+            next->next = block->next;
+            block->next = next;
+            offset = fossil_sys_arena_block_fit(next, size, alignment);
+        }
+        block = next;
+    }
+
+    arena->current = block;
+    block->used = offset + size;
+    return (uint8_t *)block->data + offset;
+}
+
+fossil_sys_memory_t fossil_sys_memory_arena_alloc(fossil_sys_memory_arena_t *arena, size_t size)
+{
+    return fossil_sys_memory_arena_alloc_aligned(arena, size, _Alignof(max_align_t));
+}
+
+fossil_sys_memory_arena_mark_t fossil_sys_memory_arena_mark(const fossil_sys_memory_arena_t *arena)
+{
+    fossil_sys_memory_arena_mark_t mark = {NULL, 0};
+    if (arena)
+    {
+        mark.block = arena->current;
+        mark.offset = arena->current->used;
+    }
+    return mark;
+}
+
+void fossil_sys_memory_arena_rewind(fossil_sys_memory_arena_t *arena, fossil_sys_memory_arena_mark_t mark)
+{
+    if (!arena)
+        return;
+
+    if (!mark.block)
+    {
+        fossil_sys_memory_arena_reset(arena);
+        return;
+    }
+
+    // Later blocks are zeroed lazily as the bump pointer reaches them again.
+    arena->current = (fossil_sys_arena_block_t *)mark.block;
+    arena->current->used = mark.offset;
+}
+
+void fossil_sys_memory_arena_reset(fossil_sys_memory_arena_t *arena)
+{
+    if (!arena)
+        return;
+    arena->current = arena->first;
+    arena->first->used = 0;
+}
+
+void fossil_sys_memory_arena_destroy(fossil_sys_memory_arena_t *arena)
+{
+    if (!arena)
+        return;
+
+    fossil_sys_arena_block_t *block = arena->first;
+    while (block)
+    {
+        fossil_sys_arena_block_t *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+// ----------------------- Object Pool -----------------------
+
+#define FOSSIL_SYS_POOL_DEFAULT_SLAB 256 // Objects per slab
+#define FOSSIL_SYS_POOL_MAGAZINE 64      // Objects cached per thread
+#define FOSSIL_SYS_POOL_CACHES 64        // Per-thread magazine slots per pool
+
+typedef struct fossil_sys_pool_slab
+{
+    struct fossil_sys_pool_slab *next;
+    max_align_t data[]; // Object storage
+} fossil_sys_pool_slab_t;
+
+typedef struct
+{
+    atomic_flag busy; // Held by the owning thread; another thread mapped here falls back to the depot
+    size_t count;
+    void *objects[FOSSIL_SYS_POOL_MAGAZINE];
+} fossil_sys_pool_magazine_t;
+
+struct fossil_sys_memory_pool
+{
+    size_t object_size;
+    size_t objects_per_slab;
+
+    // Global depot: free objects chained through their first word, plus the
+    // slab list. Only touched when a magazine runs empty or overflows.
+    fossil_sys_memory_lock_t depot_lock;
+    void *depot;
+    fossil_sys_pool_slab_t *slabs;
+
+    _Atomic(fossil_sys_pool_magazine_t *) magazines[FOSSIL_SYS_POOL_CACHES];
+};
+
+static atomic_uint g_pool_thread_seq = 0;
+static FOSSIL_SYS_THREAD_LOCAL unsigned g_pool_thread_slot = 0; // 0 = not yet assigned
+
+static fossil_sys_pool_magazine_t *fossil_sys_pool_magazine_get(fossil_sys_memory_pool_t *pool)
+{
+    if (g_pool_thread_slot == 0)
+        g_pool_thread_slot = atomic_fetch_add_explicit(&g_pool_thread_seq, 1, memory_order_relaxed) + 1;
+
+    _Atomic(fossil_sys_pool_magazine_t *) *slot = &pool->magazines[(g_pool_thread_slot - 1) % FOSSIL_SYS_POOL_CACHES];
+    fossil_sys_pool_magazine_t *mag = atomic_load_explicit(slot, memory_order_acquire);
+    if (!mag)
+    {
+        fossil_sys_pool_magazine_t *fresh = (fossil_sys_pool_magazine_t *)malloc(sizeof(*fresh));
+        if (!fresh)
+            return NULL;
+        atomic_flag_clear(&fresh->busy);
+        fresh->count = 0;
+        if (atomic_compare_exchange_strong_explicit(slot, &mag, fresh, memory_order_acq_rel, memory_order_acquire))
+            mag = fresh;
+        else
+            free(fresh); // Lost the race; mag now holds the winner
+    }
+
+    if (atomic_flag_test_and_set_explicit(&mag->busy, memory_order_acquire))
+        return NULL; // Another thread shares this slot right now
+    return mag;
+}
+
+// Must be called with the depot lock held.
+static int fossil_sys_pool_grow(fossil_sys_memory_pool_t *pool)
+{
+    size_t bytes = pool->object_size * pool->objects_per_slab;
+    fossil_sys_pool_slab_t *slab = (fossil_sys_pool_slab_t *)malloc(sizeof(*slab) + bytes);
+    if (!slab)
+        return -1;
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+
+    uint8_t *base = (uint8_t *)slab->data;
+    for (size_t i = pool->objects_per_slab; i-- > 0;)
+    {
+        void *obj = base + i * pool->object_size;
+        *(void **)obj = pool->depot;
+        pool->depot = obj;
+    }
+    return 0;
+}
+
+// Moves up to want objects from the depot into out; returns how many were moved.
+static size_t fossil_sys_pool_depot_take(fossil_sys_memory_pool_t *pool, void **out, size_t want)
+{
+    size_t got = 0;
+    fossil_sys_memory_lock_acquire(&pool->depot_lock);
+    if (!pool->depot)
+        fossil_sys_pool_grow(pool);
+    while (got < want && pool->depot)
+    {
+        void *obj = pool->depot;
+        pool->depot = *(void **)obj;
+        out[got++] = obj;
+    }
+    fossil_sys_memory_lock_release(&pool->depot_lock);
+    return got;
+}
+
+static void fossil_sys_pool_depot_put(fossil_sys_memory_pool_t *pool, void *const *objs, size_t count)
+{
+    fossil_sys_memory_lock_acquire(&pool->depot_lock);
+    for (size_t i = 0; i < count; i++)
+    {
+        *(void **)objs[i] = pool->depot;
+        pool->depot = objs[i];
+    }
+    fossil_sys_memory_lock_release(&pool->depot_lock);
+}
+
+fossil_sys_memory_pool_t *fossil_sys_memory_pool_create(size_t object_size, size_t objects_per_slab)
+{
+    if (object_size == 0)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_pool_create() - Object size cannot be zero.\n");
+        return NULL;
+    }
+
+    // Objects are laid out back to back from a max_align_t boundary, so the
+    // stride must be a multiple of the strictest alignment an object of
+    // this size can need: the largest power of two not above it, capped at
+    // max_align_t. They also double as free-list links, hence the pointer
+    // floor.
+    size_t align = sizeof(void *);
+    while (align < _Alignof(max_align_t) && align * 2 <= object_size)
+        align *= 2;
+    if (object_size > SIZE_MAX - align)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_pool_create() - Object size too large.\n");
+        return NULL;
+    }
+    object_size = (object_size + align - 1) & ~(align - 1);
+
+    fossil_sys_memory_pool_t *pool = (fossil_sys_memory_pool_t *)malloc(sizeof(*pool));
+    if (!pool)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_pool_create() - Memory allocation failed.\n");
+        return NULL;
+    }
+
+    pool->object_size = object_size;
+    pool->objects_per_slab = objects_per_slab ? objects_per_slab : FOSSIL_SYS_POOL_DEFAULT_SLAB;
+    if (pool->objects_per_slab > (SIZE_MAX - sizeof(fossil_sys_pool_slab_t)) / object_size)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_pool_create() - Slab size overflow.\n");
+        free(pool);
+        return NULL;
+    }
+    fossil_sys_memory_lock_init(&pool->depot_lock);
+    pool->depot = NULL;
+    pool->slabs = NULL;
+    for (size_t i = 0; i < FOSSIL_SYS_POOL_CACHES; i++)
+        atomic_init(&pool->magazines[i], NULL);
+    return pool;
+}
+
+fossil_sys_memory_t fossil_sys_memory_pool_alloc(fossil_sys_memory_pool_t *pool)
+{
+    if (!pool)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_pool_alloc() - Pool is NULL.\n");
+        return NULL;
+    }
+
+    void *obj = NULL;
+    fossil_sys_pool_magazine_t *mag = fossil_sys_pool_magazine_get(pool);
+    if (mag)
+    {
+        if (mag->count == 0)
+            mag->count = fossil_sys_pool_depot_take(pool, mag->objects, FOSSIL_SYS_POOL_MAGAZINE / 2);
+        if (mag->count > 0)
+            obj = mag->objects[--mag->count];
+        atomic_flag_clear_explicit(&mag->busy, memory_order_release);
+    }
+    else
+    {
+        fossil_sys_pool_depot_take(pool, &obj, 1);
+    }
+
+    if (!obj)
+        fprintf(stderr, "Error: fossil_sys_memory_pool_alloc() - Memory allocation failed.\n");
+    return obj;
+}
+
+void fossil_sys_memory_pool_free(fossil_sys_memory_pool_t *pool, fossil_sys_memory_t ptr)
+{
+    if (!pool || !ptr)
+    {
+        fprintf(stderr, "Error: fossil_sys_memory_pool_free() - Pool or pointer is NULL.\n");
+        return;
+    }
+
+    fossil_sys_pool_magazine_t *mag = fossil_sys_pool_magazine_get(pool);
+    if (!mag)
+    {
+        fossil_sys_pool_depot_put(pool, &ptr, 1);
+        return;
+    }
+
+    if (mag->count == FOSSIL_SYS_POOL_MAGAZINE)
+    {
+        // Hand the older half back to the depot so other threads can reuse it.
+        size_t half = FOSSIL_SYS_POOL_MAGAZINE / 2;
+        fossil_sys_pool_depot_put(pool, mag->objects, half);
+        memmove(mag->objects, mag->objects + half, (mag->count - half) * sizeof(void *));
+        mag->count -= half;
+    }
+    mag->objects[mag->count++] = ptr;
+    atomic_flag_clear_explicit(&mag->busy, memory_order_release);
+}
+
+size_t fossil_sys_memory_pool_object_size(const fossil_sys_memory_pool_t *pool)
+{
+    return pool ? pool->object_size : 0;
+}
+
+void fossil_sys_memory_pool_destroy(fossil_sys_memory_pool_t *pool)
+{
+    if (!pool)
+        return;
+
+    for (size_t i = 0; i < FOSSIL_SYS_POOL_CACHES; i++)
+        free(atomic_load_explicit(&pool->magazines[i], memory_order_acquire));
+
+    fossil_sys_pool_slab_t *slab = pool->slabs;
+    while (slab)
+    {
+        fossil_sys_pool_slab_t *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    fossil_sys_memory_lock_destroy(&pool->depot_lock);
+    free(pool);
 }
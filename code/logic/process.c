@@ -22,11 +22,32 @@
  * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
  * -----------------------------------------------------------------------------
  */
+// Must be defined before any system header for openat, pread and dirfd
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
 #include "fossil/sys/process.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+/*
+ * Each platform provides these for list and the CPU sampler.
+ * CPU time is in nanoseconds; start_time is any value that
+ * differs between two processes that had the same pid.
+ */
+typedef int (*fossil_sys_process_visit_t)(void *context, fossil_sys_process_info_t *info, uint64_t cpu_ns,
+                                          uint64_t start_time);
+
+// Visit every process once; stops early when visit returns nonzero.
+static int fossil_sys_process_scan(fossil_sys_process_visit_t visit, void *context);
+
+// Fill info and read the CPU time of one process.
+static int fossil_sys_process_sample(uint32_t pid, fossil_sys_process_info_t *info, uint64_t *cpu_ns,
+                                     uint64_t *start_time);
+
+static uint64_t fossil_sys_process_now_ns(void);
+
 #if defined(__linux__) || defined(__APPLE__)
 #include <unistd.h>
 #include <dirent.h>
@@ -48,6 +69,139 @@ static void fossil_sys_zero(void *ptr, size_t size)
         memset(ptr, 0, size);
 }
 
+/*
+ * /proc/<pid>/stat parser
+ *
+ * Everything get_info reports (name, parent, threads, memory)
+ * and the CPU times are on the one line of /proc/<pid>/stat,
+ * so each process costs one open and one pread into a stack
+ * buffer, parsed in place without stdio or allocation.
+ */
+#define FOSSIL_SYS_PROCESS_STAT_BUFFER 1024
+
+typedef struct
+{
+    char name[FOSSIL_SYS_PROCESS_NAME_MAX]; // comm, at most 15 characters from the kernel
+    uint32_t ppid;
+    uint32_t threads;
+    uint64_t utime;      // clock ticks in user mode
+    uint64_t stime;      // clock ticks in kernel mode
+    uint64_t start_time; // clock ticks after boot
+    uint64_t vsize;      // bytes
+    uint64_t rss;        // pages
+} fossil_sys_process_stat_t;
+
+// Writes "<pid>/stat" after prefix into path.
+static void fossil_sys_process_stat_path(char *path, const char *prefix, uint32_t pid)
+{
+    char digits[10];
+    size_t count = 0;
+    do
+    {
+        digits[count++] = (char)('0' + pid % 10);
+        pid /= 10;
+    } while (pid);
+
+    while (*prefix)
+        *path++ = *prefix++;
+    while (count)
+        *path++ = digits[--count];
+    memcpy(path, "/stat", sizeof("/stat"));
+}
+
+/*
+ * Reads and parses the stat line of pid. proc_fd is an open
+ * /proc directory (as list has) or -1 to use the full path.
+ * Returns 0 on success, -2 if the file cannot be opened and
+ * -3 if it cannot be read or parsed.
+ */
+static int fossil_sys_process_read_stat(int proc_fd, uint32_t pid, fossil_sys_process_stat_t *st)
+{
+    char path[32];
+    fossil_sys_process_stat_path(path, proc_fd < 0 ? "/proc/" : "", pid);
+    int fd = proc_fd < 0 ? open(path, O_RDONLY | O_CLOEXEC) : openat(proc_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -2;
+
+    char buf[FOSSIL_SYS_PROCESS_STAT_BUFFER];
+    ssize_t len = pread(fd, buf, sizeof(buf), 0);
+    close(fd);
+    if (len <= 0)
+        return -3;
+    const char *end = buf + len;
+
+    // comm may itself contain spaces and parentheses, so it runs
+    // from the first '(' to the last ')'.
+    const char *open_paren = memchr(buf, '(', (size_t)len);
+    const char *close_paren = end;
+    while (close_paren > buf && *--close_paren != ')')
+        ;
+    if (!open_paren || close_paren <= open_paren)
+        return -3;
+
+    size_t name_len = (size_t)(close_paren - open_paren - 1);
+    if (name_len >= sizeof(st->name))
+        name_len = sizeof(st->name) - 1;
+    memcpy(st->name, open_paren + 1, name_len);
+    st->name[name_len] = '\0';
+
+    // Fields after comm are single space separated, starting with
+    // state as field 3 (see proc(5)).
+    const char *p = close_paren + 2;
+    int field = 3;
+    for (; p < end && field <= 24; field++)
+    {
+        uint64_t value = 0;
+        for (; p < end && *p != ' ' && *p != '\n'; p++)
+        {
+            if (*p >= '0' && *p <= '9')
+                value = value * 10 + (uint64_t)(*p - '0');
+        }
+        p++;
+
+        switch (field)
+        {
+        case 4:
+            st->ppid = (uint32_t)value;
+            break;
+        case 14:
+            st->utime = value;
+            break;
+        case 15:
+            st->stime = value;
+            break;
+        case 20:
+            st->threads = (uint32_t)value;
+            break;
+        case 22:
+            st->start_time = value;
+            break;
+        case 23:
+            st->vsize = value;
+            break;
+        case 24:
+            st->rss = value;
+            break;
+        default:
+            break;
+        }
+    }
+    return field > 24 ? 0 : -3;
+}
+
+static void fossil_sys_process_fill_info(uint32_t pid, const fossil_sys_process_stat_t *st, uint64_t page_size,
+                                         fossil_sys_process_info_t *info)
+{
+    fossil_sys_zero(info, sizeof(*info));
+    info->pid = pid;
+    info->ppid = st->ppid;
+    memcpy(info->name, st->name, sizeof(info->name));
+    info->memory_bytes = st->rss * page_size;
+    info->virtual_memory_bytes = st->vsize;
+    info->thread_count = st->threads;
+    info->cpu_percent = 0.0f; // filled in by a sampler
+}
+
 uint32_t fossil_sys_process_get_pid(void)
 {
     return (uint32_t)getpid();
@@ -58,22 +212,16 @@ int fossil_sys_process_get_name(uint32_t pid, char *name, size_t name_len)
     if (!name || name_len == 0)
         return -1;
 
-    char path[256];
-    snprintf(path, sizeof(path), "/proc/%u/comm", pid);
-    FILE *fp = fopen(path, "r");
-    if (!fp)
-        return -2;
-
-    if (!fgets(name, name_len, fp))
-    {
-        fclose(fp);
-        return -3;
-    }
-    fclose(fp);
+    fossil_sys_process_stat_t st;
+    int status = fossil_sys_process_read_stat(-1, pid, &st);
+    if (status != 0)
+        return status;
 
-    size_t len = strlen(name);
-    if (len > 0 && name[len - 1] == '\n')
-        name[len - 1] = '\0';
+    size_t len = strlen(st.name);
+    if (len >= name_len)
+        len = name_len - 1;
+    memcpy(name, st.name, len);
+    name[len] = '\0';
     return 0;
 }
 
@@ -81,70 +229,50 @@ int fossil_sys_process_get_info(uint32_t pid, fossil_sys_process_info_t *info)
 {
     if (!info)
         return -1;
-    fossil_sys_zero(info, sizeof(*info));
-    info->pid = pid;
 
-    // Name
-    if (fossil_sys_process_get_name(pid, info->name, sizeof(info->name)) != 0)
-        strncpy(info->name, "unknown", sizeof(info->name));
-
-    // Parent PID
-    char path[256];
-    snprintf(path, sizeof(path), "/proc/%u/stat", pid);
-    FILE *fp = fopen(path, "r");
-    if (fp)
-    {
-        int scanned = fscanf(fp, "%*d %*s %*c %u", &info->ppid);
-        fclose(fp);
-        if (scanned != 1)
-            info->ppid = 0;
-    }
-
-    // Memory usage
-    snprintf(path, sizeof(path), "/proc/%u/statm", pid);
-    fp = fopen(path, "r");
-    if (fp)
+    fossil_sys_process_stat_t st;
+    if (fossil_sys_process_read_stat(-1, pid, &st) != 0)
     {
-        unsigned long size = 0, resident = 0;
-        if (fscanf(fp, "%lu %lu", &size, &resident) == 2)
-        {
-            long page_size = sysconf(_SC_PAGESIZE);
-            info->virtual_memory_bytes = (uint64_t)size * page_size;
-            info->memory_bytes = (uint64_t)resident * page_size;
-        }
-        fclose(fp);
-    }
-
-    // Thread count
-    snprintf(path, sizeof(path), "/proc/%u/status", pid);
-    fp = fopen(path, "r");
-    if (fp)
-    {
-        char line[512];
-        while (fgets(line, sizeof(line), fp))
-        {
-            if (sscanf(line, "Threads: %u", &info->thread_count) == 1)
-                break;
-        }
-        fclose(fp);
+        fossil_sys_zero(info, sizeof(*info));
+        info->pid = pid;
+        strncpy(info->name, "unknown", sizeof(info->name));
+        return 0;
     }
+    fossil_sys_process_fill_info(pid, &st, (uint64_t)sysconf(_SC_PAGESIZE), info);
+    return 0;
+}
 
-    // CPU usage placeholder
-    info->cpu_percent = 0.0f;
+static uint64_t fossil_sys_process_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
 
+static int fossil_sys_process_sample(uint32_t pid, fossil_sys_process_info_t *info, uint64_t *cpu_ns,
+                                     uint64_t *start_time)
+{
+    fossil_sys_process_stat_t st;
+    int status = fossil_sys_process_read_stat(-1, pid, &st);
+    if (status != 0)
+        return status;
+    fossil_sys_process_fill_info(pid, &st, (uint64_t)sysconf(_SC_PAGESIZE), info);
+    *cpu_ns = (st.utime + st.stime) * (1000000000u / (uint64_t)sysconf(_SC_CLK_TCK));
+    *start_time = st.start_time;
     return 0;
 }
 
-int fossil_sys_process_list(fossil_sys_process_list_t *plist)
+static int fossil_sys_process_scan(fossil_sys_process_visit_t visit, void *context)
 {
-    if (!plist)
-        return -1;
-    plist->count = 0;
-
     DIR *dir = opendir("/proc");
     if (!dir)
         return -2;
 
+    int proc_fd = dirfd(dir);
+    uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+    uint64_t tick_ns = 1000000000u / (uint64_t)sysconf(_SC_CLK_TCK);
+    fossil_sys_process_stat_t st;
+    fossil_sys_process_info_t info;
     struct dirent *entry;
     while ((entry = readdir(dir)))
     {
@@ -153,15 +281,36 @@ int fossil_sys_process_list(fossil_sys_process_list_t *plist)
         if (*endptr != '\0')
             continue;
 
-        if (plist->count >= FOSSIL_SYS_PROCESS_MAX)
+        // Processes that exit between readdir and the read are skipped
+        if (fossil_sys_process_read_stat(proc_fd, pid, &st) != 0)
+            continue;
+        fossil_sys_process_fill_info(pid, &st, page_size, &info);
+        if (visit(context, &info, (st.utime + st.stime) * tick_ns, st.start_time))
             break;
-        fossil_sys_process_get_info(pid, &plist->list[plist->count++]);
     }
 
     closedir(dir);
     return 0;
 }
 
+static int fossil_sys_process_list_visit(void *context, fossil_sys_process_info_t *info, uint64_t cpu_ns,
+                                         uint64_t start_time)
+{
+    (void)cpu_ns;
+    (void)start_time;
+    fossil_sys_process_list_t *plist = (fossil_sys_process_list_t *)context;
+    plist->list[plist->count++] = *info;
+    return plist->count >= FOSSIL_SYS_PROCESS_MAX;
+}
+
+int fossil_sys_process_list(fossil_sys_process_list_t *plist)
+{
+    if (!plist)
+        return -1;
+    plist->count = 0;
+    return fossil_sys_process_scan(fossil_sys_process_list_visit, plist);
+}
+
 int fossil_sys_process_terminate(uint32_t pid, int force)
 {
     if (pid == (uint32_t)getpid())
@@ -310,17 +459,13 @@ int fossil_sys_process_get_exe_path(uint32_t pid, char *buffer, size_t buf_len)
 
 int fossil_sys_process_get_ppid(uint32_t pid)
 {
-    char path[256];
-    snprintf(path, sizeof(path), "/proc/%u/stat", pid);
-    FILE *fp = fopen(path, "r");
-    if (!fp)
+    fossil_sys_process_stat_t st;
+    int status = fossil_sys_process_read_stat(-1, pid, &st);
+    if (status == -2)
         return -1;
-    int ppid = 0;
-    int scanned = fscanf(fp, "%*d %*s %*c %d", &ppid);
-    fclose(fp);
-    if (scanned != 1)
+    if (status != 0)
         return 0;
-    return ppid;
+    return (int)st.ppid;
 }
 
 int fossil_sys_process_send_signal(uint32_t pid, int signal)
@@ -416,6 +561,71 @@ int fossil_sys_process_list(fossil_sys_process_list_t *plist)
     return 0;
 }
 
+static uint64_t fossil_sys_process_filetime(FILETIME ft)
+{
+    return ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+}
+
+static uint64_t fossil_sys_process_now_ns(void)
+{
+    LARGE_INTEGER count, freq;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    uint64_t ticks = (uint64_t)count.QuadPart, hz = (uint64_t)freq.QuadPart;
+    return ticks / hz * 1000000000u + ticks % hz * 1000000000u / hz;
+}
+
+// Kernel plus user time and creation time, both from GetProcessTimes.
+static int fossil_sys_process_times(uint32_t pid, uint64_t *cpu_ns, uint64_t *start_time)
+{
+    HANDLE h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (!h)
+        return -2;
+    FILETIME created, exited, kernel, user;
+    BOOL ok = GetProcessTimes(h, &created, &exited, &kernel, &user);
+    CloseHandle(h);
+    if (!ok)
+        return -3;
+    *cpu_ns = (fossil_sys_process_filetime(kernel) + fossil_sys_process_filetime(user)) * 100;
+    *start_time = fossil_sys_process_filetime(created);
+    return 0;
+}
+
+static int fossil_sys_process_sample(uint32_t pid, fossil_sys_process_info_t *info, uint64_t *cpu_ns,
+                                     uint64_t *start_time)
+{
+    fossil_sys_process_get_info(pid, info);
+    return fossil_sys_process_times(pid, cpu_ns, start_time);
+}
+
+static int fossil_sys_process_scan(fossil_sys_process_visit_t visit, void *context)
+{
+    HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snap == INVALID_HANDLE_VALUE)
+        return -2;
+    PROCESSENTRY32 pe;
+    pe.dwSize = sizeof(pe);
+    fossil_sys_process_info_t info;
+    if (Process32First(snap, &pe))
+    {
+        do
+        {
+            memset(&info, 0, sizeof(info));
+            info.pid = pe.th32ProcessID;
+            info.ppid = pe.th32ParentProcessID;
+            info.thread_count = pe.cntThreads;
+            fossil_strlcpy(info.name, sizeof(info.name), pe.szExeFile);
+            // Protected processes refuse the query and are reported idle
+            uint64_t cpu_ns = 0, start_time = 0;
+            fossil_sys_process_times(info.pid, &cpu_ns, &start_time);
+            if (visit(context, &info, cpu_ns, start_time))
+                break;
+        } while (Process32Next(snap, &pe));
+    }
+    CloseHandle(snap);
+    return 0;
+}
+
 int fossil_sys_process_terminate(uint32_t pid, int force)
 {
     if (pid == GetCurrentProcessId())
@@ -742,6 +952,25 @@ int fossil_sys_process_list(fossil_sys_process_list_t *plist)
     return -1;
 }
 
+static uint64_t fossil_sys_process_now_ns(void) { return 0; }
+
+static int fossil_sys_process_sample(uint32_t pid, fossil_sys_process_info_t *info, uint64_t *cpu_ns,
+                                     uint64_t *start_time)
+{
+    (void)pid;
+    (void)info;
+    (void)cpu_ns;
+    (void)start_time;
+    return -1;
+}
+
+static int fossil_sys_process_scan(fossil_sys_process_visit_t visit, void *context)
+{
+    (void)visit;
+    (void)context;
+    return -1;
+}
+
 int fossil_sys_process_terminate(uint32_t pid, int force)
 {
     (void)pid;
@@ -827,3 +1056,236 @@ int fossil_sys_process_send_signal(uint32_t pid, int signal)
     return -1;
 }
 #endif
+
+/* ------------------------------------------------------
+ * CPU Sampler
+ *
+ * The sampler keeps each pid's CPU time at its last sample
+ * in an open-addressing table. Entries carry the refresh
+ * generation that last saw them; one that missed a whole
+ * refresh belongs to an exited process, so the next insert
+ * probing past it takes its slot and a rebuild drops it.
+ * No refresh pays for a sweep of the table.
+ * ----------------------------------------------------- */
+#define FOSSIL_SYS_PROCESS_SAMPLER_MIN_SLOTS 64
+#define FOSSIL_SYS_PROCESS_SAMPLE_MIN_NS 100000000u // shorter windows keep the last percentage
+
+typedef struct
+{
+    uint32_t pid;
+    uint32_t seen;       // generation of the last sample (0 = empty slot)
+    uint64_t start_time; // tells a reused pid apart
+    uint64_t cpu_ns;     // CPU time at the last sample
+    uint64_t stamp_ns;   // monotonic time of the last sample
+    float percent;       // result of the last sample
+} fossil_sys_process_sample_t;
+
+struct fossil_sys_process_sampler
+{
+    fossil_sys_process_sample_t *slots;
+    fossil_sys_process_sample_t *spare; // previous table, reused by a rebuild of the same size
+    size_t mask;
+    size_t spare_slots;
+    size_t used; // occupied slots, live or stale
+    uint32_t generation;
+};
+
+static int fossil_sys_process_sample_stale(const fossil_sys_process_sampler_t *sampler,
+                                           const fossil_sys_process_sample_t *slot)
+{
+    return slot->seen + 1 < sampler->generation;
+}
+
+static size_t fossil_sys_process_sample_home(const fossil_sys_process_sampler_t *sampler, uint32_t pid)
+{
+    return (size_t)(uint32_t)(pid * 2654435761u) & sampler->mask;
+}
+
+// Rebuilds the table with only live entries at no more than half load.
+static int fossil_sys_process_sampler_rehash(fossil_sys_process_sampler_t *sampler)
+{
+    size_t live = 0;
+    for (size_t i = 0; i <= sampler->mask; i++)
+        if (sampler->slots[i].seen && !fossil_sys_process_sample_stale(sampler, &sampler->slots[i]))
+            live++;
+
+    size_t capacity = FOSSIL_SYS_PROCESS_SAMPLER_MIN_SLOTS;
+    while (capacity < (live + 1) * 2)
+        capacity <<= 1;
+
+    // Steady churn rebuilds at the same size; swapping between two
+    // tables then costs a memset instead of faulting in fresh pages.
+    fossil_sys_process_sample_t *slots;
+    if (sampler->spare && sampler->spare_slots == capacity)
+    {
+        slots = sampler->spare;
+        memset(slots, 0, capacity * sizeof(*slots));
+    }
+    else
+    {
+        slots = (fossil_sys_process_sample_t *)calloc(capacity, sizeof(*slots));
+        if (!slots)
+            return -1;
+        free(sampler->spare);
+    }
+    sampler->spare = NULL;
+    sampler->spare_slots = 0;
+
+    fossil_sys_process_sample_t *old = sampler->slots;
+    size_t old_mask = sampler->mask;
+    sampler->slots = slots;
+    sampler->mask = capacity - 1;
+    for (size_t i = 0; i <= old_mask; i++)
+    {
+        if (!old[i].seen || fossil_sys_process_sample_stale(sampler, &old[i]))
+            continue;
+        size_t index = fossil_sys_process_sample_home(sampler, old[i].pid);
+        while (slots[index].seen)
+            index = (index + 1) & sampler->mask;
+        slots[index] = old[i];
+    }
+    sampler->used = live;
+    if (old_mask + 1 == capacity)
+    {
+        sampler->spare = old;
+        sampler->spare_slots = capacity;
+    }
+    else
+        free(old);
+    return 0;
+}
+
+// Finds pid's entry or claims one for it; *fresh is set for a new entry.
+static fossil_sys_process_sample_t *fossil_sys_process_sampler_slot(fossil_sys_process_sampler_t *sampler,
+                                                                    uint32_t pid, int *fresh)
+{
+    fossil_sys_process_sample_t *reuse = NULL;
+    size_t index = fossil_sys_process_sample_home(sampler, pid);
+    while (sampler->slots[index].seen)
+    {
+        fossil_sys_process_sample_t *slot = &sampler->slots[index];
+        if (slot->pid == pid)
+        {
+            *fresh = 0;
+            return slot;
+        }
+        if (!reuse && fossil_sys_process_sample_stale(sampler, slot))
+            reuse = slot;
+        index = (index + 1) & sampler->mask;
+    }
+
+    *fresh = 1;
+    if (reuse)
+        return reuse;
+    if ((sampler->used + 1) * 4 > (sampler->mask + 1) * 3)
+    {
+        if (fossil_sys_process_sampler_rehash(sampler) == 0)
+            return fossil_sys_process_sampler_slot(sampler, pid, fresh);
+        if (sampler->used + 1 > sampler->mask)
+            return NULL; // keep one empty slot so probes terminate
+    }
+    sampler->used++;
+    return &sampler->slots[index];
+}
+
+static float fossil_sys_process_sampler_update(fossil_sys_process_sampler_t *sampler, uint32_t pid,
+                                               uint64_t cpu_ns, uint64_t start_time, uint64_t now_ns)
+{
+    int fresh;
+    fossil_sys_process_sample_t *slot = fossil_sys_process_sampler_slot(sampler, pid, &fresh);
+    if (!slot)
+        return 0.0f;
+
+    if (!fresh && slot->start_time == start_time)
+    {
+        slot->seen = sampler->generation;
+        uint64_t window = now_ns - slot->stamp_ns;
+        if (now_ns < slot->stamp_ns || window < FOSSIL_SYS_PROCESS_SAMPLE_MIN_NS)
+            return slot->percent;
+        slot->percent = cpu_ns > slot->cpu_ns ? (float)((double)(cpu_ns - slot->cpu_ns) * 100.0 / (double)window)
+                                              : 0.0f;
+    }
+    else
+    {
+        slot->pid = pid;
+        slot->seen = sampler->generation;
+        slot->start_time = start_time;
+        slot->percent = 0.0f;
+    }
+    slot->cpu_ns = cpu_ns;
+    slot->stamp_ns = now_ns;
+    return slot->percent;
+}
+
+fossil_sys_process_sampler_t *fossil_sys_process_sampler_create(size_t expected)
+{
+    fossil_sys_process_sampler_t *sampler = (fossil_sys_process_sampler_t *)calloc(1, sizeof(*sampler));
+    if (!sampler)
+        return NULL;
+
+    size_t capacity = FOSSIL_SYS_PROCESS_SAMPLER_MIN_SLOTS;
+    while (capacity < expected * 2)
+        capacity <<= 1;
+    sampler->slots = (fossil_sys_process_sample_t *)calloc(capacity, sizeof(*sampler->slots));
+    if (!sampler->slots)
+    {
+        free(sampler);
+        return NULL;
+    }
+    sampler->mask = capacity - 1;
+    sampler->generation = 1;
+    return sampler;
+}
+
+void fossil_sys_process_sampler_destroy(fossil_sys_process_sampler_t *sampler)
+{
+    if (!sampler)
+        return;
+    free(sampler->slots);
+    free(sampler->spare);
+    free(sampler);
+}
+
+typedef struct
+{
+    fossil_sys_process_sampler_t *sampler;
+    fossil_sys_process_list_t *plist;
+} fossil_sys_process_refresh_t;
+
+static int fossil_sys_process_refresh_visit(void *context, fossil_sys_process_info_t *info, uint64_t cpu_ns,
+                                            uint64_t start_time)
+{
+    fossil_sys_process_refresh_t *refresh = (fossil_sys_process_refresh_t *)context;
+    info->cpu_percent = fossil_sys_process_sampler_update(refresh->sampler, info->pid, cpu_ns, start_time,
+                                                          fossil_sys_process_now_ns());
+    if (refresh->plist && refresh->plist->count < FOSSIL_SYS_PROCESS_MAX)
+        refresh->plist->list[refresh->plist->count++] = *info;
+    return 0; // keep sampling past a full list
+}
+
+int fossil_sys_process_sampler_refresh(fossil_sys_process_sampler_t *sampler, fossil_sys_process_list_t *plist)
+{
+    if (!sampler)
+        return -1;
+    if (plist)
+        plist->count = 0;
+
+    sampler->generation++;
+    fossil_sys_process_refresh_t refresh = {sampler, plist};
+    return fossil_sys_process_scan(fossil_sys_process_refresh_visit, &refresh);
+}
+
+int fossil_sys_process_sampler_get_info(fossil_sys_process_sampler_t *sampler, uint32_t pid,
+                                        fossil_sys_process_info_t *info)
+{
+    if (!sampler || !info)
+        return -1;
+
+    uint64_t cpu_ns = 0, start_time = 0;
+    int status = fossil_sys_process_sample(pid, info, &cpu_ns, &start_time);
+    if (status != 0)
+        return status;
+    info->cpu_percent =
+        fossil_sys_process_sampler_update(sampler, pid, cpu_ns, start_time, fossil_sys_process_now_ns());
+    return 0;
+}
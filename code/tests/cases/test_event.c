@@ -14,6 +14,12 @@
 #include <fossil/pizza/framework.h>
 
 #include "fossil/sys/framework.h"
+#include <stdatomic.h>
+
+#if defined(__linux__)
+#include <signal.h>
+#include <unistd.h>
+#endif
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Utilities
@@ -58,6 +64,7 @@ FOSSIL_TEST(c_test_event_poll)
     status = fossil_sys_event_poll(&event);
     ASSUME_ITS_EQUAL_I32(status, 1); // event retrieved
     ASSUME_ITS_EQUAL_CSTR(event.id, "test_event");
+    fossil_sys_event_release(&event);
 
     status = fossil_sys_event_poll(NULL);
     ASSUME_NOT_EQUAL_I32(status, 0); // null pointer error
@@ -80,6 +87,7 @@ FOSSIL_TEST(c_test_event_post)
     fossil_sys_event_t event;
     fossil_sys_event_poll(&event);
     ASSUME_ITS_EQUAL_CSTR(event.id, "event1");
+    fossil_sys_event_release(&event);
 
     fossil_sys_event_shutdown();
 }
@@ -93,6 +101,7 @@ FOSSIL_TEST(c_test_event_wait)
     fossil_sys_event_t event;
     int status = fossil_sys_event_wait(&event, 1000);
     ASSUME_ITS_EQUAL_I32(status, 1);
+    fossil_sys_event_release(&event);
 
     status = fossil_sys_event_wait(&event, 100);
     ASSUME_ITS_EQUAL_I32(status, 0); // timeout
@@ -115,6 +124,613 @@ FOSSIL_TEST(c_test_event_shutdown)
     ASSUME_ITS_EQUAL_I32(status, 0);
 }
 
+// ** Test queue capacity and FIFO order **
+FOSSIL_TEST(c_test_event_capacity)
+{
+    fossil_sys_event_init();
+
+    size_t posted = 0;
+    while (fossil_sys_event_post("fill", &posted, sizeof(posted)) == 0)
+    {
+        posted++;
+    }
+    ASSUME_ITS_TRUE(posted == FOSSIL_SYS_EVENT_CAPACITY); // full queue rejects posts
+
+    fossil_sys_event_t event;
+    for (size_t i = 0; i < posted; i++)
+    {
+        ASSUME_ITS_EQUAL_I32(fossil_sys_event_poll(&event), 1);
+        ASSUME_ITS_TRUE(*(size_t *)event.payload == i); // FIFO
+        fossil_sys_event_release(&event);
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_poll(&event), 0);
+
+    // The ring wraps around cleanly
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_post("again", NULL, 0), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_poll(&event), 1);
+    ASSUME_ITS_EQUAL_CSTR(event.id, "again");
+    fossil_sys_event_release(&event);
+
+    fossil_sys_event_shutdown();
+}
+
+// ** Test independent queues **
+FOSSIL_TEST(c_test_event_queue_handle)
+{
+    fossil_sys_event_init();
+
+    fossil_sys_event_queue_t *a = fossil_sys_event_queue_create(5, FOSSIL_SYS_EVENT_QUEUE_MPMC);
+    fossil_sys_event_queue_t *b = fossil_sys_event_queue_create(2, FOSSIL_SYS_EVENT_QUEUE_SPSC);
+    ASSUME_NOT_CNULL(a);
+    ASSUME_NOT_CNULL(b);
+    ASSUME_ITS_TRUE(fossil_sys_event_queue_capacity(a) == 8); // rounded to a power of two
+    ASSUME_ITS_TRUE(fossil_sys_event_queue_capacity(b) == 2);
+    ASSUME_ITS_TRUE(fossil_sys_event_queue_default() != a);
+
+    char payload[] = "shard";
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(a, "a1", payload, sizeof(payload)), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(b, "b1", NULL, 0), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(b, "b2", NULL, 0), 0);
+    ASSUME_ITS_TRUE(fossil_sys_event_queue_post(b, "b3", NULL, 0) < 0); // b is full, a is not
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(a, "a2", NULL, 0), 0);
+
+    fossil_sys_event_t event;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_poll(&event), 0); // default queue untouched
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(b, &event), 1);
+    ASSUME_ITS_EQUAL_CSTR(event.id, "b1");
+    fossil_sys_event_release(&event);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_wait(a, &event, 100), 1);
+    ASSUME_ITS_EQUAL_CSTR(event.id, "a1");
+    ASSUME_ITS_EQUAL_CSTR((const char *)event.payload, "shard");
+    fossil_sys_event_release(&event);
+
+    ASSUME_ITS_TRUE(fossil_sys_event_queue_post(NULL, "x", NULL, 0) < 0);
+    ASSUME_ITS_TRUE(fossil_sys_event_queue_poll(NULL, &event) < 0);
+
+    fossil_sys_event_queue_destroy(a); // frees the pending a2
+    fossil_sys_event_queue_destroy(b);
+    fossil_sys_event_shutdown();
+}
+
+// ** Test inline, slab and moved payloads **
+FOSSIL_TEST(c_test_event_payload_storage)
+{
+    fossil_sys_event_queue_t *queue = fossil_sys_event_queue_create(16, FOSSIL_SYS_EVENT_QUEUE_MPMC);
+    ASSUME_NOT_CNULL(queue);
+
+    char small[] = "inline";
+    fossil_sys_event_intern("small"); // a cell only has room for a payload next to an interned id
+    char large[200];
+    memset(large, 'x', sizeof(large));
+    char *owned = (char *)malloc(1024);
+    ASSUME_NOT_CNULL(owned);
+    strcpy(owned, "moved");
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_ex(queue, "small", small, sizeof(small), FOSSIL_SYS_EVENT_POST_INLINE), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_ex(queue, "large", large, sizeof(large), FOSSIL_SYS_EVENT_POST_INLINE), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_ex(queue, "owned", owned, 1024, FOSSIL_SYS_EVENT_POST_MOVE), 0);
+
+    fossil_sys_event_t event;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 1);
+    ASSUME_ITS_TRUE(event.storage == FOSSIL_SYS_EVENT_STORAGE_INLINE);
+    ASSUME_ITS_EQUAL_CSTR((const char *)event.payload, "inline");
+    fossil_sys_event_release(&event);
+    ASSUME_ITS_TRUE(event.payload == NULL);
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 1);
+    ASSUME_ITS_TRUE(event.storage == FOSSIL_SYS_EVENT_STORAGE_SLAB); // too big to inline
+    ASSUME_ITS_TRUE(event.size == sizeof(large) && memcmp(event.payload, large, sizeof(large)) == 0);
+    fossil_sys_event_release(&event);
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 1);
+    ASSUME_ITS_TRUE(event.storage == FOSSIL_SYS_EVENT_STORAGE_HEAP);
+    ASSUME_ITS_TRUE(event.payload == owned); // no copy
+    fossil_sys_event_release(&event);
+
+    // Slab payloads still queued are released with the queue
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_ex(queue, "pending", large, 64, FOSSIL_SYS_EVENT_POST_SLAB), 0);
+    fossil_sys_event_queue_destroy(queue);
+}
+
+FOSSIL_TEST(c_test_event_batch)
+{
+    fossil_sys_event_queue_t *queue = fossil_sys_event_queue_create(128, FOSSIL_SYS_EVENT_QUEUE_MPMC);
+    ASSUME_NOT_CNULL(queue);
+
+    int values[100];
+    fossil_sys_event_t batch[100];
+    memset(batch, 0, sizeof(batch));
+    for (int i = 0; i < 100; i++)
+    {
+        values[i] = i;
+        batch[i].id = "burst";
+        batch[i].type = FOSSIL_EVENT_CUSTOM;
+        batch[i].payload = &values[i];
+        batch[i].size = sizeof(int);
+    }
+
+    // Spans more than one internal chunk, then only part of the second batch fits
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_batch(queue, batch, 100, FOSSIL_SYS_EVENT_POST_INLINE), 100);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_batch(queue, batch, 100, FOSSIL_SYS_EVENT_POST_COPY), 28);
+
+    fossil_sys_event_t out[64];
+    int seen = 0;
+    int got;
+    while ((got = fossil_sys_event_queue_poll_batch(queue, out, 64)) > 0)
+    {
+        for (int i = 0; i < got; i++, seen++)
+        {
+            ASSUME_ITS_EQUAL_I32(*(int *)out[i].payload, seen % 100); // order is preserved
+            fossil_sys_event_release(&out[i]);
+        }
+    }
+    ASSUME_ITS_EQUAL_I32(got, 0);
+    ASSUME_ITS_EQUAL_I32(seen, 128);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll_batch(NULL, out, 64), -1);
+
+    // Default queue wrappers
+    fossil_sys_event_init();
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_post_batch(batch, 3), 3);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_poll_batch(out, 64), 3);
+    for (int i = 0; i < 3; i++)
+        fossil_sys_event_release(&out[i]);
+    fossil_sys_event_shutdown();
+
+    fossil_sys_event_queue_destroy(queue);
+}
+
+FOSSIL_TEST(c_test_event_sources)
+{
+#if defined(__linux__)
+    fossil_sys_event_queue_t *queue = fossil_sys_event_queue_create(64, FOSSIL_SYS_EVENT_QUEUE_MPMC);
+    ASSUME_NOT_CNULL(queue);
+    fossil_sys_event_t event;
+    fossil_sys_event_source_info_t info;
+
+    // Timer
+    int timer = fossil_sys_event_queue_add_timer(queue, 20, 0, "tick");
+    ASSUME_ITS_TRUE(timer > 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_wait(queue, &event, 2000), 1);
+    ASSUME_ITS_TRUE(event.type == FOSSIL_EVENT_TIMER);
+    ASSUME_ITS_EQUAL_CSTR(event.id, "tick");
+    memcpy(&info, event.payload, sizeof(info));
+    ASSUME_ITS_EQUAL_I32(info.source, timer);
+    ASSUME_ITS_TRUE(info.expirations == 1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_remove_source(queue, timer), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_remove_source(queue, timer), -1);
+
+    // Descriptor
+    int fds[2];
+    ASSUME_ITS_EQUAL_I32(pipe(fds), 0);
+    int watch = fossil_sys_event_queue_watch_fd(queue, fds[0], FOSSIL_SYS_EVENT_IO_READ, "pipe");
+    ASSUME_ITS_TRUE(watch > 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 0);
+    ASSUME_ITS_EQUAL_I32((int)write(fds[1], "x", 1), 1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_wait(queue, &event, 2000), 1);
+    ASSUME_ITS_TRUE(event.type == FOSSIL_EVENT_IO);
+    memcpy(&info, event.payload, sizeof(info));
+    ASSUME_ITS_EQUAL_I32(info.fd, fds[0]);
+    ASSUME_ITS_TRUE((info.events & FOSSIL_SYS_EVENT_IO_READ) != 0);
+
+    // Posted events and sources share one wait
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "custom", NULL, 0), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_wait(queue, &event, 2000), 1);
+    ASSUME_ITS_TRUE(event.type == FOSSIL_EVENT_CUSTOM);
+    fossil_sys_event_release(&event);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_remove_source(queue, watch), 0);
+    close(fds[0]);
+    close(fds[1]);
+
+    // Signal
+    int sig = fossil_sys_event_queue_add_signal(queue, SIGUSR1, "usr1");
+    ASSUME_ITS_TRUE(sig > 0);
+    ASSUME_ITS_EQUAL_I32(raise(SIGUSR1), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_wait(queue, &event, 2000), 1);
+    ASSUME_ITS_TRUE(event.type == FOSSIL_EVENT_SIGNAL);
+    memcpy(&info, event.payload, sizeof(info));
+    ASSUME_ITS_EQUAL_I32(info.signo, SIGUSR1);
+
+    fossil_sys_event_queue_destroy(queue); // closes the signal source
+#else
+    ASSUME_ITS_TRUE(fossil_sys_event_add_timer(10, 0, "tick") < 0);
+#endif
+}
+
+FOSSIL_TEST(c_test_event_timeouts)
+{
+#if defined(__linux__)
+    fossil_sys_event_queue_t *queue = fossil_sys_event_queue_create(64, FOSSIL_SYS_EVENT_QUEUE_MPMC);
+    ASSUME_NOT_CNULL(queue);
+    int first = 1, second = 2, third = 3;
+
+    fossil_sys_event_timeout_t a = fossil_sys_event_queue_arm_timeout(queue, 40, "a", &first);
+    fossil_sys_event_timeout_t b = fossil_sys_event_queue_arm_timeout(queue, 10, "b", &second);
+    fossil_sys_event_timeout_t c = fossil_sys_event_queue_arm_timeout(queue, 20, "c", &third);
+    ASSUME_ITS_TRUE(a != 0 && b != 0 && c != 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_cancel_timeout(queue, b), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_reschedule_timeout(queue, c, 300), 0); // spills past level 0
+
+    fossil_sys_event_t event;
+    fossil_sys_event_source_info_t info;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_wait(queue, &event, 2000), 1);
+    ASSUME_ITS_TRUE(event.type == FOSSIL_EVENT_TIMER);
+    memcpy(&info, event.payload, sizeof(info));
+    ASSUME_ITS_TRUE(info.timeout == a && info.context == &first);
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_wait(queue, &event, 2000), 1);
+    memcpy(&info, event.payload, sizeof(info));
+    ASSUME_ITS_TRUE(info.timeout == c && info.context == &third);
+
+    // Fired and cancelled handles are rejected, and nothing else fires
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_cancel_timeout(queue, a), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_reschedule_timeout(queue, b, 10), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_wait(queue, &event, 50), 0);
+    fossil_sys_event_queue_destroy(queue);
+#else
+    ASSUME_ITS_TRUE(fossil_sys_event_arm_timeout(10, "t", NULL) == 0);
+#endif
+}
+
+FOSSIL_TEST(c_test_event_priority)
+{
+    fossil_sys_event_queue_t *queue = fossil_sys_event_queue_create(32, FOSSIL_SYS_EVENT_QUEUE_MPMC);
+    ASSUME_NOT_CNULL(queue);
+    fossil_sys_event_t event;
+
+    // A full data lane does not hold back control events
+    while (fossil_sys_event_queue_post(queue, "data", NULL, 0) == 0)
+        ;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_priority(queue, "shutdown", NULL, 0, FOSSIL_SYS_EVENT_POST_COPY,
+                                                              FOSSIL_SYS_EVENT_PRIORITY_CRITICAL), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 1);
+    ASSUME_ITS_EQUAL_CSTR(event.id, "shutdown");
+    fossil_sys_event_release(&event);
+    while (fossil_sys_event_queue_poll(queue, &event) == 1)
+    {
+        ASSUME_ITS_EQUAL_CSTR(event.id, "data");
+        fossil_sys_event_release(&event);
+    }
+
+    // Weighted draining: 3 critical turns for every low one
+    for (int i = 0; i < 16; i++)
+    {
+        fossil_sys_event_queue_post_priority(queue, "low", NULL, 0, FOSSIL_SYS_EVENT_POST_COPY, FOSSIL_SYS_EVENT_PRIORITY_LOW);
+        fossil_sys_event_queue_post_priority(queue, "crit", NULL, 0, FOSSIL_SYS_EVENT_POST_COPY,
+                                             FOSSIL_SYS_EVENT_PRIORITY_CRITICAL);
+    }
+    const uint32_t weights[FOSSIL_SYS_EVENT_PRIORITY_LEVELS] = {3, 0, 0, 1};
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_set_drain(queue, FOSSIL_SYS_EVENT_DRAIN_WEIGHTED, weights), 0);
+    int low = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 1);
+        low += event.id[0] == 'l';
+        fossil_sys_event_release(&event);
+    }
+    ASSUME_ITS_EQUAL_I32(low, 2);
+
+    const uint32_t too_heavy[FOSSIL_SYS_EVENT_PRIORITY_LEVELS] = {64, 1, 0, 0};
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_set_drain(queue, FOSSIL_SYS_EVENT_DRAIN_WEIGHTED, too_heavy), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_priority(queue, "bad", NULL, 0, FOSSIL_SYS_EVENT_POST_COPY,
+                                                              (fossil_sys_event_priority_t)FOSSIL_SYS_EVENT_PRIORITY_LEVELS), -1);
+    fossil_sys_event_queue_destroy(queue);
+}
+
+static void c_event_count_handler(const fossil_sys_event_t *event, void *context)
+{
+    (void)event;
+    (*(int *)context)++;
+}
+
+FOSSIL_TEST(c_test_event_subscribe)
+{
+    fossil_sys_event_queue_t *queue = fossil_sys_event_queue_create(32, FOSSIL_SYS_EVENT_QUEUE_MPMC);
+    ASSUME_NOT_CNULL(queue);
+    fossil_sys_event_t event;
+
+    // Interning is stable; posting does not intern, and the event carries its
+    // own copy of such an id until it is released
+    uint32_t key = fossil_sys_event_intern("tick");
+    ASSUME_ITS_TRUE(key != 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_intern("tick"), key);
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_event_name(key), "tick");
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_intern(NULL), 0);
+    char id[8] = "tock";
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, id, NULL, 0), 0);
+    id[0] = 'x';
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 1);
+    ASSUME_ITS_EQUAL_CSTR(event.id, "tock");
+    ASSUME_ITS_EQUAL_I32(event.key, 0);
+    fossil_sys_event_release(&event);
+    ASSUME_ITS_TRUE(event.id == NULL);
+
+    // Fan-out to every subscriber of the key, nothing for others
+    int first = 0, second = 0;
+    int a = fossil_sys_event_queue_subscribe(queue, "tick", c_event_count_handler, &first);
+    int b = fossil_sys_event_queue_subscribe(queue, "tick", c_event_count_handler, &second);
+    ASSUME_ITS_TRUE(a > 0 && b > 0 && a != b);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_key(queue, key, NULL, 0, FOSSIL_SYS_EVENT_POST_COPY,
+                                                         FOSSIL_SYS_EVENT_PRIORITY_NORMAL), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "other", NULL, 0), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_dispatch_pending(queue, 16), 2);
+    ASSUME_ITS_EQUAL_I32(first, 1);
+    ASSUME_ITS_EQUAL_I32(second, 1);
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_unsubscribe(queue, a), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_unsubscribe(queue, a), -1);
+    fossil_sys_event_queue_post(queue, "tick", NULL, 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_dispatch_pending(queue, 16), 1);
+    ASSUME_ITS_EQUAL_I32(first, 1);
+    ASSUME_ITS_EQUAL_I32(second, 2);
+
+    // An event posted before its id was subscribed to still reaches the subscriber
+    int late = 0;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "late", NULL, 0), 0);
+    ASSUME_ITS_TRUE(fossil_sys_event_queue_subscribe(queue, "late", c_event_count_handler, &late) > 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_dispatch_pending(queue, 16), 1);
+    ASSUME_ITS_EQUAL_I32(late, 1);
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_key(queue, 0xFFFFFFF0u, NULL, 0, FOSSIL_SYS_EVENT_POST_COPY,
+                                                         FOSSIL_SYS_EVENT_PRIORITY_NORMAL), -1);
+    fossil_sys_event_queue_destroy(queue);
+}
+
+typedef struct {
+    _Atomic int handled;
+    _Atomic int out_of_order;
+    _Atomic int last[4];
+    int total;
+    fossil_sys_event_queue_t *done;
+} c_event_dispatch_state_t;
+
+static void c_event_dispatch_handler(const fossil_sys_event_t *event, void *context)
+{
+    c_event_dispatch_state_t *state = context;
+    int seq = *(const int *)event->payload;
+    int prev = atomic_exchange(&state->last[event->id[1] - '0'], seq);
+    if (prev >= seq)
+        atomic_fetch_add(&state->out_of_order, 1);
+    if (atomic_fetch_add(&state->handled, 1) + 1 == state->total)
+        fossil_sys_event_queue_post(state->done, "done", NULL, 0);
+}
+
+FOSSIL_TEST(c_test_event_dispatcher)
+{
+    fossil_sys_event_queue_t *queue = fossil_sys_event_queue_create(256, FOSSIL_SYS_EVENT_QUEUE_MPMC);
+    ASSUME_NOT_CNULL(queue);
+    c_event_dispatch_state_t state = {0};
+    state.total = 2000;
+    state.done = fossil_sys_event_queue_create(4, FOSSIL_SYS_EVENT_QUEUE_MPMC);
+    ASSUME_NOT_CNULL(state.done);
+    const char *ids[4] = {"d0", "d1", "d2", "d3"};
+    for (int i = 0; i < 4; i++)
+    {
+        atomic_init(&state.last[i], -1);
+        ASSUME_ITS_TRUE(fossil_sys_event_queue_subscribe(queue, ids[i], c_event_dispatch_handler, &state) > 0);
+    }
+
+    // Ordered mode: every event runs once and each id sees its events in order
+    fossil_sys_event_dispatcher_t *dispatcher =
+        fossil_sys_event_dispatcher_create(queue, 4, FOSSIL_SYS_EVENT_DISPATCH_ORDERED);
+    ASSUME_NOT_CNULL(dispatcher);
+    ASSUME_ITS_TRUE(fossil_sys_event_dispatcher_workers(dispatcher) == 4);
+    for (int seq = 0; seq < state.total; seq++)
+    {
+        while (fossil_sys_event_queue_post(queue, ids[seq % 4], &seq, sizeof(seq)) != 0)
+            ;
+    }
+    fossil_sys_event_t event;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_wait(state.done, &event, 5000), 1);
+    fossil_sys_event_release(&event);
+    fossil_sys_event_dispatcher_destroy(dispatcher);
+    ASSUME_ITS_EQUAL_I32(atomic_load(&state.handled), state.total);
+    ASSUME_ITS_EQUAL_I32(atomic_load(&state.out_of_order), 0);
+
+    // Parallel mode with one worker per CPU
+    dispatcher = fossil_sys_event_dispatcher_create(queue, 0, FOSSIL_SYS_EVENT_DISPATCH_PARALLEL);
+    ASSUME_NOT_CNULL(dispatcher);
+    ASSUME_ITS_TRUE(fossil_sys_event_dispatcher_workers(dispatcher) >= 1);
+    atomic_store(&state.handled, 0);
+    state.total = 1;
+    int seq = state.total << 16; // past every sequence d0 has seen
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "d0", &seq, sizeof(seq)), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_wait(state.done, &event, 5000), 1);
+    fossil_sys_event_release(&event);
+    fossil_sys_event_dispatcher_destroy(dispatcher);
+    ASSUME_ITS_EQUAL_I32(atomic_load(&state.handled), 1);
+
+    ASSUME_ITS_TRUE(fossil_sys_event_dispatcher_create(NULL, 1, FOSSIL_SYS_EVENT_DISPATCH_PARALLEL) == NULL);
+    ASSUME_ITS_TRUE(fossil_sys_event_dispatcher_workers(NULL) == 0);
+    fossil_sys_event_dispatcher_destroy(NULL);
+    fossil_sys_event_queue_destroy(state.done);
+    fossil_sys_event_queue_destroy(queue);
+}
+
+FOSSIL_TEST(c_test_event_stats)
+{
+    fossil_sys_event_queue_t *queue = fossil_sys_event_queue_create(4, FOSSIL_SYS_EVENT_QUEUE_MPMC);
+    ASSUME_NOT_CNULL(queue);
+    fossil_sys_event_stats_t stats;
+    fossil_sys_event_t event;
+
+    // Fill the lane, overflow it once and drain half of it
+    for (int i = 0; i < 5; i++)
+        fossil_sys_event_queue_post(queue, "stat", &i, sizeof(i));
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 1);
+    fossil_sys_event_release(&event);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 1);
+    fossil_sys_event_release(&event);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_get_stats(queue, &stats), 0);
+    ASSUME_ITS_EQUAL_I32(stats.posted, 4);
+    ASSUME_ITS_EQUAL_I32(stats.dropped, 1);
+    ASSUME_ITS_EQUAL_I32(stats.delivered, 2);
+    ASSUME_ITS_EQUAL_I32(stats.depth, 2);
+    ASSUME_ITS_EQUAL_I32(stats.high_water, 4);
+
+    // A short ring times one event per lap
+    for (int i = 0; i < 64; i++)
+    {
+        fossil_sys_event_queue_post(queue, "stat", NULL, 0);
+        while (fossil_sys_event_queue_poll(queue, &event) == 1)
+            fossil_sys_event_release(&event);
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_get_stats(queue, &stats), 0);
+    ASSUME_ITS_EQUAL_I32(stats.depth, 0);
+    ASSUME_ITS_EQUAL_I32(stats.delivered, stats.posted);
+    ASSUME_ITS_TRUE(stats.latency_samples >= 16);
+    ASSUME_ITS_TRUE(stats.latency_min_ns <= stats.latency_p50_ns);
+    ASSUME_ITS_TRUE(stats.latency_p50_ns <= stats.latency_p90_ns);
+    ASSUME_ITS_TRUE(stats.latency_p99_ns <= stats.latency_p999_ns);
+    ASSUME_ITS_TRUE(stats.latency_p999_ns <= stats.latency_max_ns);
+    ASSUME_ITS_TRUE(stats.latency_mean_ns <= stats.latency_max_ns);
+
+    fossil_sys_event_queue_reset_stats(queue);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_get_stats(queue, &stats), 0);
+    ASSUME_ITS_EQUAL_I32(stats.posted, 0);
+    ASSUME_ITS_EQUAL_I32(stats.high_water, 0);
+    ASSUME_ITS_EQUAL_I32(stats.latency_samples, 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_get_stats(NULL, &stats), -1);
+    fossil_sys_event_queue_destroy(queue);
+}
+
+FOSSIL_TEST(c_test_event_backpressure)
+{
+    fossil_sys_event_stats_t stats;
+    fossil_sys_event_t event;
+
+    // Drop-oldest keeps the newest capacity events
+    fossil_sys_event_queue_t *queue =
+        fossil_sys_event_queue_create_ex(4, FOSSIL_SYS_EVENT_QUEUE_MPSC, FOSSIL_SYS_EVENT_FULL_DROP_OLDEST, 0);
+    ASSUME_NOT_CNULL(queue);
+    for (int i = 0; i < 10; i++)
+        ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "bp", &i, sizeof(i)), 0);
+    for (int i = 6; i < 10; i++)
+    {
+        ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 1);
+        ASSUME_ITS_EQUAL_I32(*(int *)event.payload, i);
+        fossil_sys_event_release(&event);
+    }
+    fossil_sys_event_queue_get_stats(queue, &stats);
+    ASSUME_ITS_EQUAL_I32(stats.dropped, 6);
+    fossil_sys_event_queue_destroy(queue);
+
+    // Spill accepts everything and hands it back in order
+    queue = fossil_sys_event_queue_create_ex(4, FOSSIL_SYS_EVENT_QUEUE_SPSC, FOSSIL_SYS_EVENT_FULL_SPILL, 0);
+    ASSUME_NOT_CNULL(queue);
+    for (int i = 0; i < 10; i++)
+        ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "bp", &i, sizeof(i)), 0);
+    fossil_sys_event_queue_get_stats(queue, &stats);
+    ASSUME_ITS_EQUAL_I32(stats.spilled, 6);
+    ASSUME_ITS_EQUAL_I32(stats.depth, 10);
+    for (int i = 0; i < 10; i++)
+    {
+        ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 1);
+        ASSUME_ITS_EQUAL_I32(*(int *)event.payload, i);
+        fossil_sys_event_release(&event);
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 0);
+    for (int i = 0; i < 8; i++)
+        fossil_sys_event_queue_post(queue, "bp", &i, sizeof(i)); // left for destroy to free
+    fossil_sys_event_queue_destroy(queue);
+
+    // Block gives up after its timeout...
+    queue = fossil_sys_event_queue_create_ex(2, FOSSIL_SYS_EVENT_QUEUE_MPMC, FOSSIL_SYS_EVENT_FULL_BLOCK, 20);
+    ASSUME_NOT_CNULL(queue);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "bp", NULL, 0), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "bp", NULL, 0), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "bp", NULL, 0), -1);
+    fossil_sys_event_queue_get_stats(queue, &stats);
+    ASSUME_ITS_EQUAL_I32(stats.blocked, 1);
+    ASSUME_ITS_EQUAL_I32(stats.dropped, 1);
+    fossil_sys_event_queue_destroy(queue);
+
+    // ...and otherwise waits for consumers to make room
+    queue = fossil_sys_event_queue_create_ex(4, FOSSIL_SYS_EVENT_QUEUE_MPMC, FOSSIL_SYS_EVENT_FULL_BLOCK, 0);
+    ASSUME_NOT_CNULL(queue);
+    int handled = 0;
+    ASSUME_ITS_TRUE(fossil_sys_event_queue_subscribe(queue, "bp", c_event_count_handler, &handled) > 0);
+    fossil_sys_event_dispatcher_t *dispatcher =
+        fossil_sys_event_dispatcher_create(queue, 1, FOSSIL_SYS_EVENT_DISPATCH_PARALLEL);
+    ASSUME_NOT_CNULL(dispatcher);
+    for (int i = 0; i < 500; i++)
+        ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "bp", NULL, 0), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "bp.last", NULL, 0), 0);
+    while (fossil_sys_event_queue_get_stats(queue, &stats) == 0 && stats.delivered < 501)
+        ;
+    fossil_sys_event_dispatcher_destroy(dispatcher);
+    ASSUME_ITS_EQUAL_I32(handled, 500);
+    fossil_sys_event_queue_destroy(queue);
+
+    ASSUME_ITS_CNULL(fossil_sys_event_queue_create_ex(4, FOSSIL_SYS_EVENT_QUEUE_MPMC,
+                                                      (fossil_sys_event_backpressure_t)7, 0));
+}
+
+static void c_event_await_handler(fossil_sys_event_t *event, void *context)
+{
+    *(int *)context = *(int *)event->payload;
+    fossil_sys_event_release(event);
+}
+
+static void c_event_call_handler(void *context)
+{
+    (*(int *)context)++;
+}
+
+FOSSIL_TEST(c_test_event_await)
+{
+    fossil_sys_event_queue_t *queue = fossil_sys_event_queue_create(16, FOSSIL_SYS_EVENT_QUEUE_MPMC);
+    ASSUME_NOT_CNULL(queue);
+    int handled = 0, first = 0, second = 0, calls = 0;
+    ASSUME_ITS_TRUE(fossil_sys_event_queue_subscribe(queue, "aw", c_event_count_handler, &handled) > 0);
+
+    // Waiting callbacks take events ahead of the subscribers, oldest first
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_await(queue, c_event_await_handler, &first), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_await(queue, c_event_await_handler, &second), 0);
+    for (int i = 1; i <= 3; i++)
+        ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "aw", &i, sizeof(i)), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_call(queue, c_event_call_handler, &calls), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_dispatch_pending(queue, 16), 4);
+    ASSUME_ITS_EQUAL_I32(first, 1);
+    ASSUME_ITS_EQUAL_I32(second, 2);
+    ASSUME_ITS_EQUAL_I32(handled, 1);
+    ASSUME_ITS_EQUAL_I32(calls, 1);
+
+    // Calls cannot be forged through a batch
+    fossil_sys_event_t forged = {0};
+    forged.id = "aw";
+    forged.type = FOSSIL_EVENT_CALL;
+    ASSUME_ITS_TRUE(fossil_sys_event_queue_post_batch(queue, &forged, 1, FOSSIL_SYS_EVENT_POST_COPY) != 1);
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_await(queue, NULL, NULL), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_call(NULL, c_event_call_handler, &calls), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_await(queue, c_event_await_handler, &first), 0); // dropped by destroy
+    fossil_sys_event_queue_destroy(queue);
+    // Drop-oldest never evicts a call: it runs instead of being dropped
+    fossil_sys_event_stats_t stats;
+    fossil_sys_event_t event;
+    queue = fossil_sys_event_queue_create_ex(4, FOSSIL_SYS_EVENT_QUEUE_MPMC, FOSSIL_SYS_EVENT_FULL_DROP_OLDEST, 0);
+    ASSUME_NOT_CNULL(queue);
+    calls = 0;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_call(queue, c_event_call_handler, &calls), 0);
+    for (int i = 0; i < 4; i++)
+        ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post(queue, "aw", &i, sizeof(i)), 0);
+    ASSUME_ITS_EQUAL_I32(calls, 1);
+    fossil_sys_event_queue_get_stats(queue, &stats);
+    ASSUME_ITS_EQUAL_I32(stats.dropped, 0);
+    while (fossil_sys_event_queue_poll(queue, &event) == 1)
+        fossil_sys_event_release(&event);
+
+    // A polled call runs through dispatch, and destroy runs the calls it drains
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_call(queue, c_event_call_handler, &calls), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_poll(queue, &event), 1);
+    ASSUME_ITS_TRUE(event.type == FOSSIL_EVENT_CALL);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_dispatch(queue, &event), 1);
+    ASSUME_ITS_EQUAL_I32(calls, 2);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_queue_post_call(queue, c_event_call_handler, &calls), 0);
+    fossil_sys_event_queue_destroy(queue);
+    ASSUME_ITS_EQUAL_I32(calls, 3);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -124,6 +740,18 @@ FOSSIL_TEST_GROUP(c_event_tests)
     FOSSIL_TEST_ADD(c_event_suite, c_test_event_post);
     FOSSIL_TEST_ADD(c_event_suite, c_test_event_wait);
     FOSSIL_TEST_ADD(c_event_suite, c_test_event_shutdown);
+    FOSSIL_TEST_ADD(c_event_suite, c_test_event_capacity);
+    FOSSIL_TEST_ADD(c_event_suite, c_test_event_queue_handle);
+    FOSSIL_TEST_ADD(c_event_suite, c_test_event_payload_storage);
+    FOSSIL_TEST_ADD(c_event_suite, c_test_event_batch);
+    FOSSIL_TEST_ADD(c_event_suite, c_test_event_sources);
+    FOSSIL_TEST_ADD(c_event_suite, c_test_event_timeouts);
+    FOSSIL_TEST_ADD(c_event_suite, c_test_event_priority);
+    FOSSIL_TEST_ADD(c_event_suite, c_test_event_subscribe);
+    FOSSIL_TEST_ADD(c_event_suite, c_test_event_dispatcher);
+    FOSSIL_TEST_ADD(c_event_suite, c_test_event_stats);
+    FOSSIL_TEST_ADD(c_event_suite, c_test_event_backpressure);
+    FOSSIL_TEST_ADD(c_event_suite, c_test_event_await);
 
     FOSSIL_TEST_REGISTER(c_event_suite);
 }
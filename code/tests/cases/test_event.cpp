@@ -14,6 +14,11 @@
 #include <fossil/pizza/framework.h>
 
 #include "fossil/sys/framework.h"
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <thread>
+#include <vector>
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Utilities
@@ -58,6 +63,7 @@ FOSSIL_TEST(cpp_test_event_poll)
     status = fossil::sys::Event::poll(&event);
     ASSUME_ITS_EQUAL_I32(status, 1); // event retrieved
     ASSUME_ITS_EQUAL_CSTR(event.id, "test_event");
+    fossil::sys::Event::release(&event);
 
     status = fossil::sys::Event::poll(NULL);
     ASSUME_NOT_EQUAL_I32(status, 0); // null pointer error
@@ -80,6 +86,7 @@ FOSSIL_TEST(cpp_test_event_post)
     fossil_sys_event_t event;
     fossil::sys::Event::poll(&event);
     ASSUME_ITS_EQUAL_CSTR(event.id, "event1");
+    fossil::sys::Event::release(&event);
 
     fossil::sys::Event::shutdown();
 }
@@ -93,6 +100,7 @@ FOSSIL_TEST(cpp_test_event_wait)
     fossil_sys_event_t event;
     int status = fossil::sys::Event::wait(&event, 1000);
     ASSUME_ITS_EQUAL_I32(status, 1);
+    fossil::sys::Event::release(&event);
 
     status = fossil::sys::Event::wait(&event, 100);
     ASSUME_ITS_EQUAL_I32(status, 0); // timeout
@@ -115,6 +123,420 @@ FOSSIL_TEST(cpp_test_event_shutdown)
     ASSUME_ITS_EQUAL_I32(status, 0);
 }
 
+// ** Test concurrent producers and consumers **
+FOSSIL_TEST(cpp_test_event_mpmc)
+{
+    fossil::sys::Event::init();
+
+    const int producers = 4, consumers = 4, per_producer = 20000;
+    std::atomic<long long> consumed_sum{0};
+    std::atomic<int> consumed{0};
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([p, per_producer] {
+            for (int i = 0; i < per_producer; ++i)
+            {
+                int value = p * per_producer + i;
+                while (fossil::sys::Event::post("mpmc", &value, sizeof(value)) != 0)
+                {
+                    std::this_thread::yield(); // queue full
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&] {
+            fossil_sys_event_t event;
+            while (consumed.load() < producers * per_producer)
+            {
+                if (fossil::sys::Event::poll(&event) == 1)
+                {
+                    consumed_sum += *static_cast<int *>(event.payload);
+                    consumed++;
+                    fossil::sys::Event::release(&event);
+                }
+            }
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    long long total = producers * per_producer;
+    ASSUME_ITS_TRUE(consumed.load() == total);
+    ASSUME_ITS_TRUE(consumed_sum.load() == total * (total - 1) / 2); // every event exactly once
+
+    fossil::sys::Event::shutdown();
+}
+
+// ** Test blocking wait woken by another thread **
+FOSSIL_TEST(cpp_test_event_wait_blocking)
+{
+    fossil::sys::Event::init();
+
+    auto start = std::chrono::steady_clock::now();
+    fossil_sys_event_t event;
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Event::wait(&event, 50), 0);
+    ASSUME_ITS_TRUE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(50)); // wall-clock timeout
+
+    std::thread producer([] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        fossil::sys::Event::post("wake", NULL, 0);
+    });
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Event::wait(&event, 0), 1); // 0 waits forever
+    ASSUME_ITS_EQUAL_CSTR(event.id, "wake");
+    fossil::sys::Event::release(&event);
+    producer.join();
+
+    fossil::sys::Event::shutdown();
+}
+
+// ** Test fossil::sys::EventQueue class **
+FOSSIL_TEST(cpp_test_event_queue_class)
+{
+    fossil::sys::EventQueue queue(64, FOSSIL_SYS_EVENT_QUEUE_SPSC);
+    ASSUME_NOT_CNULL(queue.handle());
+    ASSUME_ITS_TRUE(queue.capacity() == 64);
+
+    std::thread producer([&queue] {
+        for (int i = 0; i < 1000; ++i)
+        {
+            while (queue.post("spsc", &i, sizeof(i)) != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    fossil_sys_event_t event;
+    bool in_order = true;
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSUME_ITS_EQUAL_I32(queue.wait(&event, 0), 1);
+        in_order = in_order && *static_cast<int *>(event.payload) == i;
+        fossil::sys::Event::release(&event);
+    }
+    producer.join();
+    ASSUME_ITS_TRUE(in_order);
+
+    fossil::sys::EventQueue moved(std::move(queue));
+    ASSUME_ITS_TRUE(queue.handle() == nullptr);
+    ASSUME_ITS_EQUAL_I32(moved.poll(&event), 0);
+}
+
+// ** Test fossil::sys::Event inline posting **
+FOSSIL_TEST(cpp_test_event_post_inline)
+{
+    fossil::sys::Event::init();
+
+    int value = 42;
+    fossil::sys::Event::intern("inline"); // a cell only has room for a payload next to an interned id
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Event::post("inline", &value, sizeof(value), FOSSIL_SYS_EVENT_POST_INLINE), 0);
+
+    fossil_sys_event_t event;
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Event::poll(&event), 1);
+    ASSUME_ITS_TRUE(event.storage == FOSSIL_SYS_EVENT_STORAGE_INLINE);
+    ASSUME_ITS_TRUE(*static_cast<int *>(event.payload) == 42);
+    fossil::sys::Event::release(&event);
+
+    fossil::sys::Event::shutdown();
+}
+
+FOSSIL_TEST(cpp_test_event_batch)
+{
+    fossil::sys::EventQueue queue(64, FOSSIL_SYS_EVENT_QUEUE_SPSC);
+
+    std::vector<int> values(32);
+    std::vector<fossil_sys_event_t> batch(32);
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        values[i] = (int)i;
+        batch[i] = fossil_sys_event_t();
+        batch[i].id = "burst";
+        batch[i].payload = &values[i];
+        batch[i].size = sizeof(int);
+    }
+    ASSUME_ITS_EQUAL_I32(queue.post_batch(batch.data(), batch.size(), FOSSIL_SYS_EVENT_POST_INLINE), 32);
+
+    fossil_sys_event_t out[16];
+    int seen = 0;
+    int got;
+    while ((got = queue.poll_batch(out, 16)) > 0)
+    {
+        ASSUME_ITS_EQUAL_I32(got, 16);
+        for (int i = 0; i < got; i++, seen++)
+        {
+            ASSUME_ITS_EQUAL_I32(*static_cast<int *>(out[i].payload), seen);
+            fossil::sys::Event::release(&out[i]);
+        }
+    }
+    ASSUME_ITS_EQUAL_I32(seen, 32);
+}
+
+FOSSIL_TEST(cpp_test_event_sources)
+{
+#if defined(__linux__)
+    fossil::sys::EventQueue queue(64);
+    int timer = queue.add_timer(10, 10, "tick");
+    ASSUME_ITS_TRUE(timer > 0);
+
+    // A consumer sleeping on the sources is still woken by a post from another thread
+    std::atomic<int> custom(0), ticks(0);
+    std::thread consumer([&]() {
+        fossil_sys_event_t event;
+        while (custom.load() == 0 && queue.wait(&event, 2000) == 1) {
+            if (event.type == FOSSIL_EVENT_CUSTOM)
+                custom.store(1);
+            else if (event.type == FOSSIL_EVENT_TIMER)
+                ticks.fetch_add(1);
+            fossil::sys::Event::release(&event);
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSUME_ITS_EQUAL_I32(queue.remove_source(timer), 0);
+    ASSUME_ITS_EQUAL_I32(queue.post("stop", nullptr, 0), 0);
+    consumer.join();
+
+    ASSUME_ITS_EQUAL_I32(custom.load(), 1);
+    ASSUME_ITS_TRUE(ticks.load() > 0);
+#else
+    fossil::sys::EventQueue queue(64);
+    ASSUME_ITS_TRUE(queue.add_timer(10, 10, "tick") < 0);
+#endif
+}
+
+FOSSIL_TEST(cpp_test_event_timeouts)
+{
+#if defined(__linux__)
+    fossil::sys::EventQueue queue(1024);
+    std::vector<int> owners(200);
+    std::vector<fossil_sys_event_timeout_t> handles;
+    for (size_t i = 0; i < owners.size(); i++)
+        handles.push_back(queue.arm_timeout((uint32_t)(i % 20), "conn", &owners[i]));
+
+    // Cancel every other one; the rest fire exactly once
+    for (size_t i = 0; i < handles.size(); i += 2)
+        ASSUME_ITS_EQUAL_I32(queue.cancel_timeout(handles[i]), 0);
+
+    fossil_sys_event_t event;
+    int fired = 0;
+    while (fired < 100 && queue.wait(&event, 2000) == 1)
+    {
+        fossil_sys_event_source_info_t info;
+        memcpy(&info, event.payload, sizeof(info));
+        int *owner = static_cast<int *>(info.context);
+        ASSUME_ITS_TRUE((owner - owners.data()) % 2 == 1);
+        ASSUME_ITS_EQUAL_I32(++*owner, 1);
+        fired++;
+    }
+    ASSUME_ITS_EQUAL_I32(fired, 100);
+#else
+    fossil::sys::EventQueue queue(64);
+    ASSUME_ITS_TRUE(queue.arm_timeout(10, "t") == 0);
+#endif
+}
+
+FOSSIL_TEST(cpp_test_event_priority)
+{
+    fossil::sys::Event::init();
+
+    int value = 1;
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Event::post("data", &value, sizeof(value)), 0);
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Event::post("reload", nullptr, 0, FOSSIL_SYS_EVENT_POST_COPY,
+                                                  FOSSIL_SYS_EVENT_PRIORITY_HIGH), 0);
+
+    fossil_sys_event_t event;
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Event::poll(&event), 1);
+    ASSUME_ITS_EQUAL_CSTR(event.id, "reload");
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Event::poll(&event), 1);
+    ASSUME_ITS_EQUAL_CSTR(event.id, "data");
+    fossil::sys::Event::release(&event);
+
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Event::set_drain(FOSSIL_SYS_EVENT_DRAIN_WEIGHTED), 0);
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Event::set_drain(FOSSIL_SYS_EVENT_DRAIN_STRICT), 0);
+    fossil::sys::Event::shutdown();
+}
+
+FOSSIL_TEST(cpp_test_event_subscribe)
+{
+    fossil::sys::EventQueue queue(32);
+    uint32_t key = fossil::sys::Event::intern("cpp.tick");
+    ASSUME_ITS_TRUE(key != 0);
+    ASSUME_ITS_EQUAL_CSTR(fossil::sys::Event::name(key), "cpp.tick");
+
+    int sum = 0;
+    auto handler = [](const fossil_sys_event_t* event, void* context) {
+        *static_cast<int*>(context) += *static_cast<const int*>(event->payload);
+    };
+    int subscription = queue.subscribe("cpp.tick", handler, &sum);
+    ASSUME_ITS_TRUE(subscription > 0);
+
+    int value = 5;
+    ASSUME_ITS_EQUAL_I32(queue.post_key(key, &value, sizeof(value)), 0);
+    ASSUME_ITS_EQUAL_I32(queue.post("cpp.tick", &value, sizeof(value)), 0);
+    ASSUME_ITS_EQUAL_I32(queue.dispatch_pending(8), 2);
+    ASSUME_ITS_EQUAL_I32(sum, 10);
+
+    ASSUME_ITS_EQUAL_I32(queue.unsubscribe(subscription), 0);
+    ASSUME_ITS_EQUAL_I32(queue.post_key(key, &value, sizeof(value)), 0);
+    ASSUME_ITS_EQUAL_I32(queue.dispatch_pending(8), 1);
+    ASSUME_ITS_EQUAL_I32(sum, 10);
+}
+
+FOSSIL_TEST(cpp_test_event_dispatcher)
+{
+    fossil::sys::EventQueue queue(256);
+    fossil::sys::EventQueue done(4);
+    struct State {
+        std::atomic<int> handled{0};
+        fossil::sys::EventQueue* done;
+    } state;
+    state.done = &done;
+    auto handler = [](const fossil_sys_event_t*, void* context) {
+        State* state = static_cast<State*>(context);
+        if (state->handled.fetch_add(1) + 1 == 500)
+            state->done->post("done", nullptr, 0);
+    };
+    ASSUME_ITS_TRUE(queue.subscribe("cpp.work", handler, &state) > 0);
+
+    {
+        fossil::sys::EventDispatcher dispatcher(queue, 3);
+        ASSUME_ITS_TRUE(dispatcher.workers() == 3);
+        for (int i = 0; i < 500; i++)
+        {
+            while (queue.post("cpp.work", &i, sizeof(i)) != 0)
+                std::this_thread::yield();
+        }
+        fossil_sys_event_t event;
+        ASSUME_ITS_EQUAL_I32(done.wait(&event, 5000), 1);
+        fossil::sys::Event::release(&event);
+    }
+    ASSUME_ITS_EQUAL_I32(state.handled.load(), 500);
+}
+
+FOSSIL_TEST(cpp_test_event_stats)
+{
+    fossil::sys::Event::init();
+    fossil::sys::Event::reset_stats();
+    for (int i = 0; i < 128; i++)
+        ASSUME_ITS_EQUAL_I32(fossil::sys::Event::post("cpp.stat", &i, sizeof(i)), 0);
+    fossil_sys_event_t event;
+    while (fossil::sys::Event::poll(&event) == 1)
+        fossil::sys::Event::release(&event);
+
+    fossil_sys_event_stats_t stats = fossil::sys::Event::stats();
+    ASSUME_ITS_EQUAL_I32(stats.posted, 128);
+    ASSUME_ITS_EQUAL_I32(stats.delivered, 128);
+    ASSUME_ITS_EQUAL_I32(stats.high_water, 128);
+    ASSUME_ITS_EQUAL_I32(stats.latency_samples, 2);
+    ASSUME_ITS_TRUE(stats.latency_p50_ns <= stats.latency_max_ns);
+    fossil::sys::Event::shutdown();
+
+    fossil::sys::EventQueue queue(2);
+    queue.post("cpp.stat", nullptr, 0);
+    queue.post("cpp.stat", nullptr, 0);
+    ASSUME_ITS_TRUE(queue.post("cpp.stat", nullptr, 0) != 0);
+    ASSUME_ITS_EQUAL_I32(queue.stats().dropped, 1);
+    queue.reset_stats();
+    ASSUME_ITS_EQUAL_I32(queue.stats().dropped, 0);
+}
+
+FOSSIL_TEST(cpp_test_event_backpressure)
+{
+    // A blocking queue paces a fast producer to its consumer
+    fossil::sys::EventQueue queue(8, FOSSIL_SYS_EVENT_QUEUE_SPSC, FOSSIL_SYS_EVENT_FULL_BLOCK);
+    std::thread producer([&queue]() {
+        for (int i = 0; i < 1000; i++)
+            queue.post("cpp.bp", &i, sizeof(i));
+    });
+    int expected = 0;
+    fossil_sys_event_t event;
+    while (expected < 1000 && queue.wait(&event, 2000) == 1)
+    {
+        ASSUME_ITS_EQUAL_I32(*static_cast<int*>(event.payload), expected++);
+        fossil_sys_event_release(&event);
+    }
+    producer.join();
+    ASSUME_ITS_EQUAL_I32(expected, 1000);
+    ASSUME_ITS_EQUAL_I32(queue.stats().dropped, 0);
+
+    fossil::sys::EventQueue spill(2, FOSSIL_SYS_EVENT_QUEUE_MPMC, FOSSIL_SYS_EVENT_FULL_SPILL);
+    for (int i = 0; i < 5; i++)
+        ASSUME_ITS_EQUAL_I32(spill.post("cpp.bp", &i, sizeof(i)), 0);
+    ASSUME_ITS_EQUAL_I32(spill.stats().spilled, 3);
+}
+
+#ifdef FOSSIL_SYS_EVENT_COROUTINES
+// Fire-and-forget coroutine; the frame frees itself when the body ends.
+struct cpp_event_task {
+    struct promise_type {
+        cpp_event_task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+struct cpp_event_await_state {
+    std::atomic<int> sum{0};
+    std::atomic<int> status{-1};
+    std::atomic<bool> done{false};
+    std::thread::id resumed_on;
+};
+
+static cpp_event_task cpp_event_consumer(fossil::sys::EventQueue& queue, cpp_event_await_state& state)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        fossil::sys::OwnedEvent event = co_await queue.next();
+        if (event)
+            state.sum += *static_cast<const int*>(event->payload);
+    }
+    state.status = co_await queue.post_async("cpp.co.done", nullptr, 0);
+    state.resumed_on = std::this_thread::get_id();
+    state.done = true;
+}
+#endif
+
+FOSSIL_TEST(cpp_test_event_await)
+{
+    {
+        fossil::sys::EventQueue queue(8);
+        int value = 7;
+        fossil::sys::Event::intern("cpp.owned"); // keeps the payload inline
+        queue.post("cpp.owned", &value, sizeof(value), FOSSIL_SYS_EVENT_POST_INLINE);
+        fossil_sys_event_t event;
+        ASSUME_ITS_EQUAL_I32(queue.poll(&event), 1);
+        fossil::sys::OwnedEvent owned(event);
+        fossil::sys::OwnedEvent moved(std::move(owned));
+        ASSUME_ITS_FALSE(static_cast<bool>(owned));
+        ASSUME_ITS_TRUE(moved.get()->payload == moved.get()->inline_data);
+        ASSUME_ITS_EQUAL_I32(*static_cast<const int*>(moved->payload), 7);
+    }
+
+#ifdef FOSSIL_SYS_EVENT_COROUTINES
+    cpp_event_await_state state;
+    fossil::sys::EventQueue queue(64);
+    fossil::sys::EventDispatcher dispatcher(queue, 1);
+    cpp_event_consumer(queue, state); // suspends on its first next()
+    for (int i = 1; i <= 3; i++)
+        ASSUME_ITS_EQUAL_I32(queue.post("cpp.co", &i, sizeof(i)), 0);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!state.done && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::yield();
+    ASSUME_ITS_TRUE(state.done.load());
+    ASSUME_ITS_EQUAL_I32(state.sum.load(), 6);
+    ASSUME_ITS_EQUAL_I32(state.status.load(), 0);
+    ASSUME_ITS_TRUE(state.resumed_on != std::this_thread::get_id());
+#endif
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -124,6 +546,19 @@ FOSSIL_TEST_GROUP(cpp_event_tests)
     FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_post);
     FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_wait);
     FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_shutdown);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_mpmc);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_wait_blocking);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_queue_class);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_post_inline);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_batch);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_sources);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_timeouts);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_priority);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_subscribe);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_dispatcher);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_stats);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_backpressure);
+    FOSSIL_TEST_ADD(cpp_event_suite, cpp_test_event_await);
 
     FOSSIL_TEST_REGISTER(cpp_event_suite);
 }
@@ -25,6 +25,7 @@
 #include <fossil/pizza/framework.h>
 
 #include "fossil/sys/framework.h"
+#include <stddef.h>
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Utilities
@@ -252,6 +253,304 @@ FOSSIL_TEST(c_test_memory_strdup)
     fossil_sys_memory_free(dup);
 }
 
+FOSSIL_TEST(c_test_memory_arena)
+{
+    fossil_sys_memory_arena_t *arena = fossil_sys_memory_arena_create(256);
+    ASSUME_NOT_CNULL(arena);
+
+    char *a = (char *)fossil_sys_memory_arena_alloc(arena, 16);
+    ASSUME_NOT_CNULL(a);
+    memset(a, 0x11, 16);
+
+    void *aligned = fossil_sys_memory_arena_alloc_aligned(arena, 32, 64);
+    ASSUME_NOT_CNULL(aligned);
+    ASSUME_ITS_TRUE(((uintptr_t)aligned % 64) == 0);
+
+    fossil_sys_memory_arena_mark_t mark = fossil_sys_memory_arena_mark(arena);
+    void *big = fossil_sys_memory_arena_alloc(arena, 1024); // larger than a block
+    ASSUME_NOT_CNULL(big);
+    void *after = fossil_sys_memory_arena_alloc(arena, 8);
+    ASSUME_NOT_CNULL(after);
+
+    fossil_sys_memory_arena_rewind(arena, mark);
+    void *again = fossil_sys_memory_arena_alloc(arena, 1024);
+    ASSUME_ITS_TRUE(again == big); // rewind reuses the same space
+    ASSUME_ITS_TRUE(a[0] == 0x11 && a[15] == 0x11);
+
+    fossil_sys_memory_arena_reset(arena);
+    ASSUME_ITS_TRUE(fossil_sys_memory_arena_alloc(arena, 16) == (void *)a);
+
+    ASSUME_ITS_CNULL(fossil_sys_memory_arena_alloc_aligned(arena, 8, 3)); // bad alignment
+    fossil_sys_memory_arena_destroy(arena);
+}
+
+FOSSIL_TEST(c_test_memory_pool)
+{
+    typedef struct
+    {
+        uint32_t id;
+        double value;
+        char tag[12];
+    } record_t;
+
+    fossil_sys_memory_pool_t *pool = fossil_sys_memory_pool_create(sizeof(record_t), 16);
+    ASSUME_NOT_CNULL(pool);
+    ASSUME_ITS_TRUE(fossil_sys_memory_pool_object_size(pool) >= sizeof(record_t));
+
+    record_t *items[200]; // spans several slabs and magazine refills
+    for (size_t i = 0; i < 200; ++i)
+    {
+        items[i] = (record_t *)fossil_sys_memory_pool_alloc(pool);
+        ASSUME_NOT_CNULL(items[i]);
+        ASSUME_ITS_TRUE(((uintptr_t)items[i] % sizeof(void *)) == 0);
+        items[i]->id = (uint32_t)i;
+    }
+    for (size_t i = 0; i < 200; ++i)
+    {
+        ASSUME_ITS_TRUE(items[i]->id == (uint32_t)i); // no overlapping objects
+        fossil_sys_memory_pool_free(pool, items[i]);
+    }
+
+    void *recycled = fossil_sys_memory_pool_alloc(pool);
+    ASSUME_ITS_TRUE(recycled == (void *)items[199]); // LIFO reuse from the thread cache
+    fossil_sys_memory_pool_free(pool, recycled);
+
+    fossil_sys_memory_pool_destroy(pool);
+
+    // A 24-byte object can hold a 16-aligned member, so every slot must be
+    // aligned to 16 (or max_align_t where that is smaller).
+    size_t want = _Alignof(max_align_t) < 16 ? _Alignof(max_align_t) : 16;
+    pool = fossil_sys_memory_pool_create(24, 8);
+    ASSUME_NOT_CNULL(pool);
+    ASSUME_ITS_TRUE(fossil_sys_memory_pool_object_size(pool) % want == 0);
+    for (size_t i = 0; i < 20; ++i)
+    {
+        items[i] = (record_t *)fossil_sys_memory_pool_alloc(pool);
+        ASSUME_ITS_TRUE(((uintptr_t)items[i] % want) == 0);
+    }
+    for (size_t i = 0; i < 20; ++i)
+        fossil_sys_memory_pool_free(pool, items[i]);
+    fossil_sys_memory_pool_destroy(pool);
+
+    ASSUME_ITS_CNULL(fossil_sys_memory_pool_create(0, 0));
+}
+
+FOSSIL_TEST(c_test_memory_stats)
+{
+    fossil_sys_memory_stats_t before, during, after;
+    size_t live_allocs_before = 0, live_allocs_during = 0;
+
+    fossil_sys_memory_get_stats(&before);
+    fossil_sys_memory_stats(&live_allocs_before, NULL);
+
+    fossil_sys_memory_t ptr = fossil_sys_memory_alloc(100); // size class 3: (64, 128]
+    ASSUME_NOT_CNULL(ptr);
+    char *str = fossil_sys_memory_strdup("stats");
+    ASSUME_NOT_CNULL(str);
+
+    fossil_sys_memory_get_stats(&during);
+    fossil_sys_memory_stats(&live_allocs_during, NULL);
+    ASSUME_ITS_TRUE(during.alloc_count == before.alloc_count + 2);
+    ASSUME_ITS_TRUE(during.alloc_bytes == before.alloc_bytes + 106);
+    ASSUME_ITS_TRUE(during.size_classes[3] == before.size_classes[3] + 1);
+    ASSUME_ITS_TRUE(during.size_classes[0] == before.size_classes[0] + 1);
+    ASSUME_ITS_TRUE(live_allocs_during == live_allocs_before + 2);
+    ASSUME_ITS_TRUE(during.peak_bytes >= during.live_bytes);
+
+    fossil_sys_memory_free(str);
+    fossil_sys_memory_free(ptr);
+    fossil_sys_memory_get_stats(&after);
+    ASSUME_ITS_TRUE(after.free_count == before.free_count + 2);
+    ASSUME_ITS_TRUE(after.live_bytes == before.live_bytes);
+}
+
+FOSSIL_TEST(c_test_memory_alloc_aligned)
+{
+    fossil_sys_memory_t ptr = fossil_sys_memory_alloc_aligned(1000, 64);
+    ASSUME_NOT_CNULL(ptr);
+    ASSUME_ITS_TRUE(((uintptr_t)ptr % 64) == 0);
+    memset(ptr, 0xAB, 1000);
+    fossil_sys_memory_free_aligned(ptr);
+
+    ASSUME_ITS_CNULL(fossil_sys_memory_alloc_aligned(64, 48)); // not a power of two
+}
+
+FOSSIL_TEST(c_test_memory_alloc_huge)
+{
+    size_t size = 3 * 1024 * 1024;
+    uint8_t *ptr = (uint8_t *)fossil_sys_memory_alloc_huge(size);
+    ASSUME_NOT_CNULL(ptr);
+    ASSUME_ITS_TRUE(ptr[0] == 0 && ptr[size - 1] == 0); // fresh mappings are zero-filled
+    ptr[0] = 1;
+    ptr[size - 1] = 2;
+    fossil_sys_memory_free_huge(ptr, size);
+}
+
+FOSSIL_TEST(c_test_memory_simd_kernels)
+{
+    enum { N = 1037 }; // not a multiple of any vector width
+    uint8_t *a = (uint8_t *)fossil_sys_memory_alloc(N);
+    uint8_t *b = (uint8_t *)fossil_sys_memory_alloc(N);
+    ASSUME_NOT_CNULL(a);
+    ASSUME_NOT_CNULL(b);
+    ASSUME_NOT_CNULL(fossil_sys_memory_simd_level());
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        a[i] = (uint8_t)i;
+        b[i] = (uint8_t)(255 - (i & 0x7F));
+    }
+    fossil_sys_memory_swap(a, b, N);
+    ASSUME_ITS_TRUE(a[0] == 255 && a[N - 1] == (uint8_t)(255 - ((N - 1) & 0x7F)));
+    ASSUME_ITS_TRUE(b[700] == (uint8_t)700 && b[N - 1] == (uint8_t)(N - 1));
+
+    fossil_sys_memory_set(a, 0, N);
+    a[1000] = 0x7E;
+    ASSUME_ITS_TRUE(fossil_sys_memory_find(a, 0x7E, N) == &a[1000]);
+    ASSUME_ITS_CNULL(fossil_sys_memory_find(a, 0x7E, 1000));
+
+    fossil_sys_memory_copy(b, a, N);
+    ASSUME_ITS_TRUE(fossil_sys_memory_compare(a, b, N) == 0);
+    b[517] = 0x01;
+    ASSUME_ITS_TRUE(fossil_sys_memory_compare(a, b, N) < 0);
+    ASSUME_ITS_TRUE(fossil_sys_memory_compare(b, a, N) > 0);
+
+    uint32_t pattern = 0xA1B2C3D4;
+    fossil_sys_memory_fill(a, &pattern, sizeof(pattern), N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        ASSUME_ITS_TRUE(a[i] == ((const uint8_t *)&pattern)[i % sizeof(pattern)]);
+    }
+
+    fossil_sys_memory_free(a);
+    fossil_sys_memory_free(b);
+}
+
+FOSSIL_TEST(c_test_memory_fill_doubling)
+{
+    size_t size = 200003; // past the doubling cap, not a multiple of the pattern
+    uint8_t pattern[3] = {0x10, 0x20, 0x30};
+    uint8_t *ptr = (uint8_t *)fossil_sys_memory_alloc(size);
+    ASSUME_NOT_CNULL(ptr);
+
+    fossil_sys_memory_fill(ptr, pattern, sizeof(pattern), size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        ASSUME_ITS_TRUE(ptr[i] == pattern[i % sizeof(pattern)]);
+    }
+
+    uint8_t wide[32];
+    for (size_t i = 0; i < sizeof(wide); ++i)
+    {
+        wide[i] = (uint8_t)(i * 7);
+    }
+    fossil_sys_memory_fill(ptr + 1, wide, sizeof(wide), size - 1); // unaligned splat
+    for (size_t i = 0; i < size - 1; ++i)
+    {
+        ASSUME_ITS_TRUE(ptr[i + 1] == wide[i % sizeof(wide)]);
+    }
+    fossil_sys_memory_free(ptr);
+}
+
+FOSSIL_TEST(c_test_memory_secure_zero_large)
+{
+    size_t size = (1 << 20) + 13;
+    uint8_t *ptr = (uint8_t *)fossil_sys_memory_alloc(size);
+    ASSUME_NOT_CNULL(ptr);
+    fossil_sys_memory_set(ptr, 0xFF, size);
+    fossil_sys_memory_secure_zero(ptr + 3, size - 3);
+    ASSUME_ITS_TRUE(ptr[0] == 0xFF && ptr[2] == 0xFF);
+    ASSUME_ITS_CNULL(fossil_sys_memory_find(ptr + 3, 0xFF, size - 3));
+    fossil_sys_memory_free(ptr);
+}
+
+FOSSIL_TEST(c_test_memory_resize_ex)
+{
+    size_t size = 100;
+    uint8_t *ptr = (uint8_t *)fossil_sys_memory_alloc(size);
+    ASSUME_NOT_CNULL(ptr);
+    for (size_t i = 0; i < size; ++i)
+    {
+        ptr[i] = (uint8_t)i;
+    }
+
+    size_t capacity = 0;
+    bool moved = false;
+    uint8_t *before = ptr;
+    ptr = (uint8_t *)fossil_sys_memory_resize_ex(ptr, size, 101, FOSSIL_SYS_MEMORY_RESIZE_GEOMETRIC, &capacity, &moved);
+    ASSUME_NOT_CNULL(ptr);
+    ASSUME_ITS_TRUE(capacity >= 101);
+    ASSUME_ITS_TRUE(moved == (ptr != before));
+
+    size_t grown = 0;
+    ptr = (uint8_t *)fossil_sys_memory_resize_ex(ptr, capacity, capacity + 1, FOSSIL_SYS_MEMORY_RESIZE_GEOMETRIC, &grown, NULL);
+    ASSUME_NOT_CNULL(ptr);
+    ASSUME_ITS_TRUE(grown >= capacity + capacity / 2); // geometric growth
+    for (size_t i = 0; i < size; ++i)
+    {
+        ASSUME_ITS_TRUE(ptr[i] == (uint8_t)i); // contents preserved
+    }
+
+    fossil_sys_memory_free(ptr);
+}
+
+FOSSIL_TEST(c_test_memory_guard_mode)
+{
+    bool enabled = fossil_sys_memory_guard_enabled();
+    ASSUME_ITS_TRUE(fossil_sys_memory_guard_enabled() == enabled); // Fixed on first use
+
+    // Odd sizes land flush against the trailing guard; every byte must stay usable.
+    uint8_t *ptr = (uint8_t *)fossil_sys_memory_alloc(37);
+    ASSUME_NOT_CNULL(ptr);
+    memset(ptr, 0xAB, 37);
+    ptr = (uint8_t *)fossil_sys_memory_realloc(ptr, 4099);
+    ASSUME_NOT_CNULL(ptr);
+    ASSUME_ITS_TRUE(ptr[0] == 0xAB && ptr[36] == 0xAB);
+    ptr[4098] = 1;
+    fossil_sys_memory_free(ptr);
+
+    uint64_t *zeroed = (uint64_t *)fossil_sys_memory_calloc(3, sizeof(uint64_t));
+    ASSUME_NOT_CNULL(zeroed);
+    ASSUME_ITS_TRUE(((uintptr_t)zeroed % sizeof(uint64_t)) == 0);
+    ASSUME_ITS_TRUE(zeroed[0] == 0 && zeroed[2] == 0);
+    fossil_sys_memory_free(zeroed);
+
+    fossil_sys_memory_t aligned = fossil_sys_memory_alloc_aligned(100, 64);
+    ASSUME_NOT_CNULL(aligned);
+    ASSUME_ITS_TRUE(((uintptr_t)aligned % 64) == 0);
+    fossil_sys_memory_free_aligned(aligned);
+}
+
+FOSSIL_TEST(c_test_memory_profile)
+{
+    ASSUME_ITS_TRUE(fossil_sys_memory_profile_start(1) == 0); // Sample every allocation
+    void *kept = fossil_sys_memory_alloc(4096);
+    void *dropped = fossil_sys_memory_calloc(16, 16);
+    ASSUME_NOT_CNULL(kept);
+    ASSUME_NOT_CNULL(dropped);
+    fossil_sys_memory_free(dropped);
+#if !defined(__SANITIZE_ADDRESS__)
+    // ASan reports a failed allocation instead of returning NULL
+    ASSUME_ITS_CNULL(fossil_sys_memory_realloc(kept, SIZE_MAX / 2)); // Fails, so kept stays sampled
+#endif
+    fossil_sys_memory_profile_stop();
+
+    const char *path = "memory_profile.heap";
+    ASSUME_ITS_TRUE(fossil_sys_memory_profile_dump(path, FOSSIL_SYS_MEMORY_PROFILE_PPROF) == 0);
+    FILE *f = fopen(path, "r");
+    ASSUME_NOT_CNULL(f);
+    char line[256] = {0};
+    ASSUME_NOT_CNULL(fgets(line, sizeof(line), f));
+    fclose(f);
+    ASSUME_ITS_TRUE(strncmp(line, "heap profile: 1: 4096 [", 23) == 0); // Only the live block
+    ASSUME_ITS_TRUE(strstr(line, "@ heap_v2/1") != NULL);
+
+    ASSUME_ITS_TRUE(fossil_sys_memory_profile_dump(path, FOSSIL_SYS_MEMORY_PROFILE_FOLDED) == 0);
+    remove(path);
+    ASSUME_ITS_TRUE(fossil_sys_memory_profile_dump(NULL, FOSSIL_SYS_MEMORY_PROFILE_FOLDED) == -1);
+    fossil_sys_memory_free(kept);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -273,6 +572,17 @@ FOSSIL_TEST_GROUP(c_memory_tests)
     FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_swap);
     FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_find);
     FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_strdup);
+    FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_arena);
+    FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_pool);
+    FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_stats);
+    FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_alloc_aligned);
+    FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_alloc_huge);
+    FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_simd_kernels);
+    FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_fill_doubling);
+    FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_secure_zero_large);
+    FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_resize_ex);
+    FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_guard_mode);
+    FOSSIL_TEST_ADD(c_memory_suite, c_test_memory_profile);
 
     FOSSIL_TEST_REGISTER(c_memory_suite);
 }
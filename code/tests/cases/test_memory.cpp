@@ -25,6 +25,7 @@
 #include <fossil/pizza/framework.h>
 
 #include "fossil/sys/framework.h"
+#include <thread>
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Utilities
@@ -447,6 +448,134 @@ FOSSIL_TEST(cpp_test_memory_class_strdup)
     fossil::sys::Memory::free(dup); // Cleanup
 }
 
+FOSSIL_TEST(cpp_test_memory_class_arena)
+{
+    fossil::sys::Arena arena(256);
+    ASSUME_NOT_CNULL(arena.handle());
+
+    void *first = arena.alloc(32);
+    ASSUME_NOT_CNULL(first);
+
+    fossil_sys_memory_arena_mark_t mark = arena.mark();
+    void *aligned = arena.alloc_aligned(64, 64);
+    ASSUME_NOT_CNULL(aligned);
+    ASSUME_ITS_TRUE((reinterpret_cast<uintptr_t>(aligned) % 64) == 0);
+
+    arena.rewind(mark);
+    ASSUME_ITS_TRUE(arena.alloc_aligned(64, 64) == aligned);
+
+    fossil::sys::Arena moved(std::move(arena));
+    ASSUME_ITS_TRUE(arena.handle() == nullptr);
+    moved.reset();
+    ASSUME_ITS_TRUE(moved.alloc(32) == first);
+}
+
+FOSSIL_TEST(cpp_test_memory_class_pool)
+{
+    struct Payload
+    {
+        int a;
+        int b;
+        Payload(int x, int y) : a(x), b(y) {}
+    };
+
+    fossil::sys::Pool<Payload> pool(8);
+    ASSUME_NOT_CNULL(pool.handle());
+
+    Payload *objs[64];
+    for (int i = 0; i < 64; ++i)
+    {
+        objs[i] = pool.create(i, -i);
+        ASSUME_NOT_CNULL(objs[i]);
+    }
+
+    // Release half of the objects from another thread through the depot.
+    std::thread worker([&]() {
+        for (int i = 0; i < 32; ++i)
+        {
+            pool.destroy(objs[i]);
+        }
+    });
+    worker.join();
+
+    for (int i = 32; i < 64; ++i)
+    {
+        ASSUME_ITS_TRUE(objs[i]->a == i && objs[i]->b == -i);
+        pool.destroy(objs[i]);
+    }
+}
+
+FOSSIL_TEST(cpp_test_memory_class_stats)
+{
+    fossil_sys_memory_stats_t before = fossil::sys::Memory::get_stats();
+
+    fossil_sys_memory_t ptr = fossil::sys::Memory::calloc(4, 256);
+    ASSUME_NOT_CNULL(ptr);
+    ptr = fossil::sys::Memory::realloc(ptr, 4096);
+    ASSUME_NOT_CNULL(ptr);
+
+    fossil_sys_memory_stats_t during = fossil::sys::Memory::get_stats();
+    ASSUME_ITS_TRUE(during.alloc_count == before.alloc_count + 1);
+    ASSUME_ITS_TRUE(during.realloc_count == before.realloc_count + 1);
+
+    fossil::sys::Memory::free(ptr);
+    fossil_sys_memory_stats_t after = fossil::sys::Memory::get_stats();
+    ASSUME_ITS_TRUE(after.live_bytes == before.live_bytes);
+}
+
+FOSSIL_TEST(cpp_test_memory_class_alloc_aligned)
+{
+    fossil_sys_memory_t ptr = fossil::sys::Memory::alloc_aligned(256, 64);
+    ASSUME_NOT_CNULL(ptr);
+    ASSUME_ITS_TRUE((reinterpret_cast<uintptr_t>(ptr) % 64) == 0);
+    fossil::sys::Memory::free_aligned(ptr);
+
+    fossil_sys_memory_t huge = fossil::sys::Memory::alloc_huge(4096);
+    ASSUME_NOT_CNULL(huge);
+    fossil::sys::Memory::set(huge, 0x5A, 4096);
+    fossil::sys::Memory::free_huge(huge, 4096);
+}
+
+FOSSIL_TEST(cpp_test_memory_class_resize_ex)
+{
+    char *ptr = static_cast<char *>(fossil::sys::Memory::alloc(16));
+    ASSUME_NOT_CNULL(ptr);
+    memcpy(ptr, "fossil", 7);
+
+    size_t capacity = 0;
+    bool moved = false;
+    char *before = ptr;
+    ptr = static_cast<char *>(fossil::sys::Memory::resize_ex(ptr, 16, 4096, FOSSIL_SYS_MEMORY_RESIZE_EXACT, &capacity, &moved));
+    ASSUME_NOT_CNULL(ptr);
+    ASSUME_ITS_TRUE(capacity >= 4096);
+    ASSUME_ITS_TRUE(moved == (ptr != before));
+    ASSUME_ITS_TRUE(strcmp(ptr, "fossil") == 0);
+    fossil::sys::Memory::free(ptr);
+}
+
+FOSSIL_TEST(cpp_test_memory_class_guard_mode)
+{
+    ASSUME_ITS_TRUE(fossil::sys::Memory::guard_enabled() == fossil_sys_memory_guard_enabled());
+
+    char *str = fossil::sys::Memory::strdup("guarded");
+    ASSUME_NOT_CNULL(str);
+    ASSUME_ITS_TRUE(strcmp(str, "guarded") == 0);
+    fossil::sys::Memory::free(str);
+}
+
+FOSSIL_TEST(cpp_test_memory_class_profile)
+{
+    ASSUME_ITS_TRUE(fossil::sys::Memory::profile_start(1) == 0);
+    char *str = fossil::sys::Memory::strdup("sampled");
+    ASSUME_NOT_CNULL(str);
+    fossil::sys::Memory::profile_stop();
+
+    const char *path = "memory_profile.folded";
+    ASSUME_ITS_TRUE(fossil::sys::Memory::profile_dump(path, FOSSIL_SYS_MEMORY_PROFILE_FOLDED) == 0);
+    remove(path);
+    fossil::sys::Memory::free(str);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -480,6 +609,13 @@ FOSSIL_TEST_GROUP(cpp_memory_tests)
     FOSSIL_TEST_ADD(cpp_memory_suite, cpp_test_memory_class_swap);
     FOSSIL_TEST_ADD(cpp_memory_suite, cpp_test_memory_class_find);
     FOSSIL_TEST_ADD(cpp_memory_suite, cpp_test_memory_class_strdup);
+    FOSSIL_TEST_ADD(cpp_memory_suite, cpp_test_memory_class_arena);
+    FOSSIL_TEST_ADD(cpp_memory_suite, cpp_test_memory_class_pool);
+    FOSSIL_TEST_ADD(cpp_memory_suite, cpp_test_memory_class_stats);
+    FOSSIL_TEST_ADD(cpp_memory_suite, cpp_test_memory_class_alloc_aligned);
+    FOSSIL_TEST_ADD(cpp_memory_suite, cpp_test_memory_class_resize_ex);
+    FOSSIL_TEST_ADD(cpp_memory_suite, cpp_test_memory_class_guard_mode);
+    FOSSIL_TEST_ADD(cpp_memory_suite, cpp_test_memory_class_profile);
 
     FOSSIL_TEST_REGISTER(cpp_memory_suite);
 }
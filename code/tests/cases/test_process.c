@@ -14,6 +14,8 @@
 #include <fossil/pizza/framework.h>
 
 #include "fossil/sys/framework.h"
+#include <stdlib.h>
+#include <time.h>
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Utilities
@@ -134,6 +136,64 @@ FOSSIL_TEST(c_test_process_terminate_self)
     ASSUME_NOT_EQUAL_I32(status, 0);
 }
 
+// ** Test fossil_sys_process_get_ppid against get_info and get_name **
+FOSSIL_TEST(c_test_process_get_ppid)
+{
+    uint32_t pid = fossil_sys_process_get_pid();
+    fossil_sys_process_info_t info;
+    char name[8] = {0};
+    ASSUME_ITS_EQUAL_I32(fossil_sys_process_get_info(pid, &info), 0);
+#if defined(__linux__)
+    ASSUME_ITS_TRUE(fossil_sys_process_get_ppid(pid) > 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_process_get_ppid(pid), (int)info.ppid);
+    // A short buffer gets a truncated, terminated name
+    ASSUME_ITS_EQUAL_I32(fossil_sys_process_get_name(pid, name, sizeof(name)), 0);
+    ASSUME_ITS_TRUE(strncmp(name, info.name, sizeof(name) - 1) == 0);
+    ASSUME_ITS_TRUE(strlen(name) < sizeof(name));
+#endif
+    ASSUME_ITS_TRUE(fossil_sys_process_get_ppid(0xFFFFFFF0u) < 0);
+}
+
+// ** Test the CPU usage sampler **
+FOSSIL_TEST(c_test_process_sampler)
+{
+    fossil_sys_process_sampler_t *sampler = fossil_sys_process_sampler_create(0);
+    ASSUME_NOT_CNULL(sampler);
+    uint32_t pid = fossil_sys_process_get_pid();
+    fossil_sys_process_info_t info;
+
+    int status = fossil_sys_process_sampler_get_info(sampler, pid, &info);
+    ASSUME_ITS_TRUE(status == 0 || status == -2);
+    if (status == 0)
+    {
+        ASSUME_ITS_TRUE(info.cpu_percent == 0.0f); // first sample has no baseline
+
+        // Spin for a few hundred milliseconds of CPU time
+        clock_t begin = clock();
+        volatile uint64_t spin = 0;
+        while ((double)(clock() - begin) / CLOCKS_PER_SEC < 0.3)
+            spin++;
+
+        ASSUME_ITS_EQUAL_I32(fossil_sys_process_sampler_get_info(sampler, pid, &info), 0);
+        ASSUME_ITS_EQUAL_I32(info.pid, pid);
+        ASSUME_ITS_TRUE(info.cpu_percent > 1.0f);
+
+        fossil_sys_process_list_t *plist = (fossil_sys_process_list_t *)malloc(sizeof(*plist));
+        ASSUME_NOT_CNULL(plist);
+        ASSUME_ITS_EQUAL_I32(fossil_sys_process_sampler_refresh(sampler, plist), 0);
+        ASSUME_ITS_TRUE(plist->count > 0);
+        for (size_t i = 0; i < plist->count; ++i)
+            ASSUME_ITS_TRUE(plist->list[i].cpu_percent >= 0.0f);
+        ASSUME_ITS_EQUAL_I32(fossil_sys_process_sampler_refresh(sampler, NULL), 0);
+        free(plist);
+    }
+
+    ASSUME_ITS_TRUE(fossil_sys_process_sampler_get_info(sampler, 0xFFFFFFF0u, &info) < 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_process_sampler_get_info(NULL, pid, &info), -1);
+    fossil_sys_process_sampler_destroy(sampler);
+    fossil_sys_process_sampler_destroy(NULL);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -145,6 +205,8 @@ FOSSIL_TEST_GROUP(c_process_tests)
     FOSSIL_TEST_ADD(c_process_suite, c_test_process_list);
     FOSSIL_TEST_ADD(c_process_suite, c_test_process_get_environment);
     FOSSIL_TEST_ADD(c_process_suite, c_test_process_terminate_self);
+    FOSSIL_TEST_ADD(c_process_suite, c_test_process_get_ppid);
+    FOSSIL_TEST_ADD(c_process_suite, c_test_process_sampler);
 
     FOSSIL_TEST_REGISTER(c_process_suite);
 }
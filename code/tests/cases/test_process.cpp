@@ -14,6 +14,9 @@
 #include <fossil/pizza/framework.h>
 
 #include "fossil/sys/framework.h"
+#include <chrono>
+#include <memory>
+#include <utility>
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Utilities
@@ -137,6 +140,47 @@ FOSSIL_TEST(cpp_test_process_terminate_self)
     ASSUME_NOT_EQUAL_I32(status, 0);
 }
 
+// ** Test Process::get_ppid against get_info **
+FOSSIL_TEST(cpp_test_process_get_ppid)
+{
+    uint32_t pid = fossil::sys::Process::get_pid();
+    fossil_sys_process_info_t info{};
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Process::get_info(pid, info), 0);
+#if defined(__linux__)
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Process::get_ppid(pid), (int)info.ppid);
+    ASSUME_ITS_TRUE(info.thread_count >= 1);
+    ASSUME_ITS_TRUE(info.memory_bytes <= info.virtual_memory_bytes);
+#endif
+}
+
+// ** Test Process::Sampler **
+FOSSIL_TEST(cpp_test_process_sampler)
+{
+    fossil::sys::Process::Sampler sampler(512);
+    ASSUME_ITS_TRUE(sampler.handle() != nullptr);
+    uint32_t pid = fossil::sys::Process::get_pid();
+    fossil_sys_process_info_t info{};
+
+    if (sampler.get_info(pid, info) == 0)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        volatile uint64_t spin = 0;
+        while (std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(300))
+            spin = spin + 1;
+
+        ASSUME_ITS_EQUAL_I32(sampler.get_info(pid, info), 0);
+        ASSUME_ITS_TRUE(info.cpu_percent > 1.0f);
+
+        auto plist = std::make_unique<fossil_sys_process_list_t>();
+        ASSUME_ITS_EQUAL_I32(sampler.refresh(*plist), 0);
+        ASSUME_ITS_TRUE(plist->count > 0);
+    }
+
+    fossil::sys::Process::Sampler moved(std::move(sampler));
+    ASSUME_ITS_TRUE(sampler.handle() == nullptr);
+    ASSUME_ITS_TRUE(moved.handle() != nullptr);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -148,6 +192,8 @@ FOSSIL_TEST_GROUP(cpp_process_tests)
     FOSSIL_TEST_ADD(cpp_process_suite, cpp_test_process_list);
     FOSSIL_TEST_ADD(cpp_process_suite, cpp_test_process_get_environment);
     FOSSIL_TEST_ADD(cpp_process_suite, cpp_test_process_terminate_self);
+    FOSSIL_TEST_ADD(cpp_process_suite, cpp_test_process_get_ppid);
+    FOSSIL_TEST_ADD(cpp_process_suite, cpp_test_process_sampler);
 
     FOSSIL_TEST_REGISTER(cpp_process_suite);
 }